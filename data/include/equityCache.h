@@ -0,0 +1,165 @@
+
+#ifndef _EQUITYCACHE_H_
+#define _EQUITYCACHE_H_
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "yahooTS.h"
+#include "mapfile.h"
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+/**
+  A binary, column oriented cache of a set of Yahoo equity files.
+
+  The text files are parsed once (see yahooCSV) and written to a
+  single cache file by build.  After that, open maps the cache
+  into memory (see mapfile) and the columns are returned as
+  pointers into the mapped file.  There is no parsing and no
+  copying, so a column can be passed directly to the wavelet
+  transforms.
+
+  The cache file is
+
+  <pre>
+     4 bytes   the characters 'K', 'P', 'E', 'Q'
+     4 bytes   version (1)
+     4 bytes   the number of symbols
+     4 bytes   byte order mark (0x01020304 in the writer's byte order)
+     8 bytes   the length of the file, in bytes
+     40 bytes  reserved (zero)
+     ...       the directory: 64 bytes for each symbol
+     ...       the columns
+  </pre>
+
+  Each directory entry holds the symbol name (at most 31
+  characters, padded with zeros to 32 bytes), the number of lines
+  N (8 bytes), the offset of the symbol's columns from the start of
+  the file (8 bytes) and 16 reserved bytes.  The columns of a
+  symbol are, in order, the dates (N 32-bit ints, days since 1
+  January 1970), the Open, High, Low, Close and Volume prices (N
+  doubles each) and the volume (N 64-bit integers).  The oldest line
+  is first.  Each column starts on a 64 byte boundary, so the
+  columns are aligned for vector loads.
+
+  The numbers are stored in the byte order of the machine that
+  built the cache.  A cache built on a machine with a different
+  byte order is rejected by open (it is cheaper to build the cache
+  again than to swap it).
+
+  The cache is not updated when the text files change.  Delete the
+  cache file to rebuild it.
+
+  Errors (a text file that cannot be loaded, a cache that cannot be
+  written, a cache file that is not valid) are reported on stderr
+  and build or open return false.
+ */
+class equityCache
+{
+public:
+  /** the length of the symbol name field, the alignment of the
+      columns and the size of the header and of a directory entry */
+  typedef enum { nameLen = 32,
+                 colAlign = 64,
+                 headerBytes = 64,
+                 entryBytes = 64 } bogus;
+
+private:
+  /** disallow the copy constructor */
+  equityCache( const equityCache &rhs ) {}
+
+  /** the file header */
+  typedef struct {
+    char magic[4];
+    unsigned int version;
+    unsigned int numSymbols;
+    unsigned int byteOrder;
+    long long fileLen;
+    char reserved[40];
+  } header;
+
+  /** a directory entry */
+  typedef struct {
+    char name[ nameLen ];
+    long long N;
+    long long offset;
+    char reserved[16];
+  } entry;
+
+  /** the mapped cache file */
+  mapfile file;
+  /** the directory in the mapped file (0 if no cache is open) */
+  const entry *dir;
+  /** the number of symbols */
+  size_t numSyms;
+
+  static size_t alignUp( const size_t n )
+  {
+    return ((n + (colAlign-1))/colAlign) * colAlign;
+  }
+  static size_t dateBytes( const size_t N ) { return alignUp( N * sizeof( int ) ); }
+  static size_t colBytes( const size_t N ) { return alignUp( N * sizeof( double ) ); }
+  static size_t symbolBytes( const size_t N );
+  static bool pad( FILE *fp, const size_t n );
+
+  const unsigned char *columns( const size_t sym ) const;
+
+public:
+  equityCache();
+  ~equityCache();
+
+  static bool build( const char *cachePath,
+                     const char *dataDir,
+                     const char **symbols );
+
+  bool open( const char *path );
+  void close();
+
+  /** the number of symbols in the cache */
+  size_t numSymbols() const { return numSyms; }
+
+  const char *symbol( const size_t sym ) const;
+  int find( const char *name ) const;
+  size_t length( const size_t sym ) const;
+  const int *date( const size_t sym ) const;
+  const double *column( const size_t sym, const yahooTS::dataKind kind ) const;
+  const long long *volume( const size_t sym ) const;
+
+  const double *getTS( const char *name,
+                       size_t &N,
+                       const yahooTS::dataKind kind ) const;
+}; // equityCache
+
+#endif
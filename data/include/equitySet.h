@@ -0,0 +1,155 @@
+
+#ifndef _EQUITYSET_H_
+#define _EQUITYSET_H_
+
+#include <stddef.h>
+
+#include "yahooTS.h"
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+class yahooCSV;
+
+/**
+  Load all of the Yahoo equity files in a directory and align them
+  by date.
+
+  list finds the files in the directory (every regular file whose
+  name does not start with a dot), sorted by name.  load parses the
+  files (see yahooCSV) on a group of threads (see taskpool), one
+  file per task, so the time to load a large number of files is
+  limited by the disk rather than by one processor.
+
+  The result is a matrix with a row for each symbol and a column
+  for each date on which any of the symbols traded (the union of
+  the dates, oldest first).  The matrix is stored by row: each row
+  is a contiguous series that can be passed directly to a wavelet
+  transform, and row <i>i</i>+1 follows row <i>i</i>.  A symbol
+  that did not trade on a date gets the value from its previous
+  trading day.  Dates before the first trading day of a symbol get
+  the value from the first trading day (see first).
+
+  A file that cannot be loaded is reported on stderr and left out
+  of the set.  load returns false if no files were loaded.
+ */
+class equitySet
+{
+private:
+  /** disallow the copy constructor */
+  equitySet( const equitySet &rhs ) {}
+
+  /** the symbol (file) names, sorted, followed by a null pointer */
+  char **names_;
+  /** number of symbols */
+  size_t numSyms;
+  /** the union of the dates, oldest first, in days since 1 January 1970 */
+  int *dates_;
+  /** number of dates */
+  size_t numDates_;
+  /** numSyms rows of numDates_ values */
+  double *matrix_;
+  /** index of the first trading day of each symbol */
+  size_t *first_;
+  /** bytes parsed and elapsed seconds for the last load */
+  size_t bytes_;
+  double seconds_;
+
+  static int compareNames( const void *a, const void *b );
+  static int compareDates( const void *a, const void *b );
+  static void loadTask( void *arg, const size_t task );
+
+  void addName( const char *name, size_t &maxNames );
+  void align( const yahooCSV *csv,
+              const size_t *ix,
+              const yahooTS::dataKind kind );
+
+public:
+  equitySet();
+  ~equitySet();
+
+  size_t list( const char *dataDir );
+
+  bool load( const char *dataDir,
+             const yahooTS::dataKind kind,
+             const size_t numThreads = 0 );
+
+  void clear();
+
+  /** number of symbols */
+  size_t numSymbols() const { return numSyms; }
+
+  /** the name of symbol <i>sym</i> */
+  const char *symbol( const size_t sym ) const
+  {
+    return (sym < numSyms) ? names_[sym] : 0;
+  }
+
+  /** the symbol names, followed by a null pointer (see equityCache::build) */
+  const char **symbols() const { return (const char **)names_; }
+
+  /** number of dates (the length of each row) */
+  size_t numDates() const { return numDates_; }
+
+  /** the dates, oldest first, in days since 1 January 1970 */
+  const int *dates() const { return dates_; }
+
+  /** the matrix, numSymbols() rows of numDates() values */
+  const double *matrix() const { return matrix_; }
+
+  /** the row for symbol <i>sym</i> */
+  const double *row( const size_t sym ) const
+  {
+    return (sym < numSyms && matrix_ != 0) ? matrix_ + (sym * numDates_) : 0;
+  }
+
+  /** the index of the first trading day of symbol <i>sym</i> */
+  size_t first( const size_t sym ) const
+  {
+    return (sym < numSyms && first_ != 0) ? first_[sym] : 0;
+  }
+
+  /** number of bytes parsed by the last load */
+  size_t bytes() const { return bytes_; }
+
+  /** elapsed (wall clock) seconds used by the last load */
+  double seconds() const { return seconds_; }
+
+  /** throughput of the last load, in megabytes per second */
+  double mbPerSec() const
+  {
+    return (seconds_ > 0) ? ((double)bytes_ / (1024.0 * 1024.0)) / seconds_ : 0.0;
+  }
+}; // equitySet
+
+#endif
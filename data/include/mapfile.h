@@ -0,0 +1,85 @@
+
+#ifndef _MAPFILE_H_
+#define _MAPFILE_H_
+
+#include <stddef.h>
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+/**
+  A read only view of a file that is mapped into memory (mmap on
+  POSIX systems, a file mapping object on Windows).
+
+  The equity data loader (yahooCSV) reads the file through the
+  mapped view, so the file is never copied into a buffer and the
+  operating system reads the pages as they are touched.  The binary
+  equity cache (equityCache) returns pointers into the mapped view.
+  The view is unmapped by close or the destructor.
+
+  Errors (a file that does not exist, an empty file, a file that
+  cannot be mapped) are reported on stderr and open returns false.
+ */
+class mapfile
+{
+private:
+  /** disallow the copy constructor */
+  mapfile( const mapfile &rhs ) {}
+
+  /** the start of the mapped file */
+  const unsigned char *base;
+  /** the length of the file */
+  size_t fileLen;
+#if defined(_WIN32)
+  /** the file and mapping handles */
+  void *fileHandle;
+  void *mapHandle;
+#else
+  /** the file descriptor */
+  int fd;
+#endif
+
+public:
+  mapfile();
+  ~mapfile();
+
+  bool open( const char *path );
+  void close();
+
+  /** the start of the file (0 if no file is open) */
+  const unsigned char *data() const { return base; }
+  /** the length of the file, in bytes */
+  size_t length() const { return fileLen; }
+}; // mapfile
+
+#endif
@@ -0,0 +1,205 @@
+
+#ifndef _OHLCV_H_
+#define _OHLCV_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "liftbase.h"
+#include "packtree.h"
+#include "packbasis.h"
+#include "packcontainer.h"
+#include "yahooTS.h"
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+
+class equityCache;
+
+/**
+  The Open, High, Low, Close and Volume columns of an equity, loaded
+  together and transformed with one call.
+
+  yahooTS::getTS returns one column at a time, so extracting
+  features from all of the columns of a bar means parsing the file
+  (and calling the transform) five times.  An ohlcv object is loaded
+  from a Yahoo file (see yahooCSV) or from the binary cache (see
+  equityCache) in one pass.  The four price columns are stored one
+  after the other in a single block of memory (Open first).  The
+  volume is stored as 64-bit integers, since the volume of a heavily
+  traded equity can overflow an int and rounding it to a double
+  loses the lossless integer path.
+
+  forwardTrans and inverseTrans apply an ordered wavelet transform
+  (a liftbase object for double *) to the four price columns and an
+  integer wavelet (a liftbase object for int64_t *, e.g.,
+  line_int<int64_t *, int64_t>) to the volume.  The price columns
+  are transformed together: they are interleaved, so each step of
+  the wavelet's column kernels (liftbase::forwardSpanCols) steps the
+  four columns at once and the boundary elements of the four columns
+  are calculated once per level.  A wavelet without column kernels
+  transforms the columns one at a time.  packetTrans builds
+  the wavelet packet tree and best basis of each column: the price
+  columns with a double packet tree and the volume with an int64_t
+  packet tree, with the cost functions given as template arguments.
+
+  The transforms work in place on the columns, so the data is a
+  copy of the last N lines of the file.  N must be a power of two.
+
+  Errors (a file that cannot be loaded, a file with fewer than N
+  lines) are reported on stderr and load returns false.
+ */
+class ohlcv
+{
+public:
+  /** the number of price columns (Open, High, Low, Close) */
+  typedef enum { numPrices = 4 } bogus;
+
+private:
+  /** disallow the copy constructor */
+  ohlcv( const ohlcv &rhs ) {}
+
+  /** number of lines of data */
+  size_t N_;
+  /** date of each line, in days since 1 January 1970 */
+  int *date_;
+  /** the price columns, numPrices columns of N_ values */
+  double *prices_;
+  /** the volume */
+  int64_t *volume_;
+
+  void alloc( const size_t N );
+  bool fill( const int *date,
+             const double *cols[],
+             const long long *volume,
+             const size_t total,
+             const size_t N );
+  void priceTrans( liftbase<double *, double> &w, const bool isForward );
+
+public:
+  ohlcv();
+  ~ohlcv();
+
+  bool load( const char *path, const size_t N );
+  bool load( const equityCache &cache, const char *name, const size_t N );
+  void clear();
+
+  /** number of lines of data */
+  size_t length() const { return N_; }
+
+  /** the dates, in days since 1 January 1970 */
+  const int *date() const { return date_; }
+
+  /** the four price columns, one after the other */
+  double *prices() { return prices_; }
+
+  /**
+    The price column for <i>kind</i> (Open, High, Low or Close), or
+    0 if kind is not a price.
+   */
+  double *price( const yahooTS::dataKind kind )
+  {
+    return (kind >= yahooTS::Open && kind <= yahooTS::Close && prices_ != 0) ? 
+      prices_ + ((kind - yahooTS::Open) * N_) : 0;
+  }
+
+  /** the volume column */
+  int64_t *volume() { return volume_; }
+
+  /**
+    Apply the forward wavelet transform <i>w</i> to the price
+    columns and <i>wVol</i> to the volume.
+   */
+  void forwardTrans( liftbase<double *, double> &w,
+                     liftbase<int64_t *, int64_t> &wVol )
+  {
+    priceTrans( w, true );
+    wVol.forwardTrans( volume_, (int)N_ );
+  } // forwardTrans
+
+  /**
+    Apply the inverse wavelet transform <i>w</i> to the price
+    columns and <i>wVol</i> to the volume.
+   */
+  void inverseTrans( liftbase<double *, double> &w,
+                     liftbase<int64_t *, int64_t> &wVol )
+  {
+    priceTrans( w, false );
+    wVol.inverseTrans( volume_, (int)N_ );
+  } // inverseTrans
+
+  /**
+    Build the wavelet packet tree of each column, calculate the cost
+    of the nodes (with the cost function <i>C</i> for the prices and
+    <i>C_vol</i> for the volume, e.g., costshannon and costwidth64)
+    and return the best basis of each price column in
+    <i>basis</i>[0..3] (Open first) and of the volume in
+    <i>volBasis</i>.  The columns are not changed.  The best basis
+    descriptors are allocated from the memory pool.  Returns false if
+    a best basis could not be calculated (for example, if the memory
+    for a tree could not be allocated).
+   */
+  template <class C, class C_vol>
+  bool packetTrans( liftbase<packcontainer, double> *w,
+                    liftbase<basic_packcontainer<int64_t>, int64_t> *wVol,
+                    packbasis<double> basis[],
+                    packbasis<int64_t> &volBasis )
+  {
+    bool ok = (N_ > 0);
+    for (size_t c = 0; ok && c < numPrices; c++) {
+      packtree tree( prices_ + (c * N_), N_, w, packtree_base::BorrowInput );
+      ok = tree.ok();
+      if (ok) {
+        C cost( tree.getRoot() );
+        tree.bestBasis();
+        basis[c] = tree.getBestBasis();
+        ok = tree.bestBasisOK() && basis[c].ok();
+      }
+    }
+    if (ok) {
+      basic_packtree<int64_t> volTree( volume_, N_, wVol, packtree_base::BorrowInput );
+      ok = volTree.ok();
+      if (ok) {
+        C_vol volCost( volTree.getRoot() );
+        volTree.bestBasis();
+        volBasis = volTree.getBestBasis();
+        ok = volTree.bestBasisOK() && volBasis.ok();
+      }
+    }
+    return ok;
+  } // packetTrans
+
+}; // ohlcv
+
+#endif
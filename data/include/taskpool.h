@@ -0,0 +1,86 @@
+
+#ifndef _TASKPOOL_H_
+#define _TASKPOOL_H_
+
+#include <stddef.h>
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+/**
+  Run a set of independent tasks on a group of worker threads.
+
+  The tasks are numbered 0 to <i>numTasks</i>-1.  Each worker takes
+  the next task number from a shared counter (with an atomic
+  increment), so a thread that finishes a short task goes on to the
+  next one and the work stays balanced when the tasks take
+  different amounts of time (e.g., loading files of different
+  sizes).  The threads are created with pthreads on POSIX systems
+  and with _beginthreadex on Windows.
+
+  The task function is called with the argument that was passed to
+  run and the task number.  The function must not write data that
+  is shared with the other tasks, except through its own task
+  number (e.g., element <i>i</i> of an array).  The memory pool
+  (block_pool) is not thread safe, so tasks should not allocate
+  from it.
+
+  The calling thread is one of the workers.  If a thread cannot be
+  created, the tasks are run by the threads that were started.
+
+  All of the functions are static.  The constructor and destructor
+  are declared but not defined, as in the <tt>support</tt> class.
+ */
+class taskpool
+{
+public:
+  /** a task: <i>arg</i> is the argument passed to run, <i>task</i>
+      is the task number */
+  typedef void (*taskFunc)( void *arg, const size_t task );
+
+  /** declare but do not define the constructor */
+  taskpool();
+  /** declare but do not define the destructor */
+  ~taskpool();
+
+  static size_t numProcessors();
+
+  static void run( taskFunc func,
+                   void *arg,
+                   const size_t numTasks,
+                   const size_t numThreads = 0 );
+
+  static double wallSeconds();
+}; // taskpool
+
+#endif
@@ -0,0 +1,163 @@
+
+#ifndef _YAHOOCSV_H_
+#define _YAHOOCSV_H_
+
+#include <stddef.h>
+
+#include "yahooTS.h"
+#include "mapfile.h"
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+/**
+  Load all of the columns of a Yahoo historical data file (see
+  yahooTS) in one pass.
+
+  The file is mapped into memory (see mapfile) and scanned once.
+  The field separators (commas and newlines) are found sixteen bytes
+  at a time with SSE2 compares when the code is compiled for a
+  processor that has them (__SSE2__ or _M_X64), and one byte at a
+  time otherwise.  Each field is parsed in place, without copying it
+  into a buffer:
+
+  <ul>
+  <li>
+  The date is converted to the number of days since 1 January
+  1970.  Both the original Yahoo format (2-Aug-02, where a two digit
+  year less than 50 is in the 2000s) and the ISO format
+  (2002-08-02) are recognized.
+  </li>
+  <li>
+  Prices are parsed by collecting the digits into a 64-bit integer
+  and dividing by a power of ten.  Since both values are exact
+  doubles the result is correctly rounded, the same value as
+  strtod.  Numbers with an exponent or more than 15 significant
+  digits are passed to strtod.
+  </li>
+  <li>
+  The volume is parsed as a 64-bit integer.  It is also available
+  as a double column.
+  </li>
+  </ul>
+
+  The result is stored by column, with the oldest line first (Yahoo
+  files list the most recent line first; files in date order are
+  not reversed).  Each column is a contiguous array that can be
+  passed directly to the wavelet transforms.
+
+  The time needed to load the file and the number of bytes scanned
+  are recorded, so the loader's throughput can be reported in
+  megabytes per second.
+
+  Errors (a file that cannot be read, a line without six fields, a
+  bad number or date) are reported on stderr with the line number
+  and load returns false.
+ */
+class yahooCSV
+{
+public:
+  /** the number of value columns (Open, High, Low, Close, Volume) */
+  typedef enum { numCols = 5 } bogus;
+
+private:
+  /** disallow the copy constructor */
+  yahooCSV( const yahooCSV &rhs ) {}
+
+  /** number of lines of data */
+  size_t N_;
+  /** date of each line, in days since 1 January 1970 */
+  int *date_;
+  /** the Open, High, Low, Close and Volume columns */
+  double *cols_[ numCols ];
+  /** the volume as an integer */
+  long long *volume_;
+  /** bytes scanned and seconds used by the last load */
+  size_t bytes_;
+  double seconds_;
+
+  void alloc( const size_t maxLines );
+  bool parse( const char *buf, const size_t len, const char *path );
+  bool separator( const char *buf,
+                  const size_t len,
+                  const size_t sep,
+                  size_t &start,
+                  size_t &field,
+                  size_t &lineNum,
+                  const char *path );
+  void reverse();
+
+public:
+  yahooCSV();
+  ~yahooCSV();
+
+  bool load( const char *path );
+  void clear();
+
+  static bool parseDate( const char *s, const char *end, int &days );
+  static bool parseDouble( const char *s, const char *end, double &v );
+  static bool parseInt( const char *s, const char *end, long long &v );
+  static int civilDays( const int year, const int month, const int day );
+
+  /** number of lines of data */
+  size_t length() const { return N_; }
+
+  /** the dates, in days since 1 January 1970 */
+  const int *date() const { return date_; }
+
+  /**
+    The column for <i>kind</i> (Open, High, Low, Close or Volume), or
+    0 if kind is not a column.
+   */
+  const double *column( const yahooTS::dataKind kind ) const
+  {
+    return (kind > yahooTS::badEnum && kind < yahooTS::lastEnum) ? cols_[ kind - 1 ] : 0;
+  }
+
+  /** the volume column as 64-bit integers */
+  const long long *volume() const { return volume_; }
+
+  /** number of bytes scanned by the last load */
+  size_t bytes() const { return bytes_; }
+
+  /** seconds used by the last load */
+  double seconds() const { return seconds_; }
+
+  /** throughput of the last load, in megabytes per second */
+  double mbPerSec() const
+  {
+    return (seconds_ > 0) ? ((double)bytes_ / (1024.0 * 1024.0)) / seconds_ : 0.0;
+  }
+}; // yahooCSV
+
+#endif
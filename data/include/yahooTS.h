@@ -71,9 +71,10 @@
   The title line consists of six comma separated strings
   (e.g., "Date,Open,High,Low,Close,Volume").  Time time
   series lines have the values suggested in the title.
-  For my current purposes I am not interested in date values,
-  so these are ignored.  All values are returned as vectors
-  of doubles, although volume is an unsigned integer value.
+  getTS returns one column as a vector of doubles (volume, which
+  is an unsigned integer value, is also returned as doubles).  The
+  yahooCSV class loads all of the columns, the dates (as day numbers)
+  and an integer volume column in one pass over the file.
 
  */
 class yahooTS
@@ -105,18 +106,6 @@ public:
   void path( const char *p ) { path_ = p; }
   const char *path() { return path_; }
 
-private:
-  const char *getStr_( char *&line,
-		       char *buf,
-		       size_t bufSize ) const;
-
-  void parseVals_( char *line,
-		   double *vals,
-		   const size_t n ) const;
-
-  const double getValue_( char *line, 
-			  const yahooTS::dataKind kind ) const;
-
 }; // yahooTS
 
 
@@ -0,0 +1,351 @@
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxyeng.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "yahooCSV.h"
+#include "equityCache.h"
+
+
+/** the byte order mark, as written by the machine that built the cache */
+static const unsigned int byteOrderMark = 0x01020304;
+
+/** the cache file version */
+static const unsigned int cacheVersion = 1;
+
+
+equityCache::equityCache()
+{
+  dir = 0;
+  numSyms = 0;
+} // equityCache
+
+
+equityCache::~equityCache()
+{
+  close();
+} // ~equityCache
+
+
+/**
+  Unmap the cache file
+ */
+void equityCache::close()
+{
+  file.close();
+  dir = 0;
+  numSyms = 0;
+} // close
+
+
+/**
+  The number of bytes used by the columns of a symbol with <i>N</i>
+  lines: the date column, the five value columns and the integer
+  volume column.
+ */
+size_t equityCache::symbolBytes( const size_t N )
+{
+  return dateBytes( N ) + ((yahooCSV::numCols + 1) * colBytes( N ));
+} // symbolBytes
+
+
+/**
+  Write <i>n</i> zero bytes
+ */
+bool equityCache::pad( FILE *fp, const size_t n )
+{
+  static const char zeros[ colAlign ] = { 0 };
+  size_t left = n;
+  while (left > 0) {
+    const size_t len = (left < sizeof( zeros )) ? left : sizeof( zeros );
+    if (fwrite( zeros, 1, len, fp ) != len) {
+      return false;
+    }
+    left = left - len;
+  }
+  return true;
+} // pad
+
+
+/**
+  Parse the text files for the null terminated list of
+  <i>symbols</i> in the directory <i>dataDir</i> (which, as in
+  yahooTS, is a prefix that is added to the symbol name) and write
+  the cache file <i>cachePath</i>.
+
+  The header and directory are written first with zero entries.
+  Each file is loaded and its columns are written, and then the
+  directory is written again with the length and offset of each
+  symbol.  Only one text file is in memory at a time.
+ */
+bool equityCache::build( const char *cachePath,
+                         const char *dataDir,
+                         const char **symbols )
+{
+  size_t num = 0;
+  while (symbols[num] != 0) {
+    if (strlen( symbols[num] ) >= nameLen) {
+      fprintf(stderr, "equityCache::build: symbol %s is too long\n", symbols[num] );
+      return false;
+    }
+    num++;
+  }
+
+  FILE *fp = fopen( cachePath, "wb" );
+  if (fp == 0) {
+    fprintf(stderr, "equityCache::build: could not open %s for writing\n", cachePath );
+    return false;
+  }
+
+  entry *entries = new entry[ (num > 0) ? num : 1 ];
+  memset( entries, 0, num * sizeof( entry ) );
+
+  header hdr;
+  memset( &hdr, 0, sizeof( hdr ) );
+  memcpy( hdr.magic, "KPEQ", 4 );
+  hdr.version = cacheVersion;
+  hdr.numSymbols = (unsigned int)num;
+  hdr.byteOrder = byteOrderMark;
+
+  size_t offset = alignUp( headerBytes + (num * entryBytes) );
+  bool ok = (fwrite( &hdr, sizeof( hdr ), 1, fp ) == 1 &&
+             (num == 0 || fwrite( entries, sizeof( entry ), num, fp ) == num) &&
+             pad( fp, offset - (headerBytes + (num * entryBytes)) ));
+
+  yahooCSV csv;
+  for (size_t i = 0; ok && i < num; i++) {
+    char fullPath[512];
+    fullPath[0] = '\0';
+    if (dataDir != 0) {
+      strncpy( fullPath, dataDir, sizeof( fullPath ) - 1 );
+      fullPath[ sizeof( fullPath ) - 1 ] = '\0';
+    }
+    strncat( fullPath, symbols[i], sizeof( fullPath ) - strlen( fullPath ) - 1 );
+
+    ok = csv.load( fullPath );
+    if (ok) {
+      const size_t N = csv.length();
+      strcpy( entries[i].name, symbols[i] );
+      entries[i].N = (long long)N;
+      entries[i].offset = (long long)offset;
+
+      ok = (fwrite( csv.date(), sizeof( int ), N, fp ) == N &&
+            pad( fp, dateBytes( N ) - (N * sizeof( int )) ));
+      for (size_t c = 0; ok && c < yahooCSV::numCols; c++) {
+        const yahooTS::dataKind kind = (yahooTS::dataKind)(yahooTS::Open + c);
+        ok = (fwrite( csv.column( kind ), sizeof( double ), N, fp ) == N &&
+              pad( fp, colBytes( N ) - (N * sizeof( double )) ));
+      }
+      ok = (ok &&
+            fwrite( csv.volume(), sizeof( long long ), N, fp ) == N &&
+            pad( fp, colBytes( N ) - (N * sizeof( long long )) ));
+      offset = offset + symbolBytes( N );
+    }
+  }
+
+  if (ok) {
+    hdr.fileLen = (long long)offset;
+    ok = (fseek( fp, 0, SEEK_SET ) == 0 &&
+          fwrite( &hdr, sizeof( hdr ), 1, fp ) == 1 &&
+          (num == 0 || fwrite( entries, sizeof( entry ), num, fp ) == num));
+  }
+  if (fclose( fp ) != 0) {
+    ok = false;
+  }
+  if (! ok) {
+    fprintf(stderr, "equityCache::build: could not build %s\n", cachePath );
+    remove( cachePath );
+  }
+
+  delete [] entries;
+  return ok;
+} // build
+
+
+/**
+  Map the cache file <i>path</i> into memory and check the header
+  and directory.  Any cache that was already open is closed first.
+ */
+bool equityCache::open( const char *path )
+{
+  close();
+
+  if (! file.open( path )) {
+    return false;
+  }
+
+  const size_t len = file.length();
+  const header *hdr = (const header *)file.data();
+  bool ok = (len >= headerBytes &&
+             memcmp( hdr->magic, "KPEQ", 4 ) == 0 &&
+             hdr->version == cacheVersion &&
+             hdr->byteOrder == byteOrderMark &&
+             hdr->fileLen == (long long)len &&
+             headerBytes + (hdr->numSymbols * (size_t)entryBytes) <= len);
+
+  const entry *entries = (const entry *)(file.data() + headerBytes);
+  for (size_t i = 0; ok && i < hdr->numSymbols; i++) {
+    const size_t N = (size_t)entries[i].N;
+    const size_t offset = (size_t)entries[i].offset;
+    ok = (memchr( entries[i].name, '\0', nameLen ) != 0 &&
+          entries[i].N >= 0 &&
+          offset % colAlign == 0 &&
+          offset <= len &&
+          N <= (len - offset) / (sizeof( int ) + ((yahooCSV::numCols + 1) * sizeof( double ))) &&
+          symbolBytes( N ) <= len - offset);
+  }
+
+  if (! ok) {
+    fprintf(stderr, "equityCache::open: %s is not a valid cache file\n", path );
+    file.close();
+    return false;
+  }
+
+  dir = entries;
+  numSyms = hdr->numSymbols;
+  return true;
+} // open
+
+
+/**
+  The name of symbol <i>sym</i>
+ */
+const char *equityCache::symbol( const size_t sym ) const
+{
+  return (sym < numSyms) ? dir[sym].name : 0;
+} // symbol
+
+
+/**
+  Return the index of the symbol <i>name</i>, or -1 if it is not in
+  the cache.
+ */
+int equityCache::find( const char *name ) const
+{
+  for (size_t i = 0; i < numSyms; i++) {
+    if (strcmp( dir[i].name, name ) == 0) {
+      return (int)i;
+    }
+  }
+  return -1;
+} // find
+
+
+/**
+  The number of lines of data for symbol <i>sym</i>
+ */
+size_t equityCache::length( const size_t sym ) const
+{
+  return (sym < numSyms) ? (size_t)dir[sym].N : 0;
+} // length
+
+
+/**
+  The start of the columns of symbol <i>sym</i> (0 if there is no
+  such symbol)
+ */
+const unsigned char *equityCache::columns( const size_t sym ) const
+{
+  return (sym < numSyms) ? file.data() + dir[sym].offset : 0;
+} // columns
+
+
+/**
+  The dates for symbol <i>sym</i>, in days since 1 January 1970
+ */
+const int *equityCache::date( const size_t sym ) const
+{
+  return (const int *)columns( sym );
+} // date
+
+
+/**
+  The column for <i>kind</i> (Open, High, Low, Close or Volume) of
+  symbol <i>sym</i>.  The pointer points into the mapped cache file
+  and is valid until the cache is closed.  Returns 0 if there is no
+  such symbol or kind is not a column.
+ */
+const double *equityCache::column( const size_t sym, const yahooTS::dataKind kind ) const
+{
+  const unsigned char *cols = columns( sym );
+  if (cols == 0 || kind <= yahooTS::badEnum || kind >= yahooTS::lastEnum) {
+    return 0;
+  }
+  const size_t N = length( sym );
+  return (const double *)(cols + dateBytes( N ) + ((kind - yahooTS::Open) * colBytes( N )));
+} // column
+
+
+/**
+  The volume column of symbol <i>sym</i>, as 64-bit integers
+ */
+const long long *equityCache::volume( const size_t sym ) const
+{
+  const unsigned char *cols = columns( sym );
+  if (cols == 0) {
+    return 0;
+  }
+  const size_t N = length( sym );
+  return (const long long *)(cols + dateBytes( N ) + (yahooCSV::numCols * colBytes( N )));
+} // volume
+
+
+/**
+  The cache version of yahooTS::getTS: return a pointer to the last
+  (most recent) <i>N</i> values of the <i>kind</i> column for the
+  symbol <i>name</i>, oldest first.  If the symbol has fewer than N
+  lines, N is set to the number of lines.  Nothing is copied.
+  Returns 0 if the symbol is not in the cache.
+ */
+const double *equityCache::getTS( const char *name,
+                                  size_t &N,
+                                  const yahooTS::dataKind kind ) const
+{
+  const int sym = find( name );
+  if (sym < 0) {
+    fprintf(stderr, "equityCache::getTS: %s is not in the cache\n", name );
+    return 0;
+  }
+  const double *col = column( sym, kind );
+  if (col == 0) {
+    fprintf(stderr, "equityCache::getTS: bad data kind\n");
+    return 0;
+  }
+  const size_t total = length( sym );
+  if (total < N) {
+    N = total;
+  }
+  return col + (total - N);
+} // getTS
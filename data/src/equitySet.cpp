@@ -0,0 +1,337 @@
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxyeng.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include "yahooCSV.h"
+#include "taskpool.h"
+#include "equitySet.h"
+
+
+/** the arguments of loadTask */
+typedef struct {
+  const char *dataDir;
+  char **names;
+  yahooCSV *csv;
+  bool *ok;
+} loadArgs;
+
+
+/**
+  Build the path of a file: the directory prefix followed by the
+  file name (as in yahooTS::getTS)
+ */
+static void fullPath( char *path,
+                      const size_t pathLen,
+                      const char *dataDir,
+                      const char *name )
+{
+  path[0] = '\0';
+  if (dataDir != 0) {
+    strncpy( path, dataDir, pathLen - 1 );
+    path[pathLen - 1] = '\0';
+  }
+  strncat( path, name, pathLen - strlen( path ) - 1 );
+} // fullPath
+
+
+equitySet::equitySet()
+{
+  names_ = 0;
+  numSyms = 0;
+  dates_ = 0;
+  numDates_ = 0;
+  matrix_ = 0;
+  first_ = 0;
+  bytes_ = 0;
+  seconds_ = 0.0;
+} // equitySet
+
+
+equitySet::~equitySet()
+{
+  clear();
+} // ~equitySet
+
+
+/**
+  Free the symbol names and the matrix
+ */
+void equitySet::clear()
+{
+  for (size_t i = 0; i < numSyms; i++) {
+    delete [] names_[i];
+  }
+  delete [] names_;
+  delete [] dates_;
+  delete [] matrix_;
+  delete [] first_;
+  names_ = 0;
+  numSyms = 0;
+  dates_ = 0;
+  numDates_ = 0;
+  matrix_ = 0;
+  first_ = 0;
+} // clear
+
+
+int equitySet::compareNames( const void *a, const void *b )
+{
+  return strcmp( *(const char **)a, *(const char **)b );
+} // compareNames
+
+
+int equitySet::compareDates( const void *a, const void *b )
+{
+  const int x = *(const int *)a;
+  const int y = *(const int *)b;
+  return (x < y) ? -1 : ((x > y) ? 1 : 0);
+} // compareDates
+
+
+/**
+  Add a copy of <i>name</i> to the list of names, growing the list
+  if it is full.  The list is always followed by a null pointer.
+ */
+void equitySet::addName( const char *name, size_t &maxNames )
+{
+  if (numSyms + 1 >= maxNames) {
+    maxNames = (maxNames > 0) ? maxNames * 2 : 64;
+    char **newNames = new char *[ maxNames ];
+    for (size_t i = 0; i < numSyms; i++) {
+      newNames[i] = names_[i];
+    }
+    delete [] names_;
+    names_ = newNames;
+  }
+  const size_t len = strlen( name );
+  names_[numSyms] = new char[ len + 1 ];
+  memcpy( names_[numSyms], name, len + 1 );
+  numSyms++;
+  names_[numSyms] = 0;
+} // addName
+
+
+/**
+  Find the files in the directory <i>dataDir</i>.  As in yahooTS,
+  dataDir is a prefix that is added to a file name to build its
+  path, so it ends with a separator (e.g., "../data/equities/").
+  Files whose names start with a dot and subdirectories are
+  skipped.  The names are sorted.  Any set that was loaded before
+  is freed.  Returns the number of files.
+ */
+size_t equitySet::list( const char *dataDir )
+{
+  clear();
+  size_t maxNames = 0;
+  char path[512];
+
+#if defined(_WIN32)
+  fullPath( path, sizeof( path ), dataDir, "*" );
+  WIN32_FIND_DATAA findData;
+  HANDLE find = FindFirstFileA( path, &findData );
+  if (find == INVALID_HANDLE_VALUE) {
+    fprintf(stderr, "equitySet::list: could not read the directory %s\n", path );
+    return 0;
+  }
+  do {
+    if (findData.cFileName[0] != '.' &&
+        (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0) {
+      addName( findData.cFileName, maxNames );
+    }
+  } while (FindNextFileA( find, &findData ));
+  FindClose( find );
+#else
+  const char *dirPath = (dataDir != 0 && dataDir[0] != '\0') ? dataDir : ".";
+  DIR *dir = opendir( dirPath );
+  if (dir == 0) {
+    fprintf(stderr, "equitySet::list: could not read the directory %s\n", dirPath );
+    return 0;
+  }
+  struct dirent *ent;
+  while ((ent = readdir( dir )) != 0) {
+    if (ent->d_name[0] != '.') {
+      struct stat st;
+      fullPath( path, sizeof( path ), dataDir, ent->d_name );
+      if (stat( path, &st ) == 0 && S_ISREG( st.st_mode )) {
+        addName( ent->d_name, maxNames );
+      }
+    }
+  }
+  closedir( dir );
+#endif
+
+  if (numSyms > 1) {
+    qsort( names_, numSyms, sizeof( char * ), compareNames );
+  }
+  return numSyms;
+} // list
+
+
+/**
+  Load the file for symbol number <i>task</i> (called by the
+  taskpool threads)
+ */
+void equitySet::loadTask( void *arg, const size_t task )
+{
+  const loadArgs *args = (const loadArgs *)arg;
+  char path[512];
+  fullPath( path, sizeof( path ), args->dataDir, args->names[task] );
+  args->ok[task] = args->csv[task].load( path );
+} // loadTask
+
+
+/**
+  Build the date aligned matrix from the <i>kind</i> column of the
+  loaded files.  Symbol <i>s</i> was loaded into csv[ix[s]].  The
+  dates of each file are in increasing order.
+ */
+void equitySet::align( const yahooCSV *csv,
+                       const size_t *ix,
+                       const yahooTS::dataKind kind )
+{
+  size_t total = 0;
+  for (size_t s = 0; s < numSyms; s++) {
+    total = total + csv[ix[s]].length();
+  }
+
+  // the union of the dates: sort all of them and remove the
+  // duplicates
+  dates_ = new int[ (total > 0) ? total : 1 ];
+  size_t n = 0;
+  for (size_t s = 0; s < numSyms; s++) {
+    memcpy( dates_ + n, csv[ix[s]].date(), csv[ix[s]].length() * sizeof( int ) );
+    n = n + csv[ix[s]].length();
+  }
+  qsort( dates_, total, sizeof( int ), compareDates );
+  numDates_ = 0;
+  for (size_t i = 0; i < total; i++) {
+    if (numDates_ == 0 || dates_[i] != dates_[numDates_ - 1]) {
+      dates_[numDates_] = dates_[i];
+      numDates_++;
+    }
+  }
+
+  matrix_ = new double[ (numSyms * numDates_ > 0) ? numSyms * numDates_ : 1 ];
+  first_ = new size_t[ (numSyms > 0) ? numSyms : 1 ];
+  for (size_t s = 0; s < numSyms; s++) {
+    const size_t len = csv[ix[s]].length();
+    const int *date = csv[ix[s]].date();
+    const double *col = csv[ix[s]].column( kind );
+    double *row = matrix_ + (s * numDates_);
+    double last = (len > 0) ? col[0] : 0.0;
+    size_t j = 0;
+
+    first_[s] = numDates_;
+    for (size_t d = 0; d < numDates_; d++) {
+      while (j < len && date[j] <= dates_[d]) {
+        if (first_[s] == numDates_) {
+          first_[s] = d;
+        }
+        last = col[j];
+        j++;
+      }
+      row[d] = last;
+    }
+  }
+} // align
+
+
+/**
+  Load the <i>kind</i> column (Open, High, Low, Close or Volume) of
+  every file in the directory <i>dataDir</i> (see list) on
+  <i>numThreads</i> threads (one for each processor if numThreads
+  is zero) and build the date aligned matrix.
+ */
+bool equitySet::load( const char *dataDir,
+                      const yahooTS::dataKind kind,
+                      const size_t numThreads )
+{
+  bytes_ = 0;
+  seconds_ = 0.0;
+  if (kind <= yahooTS::badEnum || kind >= yahooTS::lastEnum) {
+    fprintf(stderr, "equitySet::load: bad data kind\n");
+    return false;
+  }
+
+  const double startTime = taskpool::wallSeconds();
+  const size_t num = list( dataDir );
+  if (num == 0) {
+    return false;
+  }
+
+  yahooCSV *csv = new yahooCSV[ num ];
+  bool *ok = new bool[ num ];
+  loadArgs args;
+  args.dataDir = dataDir;
+  args.names = names_;
+  args.csv = csv;
+  args.ok = ok;
+  taskpool::run( loadTask, &args, num, numThreads );
+
+  // leave out the files that could not be loaded.  ix[s] is the
+  // index in csv of symbol s.
+  size_t *ix = new size_t[ num ];
+  size_t loaded = 0;
+  for (size_t s = 0; s < num; s++) {
+    bytes_ = bytes_ + csv[s].bytes();
+    if (ok[s]) {
+      names_[loaded] = names_[s];
+      ix[loaded] = s;
+      loaded++;
+    }
+    else {
+      delete [] names_[s];
+    }
+  }
+  numSyms = loaded;
+  names_[numSyms] = 0;
+
+  align( csv, ix, kind );
+
+  delete [] ix;
+  delete [] ok;
+  delete [] csv;
+  seconds_ = taskpool::wallSeconds() - startTime;
+  return (numSyms > 0);
+} // load
@@ -0,0 +1,146 @@
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxyeng.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mapfile.h"
+
+
+mapfile::mapfile()
+{
+  base = 0;
+  fileLen = 0;
+#if defined(_WIN32)
+  fileHandle = INVALID_HANDLE_VALUE;
+  mapHandle = 0;
+#else
+  fd = -1;
+#endif
+} // mapfile
+
+
+mapfile::~mapfile()
+{
+  close();
+} // ~mapfile
+
+
+/**
+  Map the file <i>path</i> into memory.  Any file that was already
+  open is closed first.  Returns false if the file cannot be opened
+  or mapped, or is empty.
+ */
+bool mapfile::open( const char *path )
+{
+  close();
+
+#if defined(_WIN32)
+  fileHandle = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, 0,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+  if (fileHandle == INVALID_HANDLE_VALUE) {
+    fprintf(stderr, "mapfile::open: could not open %s\n", path );
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (GetFileSizeEx( fileHandle, &size ) && size.QuadPart > 0) {
+    fileLen = (size_t)size.QuadPart;
+    mapHandle = CreateFileMappingA( fileHandle, 0, PAGE_READONLY, 0, 0, 0 );
+    if (mapHandle != 0) {
+      base = (const unsigned char *)MapViewOfFile( mapHandle, FILE_MAP_READ, 0, 0, 0 );
+    }
+  }
+#else
+  fd = ::open( path, O_RDONLY );
+  if (fd < 0) {
+    const char *error = strerror( errno );
+    fprintf(stderr, "mapfile::open: could not open %s: %s\n", path, error );
+    return false;
+  }
+  struct stat st;
+  if (fstat( fd, &st ) == 0 && st.st_size > 0) {
+    fileLen = (size_t)st.st_size;
+    void *p = mmap( 0, fileLen, PROT_READ, MAP_SHARED, fd, 0 );
+    if (p != MAP_FAILED) {
+      base = (const unsigned char *)p;
+    }
+  }
+#endif
+  if (base == 0) {
+    fprintf(stderr, "mapfile::open: could not map %s (or it is empty)\n", path );
+    close();
+    return false;
+  }
+  return true;
+} // open
+
+
+/**
+  Unmap and close the file
+ */
+void mapfile::close()
+{
+#if defined(_WIN32)
+  if (base != 0) {
+    UnmapViewOfFile( base );
+  }
+  if (mapHandle != 0) {
+    CloseHandle( mapHandle );
+  }
+  if (fileHandle != INVALID_HANDLE_VALUE) {
+    CloseHandle( fileHandle );
+  }
+  fileHandle = INVALID_HANDLE_VALUE;
+  mapHandle = 0;
+#else
+  if (base != 0) {
+    munmap( (void *)base, fileLen );
+  }
+  if (fd >= 0) {
+    ::close( fd );
+  }
+  fd = -1;
+#endif
+  base = 0;
+  fileLen = 0;
+} // close
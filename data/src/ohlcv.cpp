@@ -0,0 +1,209 @@
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxyeng.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "yahooCSV.h"
+#include "equityCache.h"
+#include "ohlcv.h"
+
+
+ohlcv::ohlcv()
+{
+  N_ = 0;
+  date_ = 0;
+  prices_ = 0;
+  volume_ = 0;
+} // ohlcv
+
+
+ohlcv::~ohlcv()
+{
+  clear();
+} // ~ohlcv
+
+
+/**
+  Free the columns
+ */
+void ohlcv::clear()
+{
+  delete [] date_;
+  delete [] prices_;
+  delete [] volume_;
+  date_ = 0;
+  prices_ = 0;
+  volume_ = 0;
+  N_ = 0;
+} // clear
+
+
+/**
+  Allocate the columns for <i>N</i> lines
+ */
+void ohlcv::alloc( const size_t N )
+{
+  clear();
+  const size_t n = (N > 0) ? N : 1;
+  date_ = new int[ n ];
+  prices_ = new double[ numPrices * n ];
+  volume_ = new int64_t[ n ];
+  N_ = N;
+} // alloc
+
+
+/**
+  Copy the last <i>N</i> of the <i>total</i> lines of the date,
+  price and volume columns.  <i>cols</i> holds the Open, High, Low
+  and Close columns.
+ */
+bool ohlcv::fill( const int *date,
+                  const double *cols[],
+                  const long long *volume,
+                  const size_t total,
+                  const size_t N )
+{
+  if (total < N) {
+    fprintf(stderr, "ohlcv::load: %d lines were requested, but there are only %d\n",
+            (int)N, (int)total );
+    clear();
+    return false;
+  }
+
+  alloc( N );
+  const size_t start = total - N;
+  memcpy( date_, date + start, N * sizeof( int ) );
+  for (size_t c = 0; c < numPrices; c++) {
+    memcpy( prices_ + (c * N), cols[c] + start, N * sizeof( double ) );
+  }
+  for (size_t i = 0; i < N; i++) {
+    volume_[i] = (int64_t)volume[start + i];
+  }
+  return true;
+} // fill
+
+
+/**
+  Load the last (most recent) <i>N</i> lines of all of the columns
+  of the Yahoo file <i>path</i>, oldest first.  The file is parsed
+  once.
+ */
+bool ohlcv::load( const char *path, const size_t N )
+{
+  yahooCSV csv;
+  if (! csv.load( path )) {
+    clear();
+    return false;
+  }
+  const double *cols[ numPrices ];
+  for (size_t c = 0; c < numPrices; c++) {
+    cols[c] = csv.column( (yahooTS::dataKind)(yahooTS::Open + c) );
+  }
+  return fill( csv.date(), cols, csv.volume(), csv.length(), N );
+} // load
+
+
+/**
+  Load the last <i>N</i> lines of all of the columns of the symbol
+  <i>name</i> from the binary equity cache.
+ */
+bool ohlcv::load( const equityCache &cache, const char *name, const size_t N )
+{
+  const int sym = cache.find( name );
+  if (sym < 0) {
+    fprintf(stderr, "ohlcv::load: %s is not in the cache\n", name );
+    clear();
+    return false;
+  }
+  const double *cols[ numPrices ];
+  for (size_t c = 0; c < numPrices; c++) {
+    cols[c] = cache.column( sym, (yahooTS::dataKind)(yahooTS::Open + c) );
+  }
+  return fill( cache.date( sym ), cols, cache.volume( sym ), cache.length( sym ), N );
+} // load
+
+
+/**
+  Apply the forward (<i>isForward</i> true) or inverse transform
+  <i>w</i> to the four price columns.  The columns are interleaved
+  into a temporary block, so the wavelet's column kernels (see
+  liftbase::forwardSpanCols) step all of the columns together.  If
+  the wavelet does not supply column kernels, or the temporary
+  memory cannot be allocated, the columns are transformed one at a
+  time.
+ */
+void ohlcv::priceTrans( liftbase<double *, double> &w, const bool isForward )
+{
+  const int n = (int)N_;
+  double *rows = (N_ > 0) ? new double[ 2 * numPrices * N_ ] : 0;
+  bool done = false;
+
+  if (rows != 0) {
+    double *tmp = rows + (numPrices * N_);
+    for (size_t c = 0; c < numPrices; c++) {
+      const double *col = prices_ + (c * N_);
+      for (size_t i = 0; i < N_; i++) {
+        rows[(i * numPrices) + c] = col[i];
+      }
+    }
+    if (isForward) {
+      done = w.forwardTransCols( rows, tmp, n, numPrices );
+    }
+    else {
+      done = w.inverseTransCols( rows, tmp, n, numPrices );
+    }
+    if (done) {
+      for (size_t c = 0; c < numPrices; c++) {
+        double *col = prices_ + (c * N_);
+        for (size_t i = 0; i < N_; i++) {
+          col[i] = rows[(i * numPrices) + c];
+        }
+      }
+    }
+    delete [] rows;
+  }
+
+  if (! done) {
+    for (size_t c = 0; c < numPrices; c++) {
+      double *col = prices_ + (c * N_);
+      if (isForward) {
+        w.forwardTrans( col, n );
+      }
+      else {
+        w.inverseTrans( col, n );
+      }
+    }
+  }
+} // priceTrans
@@ -0,0 +1,189 @@
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxyeng.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+#include <stdio.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "taskpool.h"
+
+
+/** the largest number of threads that run will start */
+static const size_t maxThreads = 256;
+
+
+/** the state shared by the worker threads */
+typedef struct {
+  taskpool::taskFunc func;
+  void *arg;
+  size_t numTasks;
+  /** the next task number */
+  volatile long next;
+} taskState;
+
+
+/** take the next task number, with an atomic increment */
+static size_t nextTask( taskState *state )
+{
+#if defined(_WIN32)
+  return (size_t)(InterlockedIncrement( &state->next ) - 1);
+#else
+  return (size_t)__sync_fetch_and_add( &state->next, 1 );
+#endif
+} // nextTask
+
+
+/** run tasks until there are none left */
+static void worker( taskState *state )
+{
+  for (size_t task = nextTask( state ); task < state->numTasks; task = nextTask( state )) {
+    (*state->func)( state->arg, task );
+  }
+} // worker
+
+
+#if defined(_WIN32)
+static unsigned __stdcall threadStart( void *arg )
+{
+  worker( (taskState *)arg );
+  return 0;
+} // threadStart
+#else
+static void *threadStart( void *arg )
+{
+  worker( (taskState *)arg );
+  return 0;
+} // threadStart
+#endif
+
+
+/**
+  The number of processors that are available (at least one)
+ */
+size_t taskpool::numProcessors()
+{
+  long count = 1;
+#if defined(_WIN32)
+  SYSTEM_INFO info;
+  GetSystemInfo( &info );
+  count = (long)info.dwNumberOfProcessors;
+#else
+  count = sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+  return (count > 0) ? (size_t)count : 1;
+} // numProcessors
+
+
+/**
+  Run tasks 0 to <i>numTasks</i>-1 on <i>numThreads</i> threads (one
+  thread for each processor if numThreads is zero).  The calling
+  thread is one of the workers.  run returns when all of the tasks
+  are finished.
+ */
+void taskpool::run( taskFunc func,
+                    void *arg,
+                    const size_t numTasks,
+                    const size_t numThreads )
+{
+  taskState state;
+  state.func = func;
+  state.arg = arg;
+  state.numTasks = numTasks;
+  state.next = 0;
+
+  size_t threads = (numThreads > 0) ? numThreads : numProcessors();
+  if (threads > numTasks) {
+    threads = numTasks;
+  }
+  if (threads > maxThreads) {
+    threads = maxThreads;
+  }
+
+  // start threads-1 threads; the calling thread is the last worker
+  size_t started = 0;
+#if defined(_WIN32)
+  HANDLE handles[ maxThreads ];
+  for (; started + 1 < threads; started++) {
+    handles[started] = (HANDLE)_beginthreadex( 0, 0, threadStart, &state, 0, 0 );
+    if (handles[started] == 0) {
+      break;
+    }
+  }
+#else
+  pthread_t handles[ maxThreads ];
+  for (; started + 1 < threads; started++) {
+    if (pthread_create( &handles[started], 0, threadStart, &state ) != 0) {
+      break;
+    }
+  }
+#endif
+
+  worker( &state );
+
+  for (size_t i = 0; i < started; i++) {
+#if defined(_WIN32)
+    WaitForSingleObject( handles[i], INFINITE );
+    CloseHandle( handles[i] );
+#else
+    pthread_join( handles[i], 0 );
+#endif
+  }
+} // run
+
+
+/**
+  Elapsed (wall clock) time in seconds from an arbitrary starting
+  point.  Unlike clock(), which measures the processor time used by
+  all of the threads, this measures the time that the caller waits.
+ */
+double taskpool::wallSeconds()
+{
+#if defined(_WIN32)
+  LARGE_INTEGER count, freq;
+  QueryPerformanceCounter( &count );
+  QueryPerformanceFrequency( &freq );
+  return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+  struct timeval tv;
+  gettimeofday( &tv, 0 );
+  return (double)tv.tv_sec + ((double)tv.tv_usec * 1e-6);
+#endif
+} // wallSeconds
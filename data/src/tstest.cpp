@@ -1,7 +1,13 @@
 
 #include <stdio.h>
 
+#include <time.h>
+
 #include "yahooTS.h"
+#include "yahooCSV.h"
+#include "equityCache.h"
+#include "equitySet.h"
+#include "taskpool.h"
 
 
 main()
@@ -19,4 +25,67 @@ main()
   else {
     fprintf(stderr, "main: getTS failed\n");
   }
+
+  // Load all of the columns with yahooCSV, a number of times, and
+  // report the loader throughput
+  const size_t reps = 1000;
+  yahooCSV csv;
+  size_t bytes = 0;
+  clock_t start = clock();
+  for (size_t i = 0; i < reps; i++) {
+    if (! csv.load( "equities\\aa" )) {
+      break;
+    }
+    bytes = bytes + csv.bytes();
+  }
+  double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+  if (csv.length() > 0 && secs > 0) {
+    const double *close = csv.column( yahooTS::Close );
+    printf("yahooCSV: %lu lines, first day %d, last day %d, last close %f\n",
+           (unsigned long)csv.length(), csv.date()[0], csv.date()[csv.length()-1],
+           close[csv.length()-1] );
+    printf("yahooCSV: %.1f MB/sec\n", ((double)bytes / (1024.0 * 1024.0)) / secs );
+  }
+
+  // Write the columns to a binary cache and open the cache the same
+  // number of times.  The columns are read in place, without
+  // parsing.
+  const char *symbols[] = { "aa", 0 };
+  const char *cachePath = "tstest.kpeq";
+  if (equityCache::build( cachePath, "equities\\", symbols )) {
+    equityCache cache;
+    double sum = 0;
+    start = clock();
+    for (size_t i = 0; i < reps; i++) {
+      if (! cache.open( cachePath )) {
+        break;
+      }
+      size_t n = 1;
+      const double *close = cache.getTS( "aa", n, yahooTS::Close );
+      sum = sum + close[0];
+    }
+    secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+    if (cache.numSymbols() > 0) {
+      const size_t n = cache.length( 0 );
+      printf("equityCache: %lu lines, first day %d, last day %d, last close %f\n",
+             (unsigned long)n, cache.date( 0 )[0], cache.date( 0 )[n-1],
+             cache.column( 0, yahooTS::Close )[n-1] );
+      printf("equityCache: %.1f microseconds per open\n", (secs * 1e6) / reps );
+    }
+    cache.close();
+    remove( cachePath );
+  }
+
+  // Load the close prices of all of the files in the directory and
+  // align them by date, first on one thread and then on a thread for
+  // each processor
+  equitySet dataSet;
+  const size_t threads[] = { 1, taskpool::numProcessors() };
+  for (size_t t = 0; t < 2; t++) {
+    if (dataSet.load( "equities/", yahooTS::Close, threads[t] )) {
+      printf("equitySet: %lu symbols x %lu dates, %lu threads, %.1f MB/sec\n",
+             (unsigned long)dataSet.numSymbols(), (unsigned long)dataSet.numDates(),
+             (unsigned long)threads[t], dataSet.mbPerSec() );
+    }
+  }
 }
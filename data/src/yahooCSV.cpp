@@ -0,0 +1,513 @@
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxyeng.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define YAHOOCSV_SSE2
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "yahooCSV.h"
+
+
+/** exact powers of ten (every power up to 10^22 is a double) */
+static const double pow10Table[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                     1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                     1e18, 1e19, 1e20, 1e21, 1e22 };
+
+/** the largest number of significant digits parsed without strtod */
+static const int maxFastDigits = 15;
+
+
+#if defined(YAHOOCSV_SSE2)
+/** the index of the lowest set bit of a non-zero mask */
+static int lowBit( const unsigned int mask )
+{
+#if defined(_MSC_VER)
+  unsigned long ix;
+  _BitScanForward( &ix, mask );
+  return (int)ix;
+#else
+  return __builtin_ctz( mask );
+#endif
+} // lowBit
+
+/** a mask with a bit set for each byte of <i>c</i> equal to <i>ch</i> */
+static unsigned int matchMask( const __m128i c, const char ch )
+{
+  return (unsigned int)_mm_movemask_epi8( _mm_cmpeq_epi8( c, _mm_set1_epi8( ch ) ) );
+} // matchMask
+#endif
+
+
+/**
+  Count the newlines in <i>buf</i>, sixteen bytes at a time when
+  SSE2 is available.
+ */
+static size_t countLines( const char *buf, const size_t len )
+{
+  size_t count = 0;
+  size_t i = 0;
+#if defined(YAHOOCSV_SSE2)
+  for (; i + 16 <= len; i += 16) {
+    unsigned int mask = matchMask( _mm_loadu_si128( (const __m128i *)(buf + i) ), '\n' );
+    while (mask != 0) {
+      mask = mask & (mask - 1);
+      count++;
+    }
+  }
+#endif
+  for (; i < len; i++) {
+    if (buf[i] == '\n') {
+      count++;
+    }
+  }
+  return count;
+} // countLines
+
+
+yahooCSV::yahooCSV()
+{
+  N_ = 0;
+  date_ = 0;
+  for (size_t c = 0; c < numCols; c++) {
+    cols_[c] = 0;
+  }
+  volume_ = 0;
+  bytes_ = 0;
+  seconds_ = 0.0;
+} // yahooCSV
+
+
+yahooCSV::~yahooCSV()
+{
+  clear();
+} // ~yahooCSV
+
+
+/**
+  Free the columns
+ */
+void yahooCSV::clear()
+{
+  delete [] date_;
+  for (size_t c = 0; c < numCols; c++) {
+    delete [] cols_[c];
+    cols_[c] = 0;
+  }
+  delete [] volume_;
+  date_ = 0;
+  volume_ = 0;
+  N_ = 0;
+} // clear
+
+
+/**
+  Allocate the columns for at most <i>maxLines</i> lines
+ */
+void yahooCSV::alloc( const size_t maxLines )
+{
+  const size_t n = (maxLines > 0) ? maxLines : 1;
+  date_ = new int[ n ];
+  for (size_t c = 0; c < numCols; c++) {
+    cols_[c] = new double[ n ];
+  }
+  volume_ = new long long[ n ];
+} // alloc
+
+
+/**
+  The number of days from 1 January 1970 to a date in the
+  (proleptic) Gregorian calendar.  <i>month</i> is 1 to 12.
+ */
+int yahooCSV::civilDays( const int year, const int month, const int day )
+{
+  const int y = year - ((month <= 2) ? 1 : 0);
+  const int era = ((y >= 0) ? y : y - 399) / 400;
+  const int yearOfEra = y - (era * 400);
+  const int dayOfYear = ((153 * (month + ((month > 2) ? -3 : 9))) + 2) / 5 + day - 1;
+  const int dayOfEra = (yearOfEra * 365) + (yearOfEra / 4) - (yearOfEra / 100) + dayOfYear;
+  return (era * 146097) + dayOfEra - 719468;
+} // civilDays
+
+
+/**
+  Parse the digits in [s, end) as an unsigned integer.  Returns the
+  number of digits, or zero if there are none or a character is
+  not a digit.
+ */
+static int parseDigits( const char *s, const char *end, int &v )
+{
+  v = 0;
+  int count = 0;
+  for (; s < end; s++, count++) {
+    if (*s < '0' || *s > '9' || count > 8) {
+      return 0;
+    }
+    v = (v * 10) + (*s - '0');
+  }
+  return count;
+} // parseDigits
+
+
+/**
+  Parse a date in [s, end) and return the number of days since
+  1 January 1970 in <i>days</i>.  The date is either in the Yahoo
+  format (e.g., 2-Aug-02 or 2-Aug-2002) or the ISO format
+  (2002-08-02).  Returns false if the date is not valid.
+ */
+bool yahooCSV::parseDate( const char *s, const char *end, int &days )
+{
+  static const char *months = "janfebmaraprmayjunjulaugsepoctnovdec";
+  int year = 0, month = 0, day = 0;
+
+  const char *dash1 = (const char *)memchr( s, '-', end - s );
+  if (dash1 == 0) {
+    return false;
+  }
+  const char *dash2 = (const char *)memchr( dash1 + 1, '-', end - (dash1 + 1) );
+  if (dash2 == 0) {
+    return false;
+  }
+
+  if (dash1 - s == 4) {
+    // ISO: yyyy-mm-dd
+    if (parseDigits( s, dash1, year ) != 4 ||
+        parseDigits( dash1 + 1, dash2, month ) == 0 ||
+        parseDigits( dash2 + 1, end, day ) == 0) {
+      return false;
+    }
+  }
+  else {
+    // Yahoo: d-Mon-yy
+    if (parseDigits( s, dash1, day ) == 0 || dash2 - dash1 != 4) {
+      return false;
+    }
+    char name[3];
+    for (size_t i = 0; i < 3; i++) {
+      const char c = dash1[i + 1];
+      name[i] = (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+    }
+    for (int m = 0; m < 12 && month == 0; m++) {
+      if (memcmp( name, months + (3 * m), 3 ) == 0) {
+        month = m + 1;
+      }
+    }
+    const int yearDigits = parseDigits( dash2 + 1, end, year );
+    if (yearDigits == 2) {
+      year = (year < 50) ? 2000 + year : 1900 + year;
+    }
+    else if (yearDigits != 4) {
+      return false;
+    }
+  }
+  if (month < 1 || month > 12 || day < 1 || day > 31) {
+    return false;
+  }
+  days = civilDays( year, month, day );
+  return true;
+} // parseDate
+
+
+/**
+  Parse a decimal number in [s, end).  The digits are collected in
+  a 64-bit integer, which is divided by a power of ten.  Numbers
+  with an exponent or too many digits are parsed with strtod.
+  Returns false if [s, end) is not a number.
+ */
+bool yahooCSV::parseDouble( const char *s, const char *end, double &v )
+{
+  const char *p = s;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    p++;
+  }
+
+  unsigned long long mantissa = 0;
+  int sigDigits = 0;
+  int fracDigits = 0;
+  bool anyDigits = false;
+  bool dot = false;
+  for (; p < end; p++) {
+    const char c = *p;
+    if (c >= '0' && c <= '9') {
+      anyDigits = true;
+      if (mantissa != 0 || c != '0') {
+        sigDigits++;
+      }
+      mantissa = (mantissa * 10) + (unsigned long long)(c - '0');
+      if (dot) {
+        fracDigits++;
+      }
+    }
+    else if (c == '.' && ! dot) {
+      dot = true;
+    }
+    else {
+      break;
+    }
+    if (sigDigits > maxFastDigits) {
+      break;
+    }
+  }
+
+  if (p == end && anyDigits && fracDigits <= 22) {
+    v = (double)mantissa / pow10Table[ fracDigits ];
+    if (negative) {
+      v = -v;
+    }
+    return true;
+  }
+
+  // an exponent or more digits than fit in a double: use strtod
+  char buf[64];
+  const size_t len = end - s;
+  if (len == 0 || len >= sizeof( buf )) {
+    return false;
+  }
+  memcpy( buf, s, len );
+  buf[len] = '\0';
+  char *endPtr;
+  v = strtod( buf, &endPtr );
+  return (endPtr == buf + len);
+} // parseDouble
+
+
+/**
+  Parse an integer in [s, end).  A value with a fraction is rounded
+  to the nearest integer.  Returns false if [s, end) is not a number.
+ */
+bool yahooCSV::parseInt( const char *s, const char *end, long long &v )
+{
+  const char *p = s;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    p++;
+  }
+  if (p == end || end - p > 18) {
+    double d;
+    if (! parseDouble( s, end, d )) {
+      return false;
+    }
+    v = (long long)((d < 0) ? d - 0.5 : d + 0.5);
+    return true;
+  }
+
+  long long val = 0;
+  for (; p < end; p++) {
+    if (*p < '0' || *p > '9') {
+      double d;
+      if (! parseDouble( s, end, d )) {
+        return false;
+      }
+      v = (long long)((d < 0) ? d - 0.5 : d + 0.5);
+      return true;
+    }
+    val = (val * 10) + (*p - '0');
+  }
+  v = negative ? -val : val;
+  return true;
+} // parseInt
+
+
+/**
+  Handle the separator (comma or newline) at <i>sep</i>.  The field
+  [start, sep) is parsed into the column for field number
+  <i>field</i> of the current line.  At a newline (or at the end of
+  the buffer) the line is checked and added to the columns.  Blank
+  lines are skipped.
+ */
+bool yahooCSV::separator( const char *buf,
+                          const size_t len,
+                          const size_t sep,
+                          size_t &start,
+                          size_t &field,
+                          size_t &lineNum,
+                          const char *path )
+{
+  const bool endOfLine = (sep >= len || buf[sep] == '\n');
+  const char *s = buf + start;
+  const char *e = buf + sep;
+  if (endOfLine && e > s && e[-1] == '\r') {
+    e--;
+  }
+  start = sep + 1;
+
+  bool ok = true;
+  if (endOfLine && field == 0 && e == s) {
+    // a blank line
+  }
+  else if (field == 0) {
+    ok = parseDate( s, e, date_[N_] );
+  }
+  else if (field < numCols) {
+    ok = parseDouble( s, e, cols_[field - 1][N_] );
+  }
+  else if (field == numCols) {
+    ok = parseInt( s, e, volume_[N_] );
+    cols_[numCols - 1][N_] = (double)volume_[N_];
+  }
+  else {
+    ok = false;
+  }
+
+  if (! ok) {
+    fprintf(stderr, "yahooCSV: %s line %u: bad value in field %u\n", 
+            path, (unsigned)lineNum, (unsigned)(field + 1) );
+    return false;
+  }
+
+  field++;
+  if (endOfLine) {
+    if (field == numCols + 1) {
+      N_++;
+    }
+    else if (field != 1 || e != s) {
+      fprintf(stderr, "yahooCSV: %s line %u: %u fields, six expected\n", 
+              path, (unsigned)lineNum, (unsigned)field );
+      return false;
+    }
+    field = 0;
+    lineNum++;
+  }
+  return true;
+} // separator
+
+
+/**
+  Parse the file contents: a title line followed by lines of data.
+  The separators are found sixteen bytes at a time when SSE2 is
+  available.
+ */
+bool yahooCSV::parse( const char *buf, const size_t len, const char *path )
+{
+  const char *title = (const char *)memchr( buf, '\n', len );
+  if (title == 0) {
+    fprintf(stderr, "yahooCSV: %s: title line expected\n", path );
+    return false;
+  }
+  size_t i = (title - buf) + 1;
+  alloc( countLines( buf + i, len - i ) + 1 );
+
+  size_t start = i;
+  size_t field = 0;
+  size_t lineNum = 2;
+  bool ok = true;
+#if defined(YAHOOCSV_SSE2)
+  const __m128i comma = _mm_set1_epi8( ',' );
+  const __m128i newline = _mm_set1_epi8( '\n' );
+  for (; ok && i + 16 <= len; i += 16) {
+    const __m128i c = _mm_loadu_si128( (const __m128i *)(buf + i) );
+    unsigned int mask = (unsigned int)_mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( c, comma ),
+                                                                       _mm_cmpeq_epi8( c, newline ) ) );
+    while (ok && mask != 0) {
+      const size_t sep = i + lowBit( mask );
+      mask = mask & (mask - 1);
+      ok = separator( buf, len, sep, start, field, lineNum, path );
+    }
+  }
+#endif
+  for (; ok && i < len; i++) {
+    if (buf[i] == ',' || buf[i] == '\n') {
+      ok = separator( buf, len, i, start, field, lineNum, path );
+    }
+  }
+  // the last line may not end with a newline
+  if (ok && start < len) {
+    ok = separator( buf, len, len, start, field, lineNum, path );
+  }
+  return ok;
+} // parse
+
+
+/**
+  Put the lines in date order (oldest first), if the file lists the
+  most recent line first.
+ */
+void yahooCSV::reverse()
+{
+  if (N_ > 1 && date_[0] > date_[N_ - 1]) {
+    for (size_t i = 0, j = N_ - 1; i < j; i++, j--) {
+      int d = date_[i];
+      date_[i] = date_[j];
+      date_[j] = d;
+      long long v = volume_[i];
+      volume_[i] = volume_[j];
+      volume_[j] = v;
+      for (size_t c = 0; c < numCols; c++) {
+        double t = cols_[c][i];
+        cols_[c][i] = cols_[c][j];
+        cols_[c][j] = t;
+      }
+    }
+  }
+} // reverse
+
+
+/**
+  Load the Yahoo historical data file <i>path</i>.  Any data that was
+  already loaded is freed.  Returns false if the file cannot be read
+  or is not in the expected format.
+ */
+bool yahooCSV::load( const char *path )
+{
+  clear();
+  bytes_ = 0;
+  seconds_ = 0.0;
+
+  const clock_t startTime = clock();
+  mapfile file;
+  if (! file.open( path )) {
+    return false;
+  }
+  bool ok = parse( (const char *)file.data(), file.length(), path );
+  if (ok) {
+    reverse();
+  }
+  else {
+    clear();
+  }
+  bytes_ = file.length();
+  seconds_ = (double)(clock() - startTime) / CLOCKS_PER_SEC;
+  return ok;
+} // load
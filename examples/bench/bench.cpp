@@ -0,0 +1,648 @@
+
+/** \file
+
+  Benchmarks for the wavelet transforms, the wavelet packet tree
+  and the lossless codec.
+
+  Each operation is timed on fixed inputs (the gen_freqMix and
+  gen_chirp signals from freqtest and the close prices of the
+  equities in the data directory) for N = 2<sup>6</sup> to
+  2<sup>24</sup>.  An operation is repeated until it has run for a
+  minimum time (and at least three times) and the fastest run is
+  reported, as nanoseconds per sample and gigabytes of input per
+  second.  The number of heap allocations (calls to the global
+  operator new) for each call is also reported.
+
+  If the library is compiled with PACKET_PROFILE, the phase counters
+  (see packprofile) for one packet tree are printed for each input
+  and N.
+
+  The results are printed as a table and, with the -json option,
+  written to a JSON file that can be compared with the results of
+  an earlier run.  The JSON file also holds the memory pool
+  statistics (see block_pool::get_pool_stats) for the whole run.
+
+<pre>
+     bench [-min log2N] [-max log2N] [-time seconds] [-json file] [-data dir]
+           [-trace file]
+</pre>
+
+  If the library is compiled with PACKET_TRACE, the -trace option
+  records the packet tree and codec spans (see packtrace) and writes
+  them to a Chrome trace event file.
+
+  The program is linked with the library, the lossless codec (the
+  .cpp files in examples/lossless other than compresstest.cpp) and
+  the equity loader (equitySet, yahooCSV, mapfile and taskpool in
+  data/src).
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxyeng.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "blockpool.h"
+#include "haar.h"
+#include "line.h"
+#include "daub.h"
+#include "packtree.h"
+#include "invpacktree.h"
+#include "packprofile.h"
+#include "packtrace.h"
+#include "costthresh.h"
+#include "costshannon.h"
+#include "costquant.h"
+#include "haar_int.h"
+#include "line_int.h"
+#include "ts_trans_int.h"
+#include "support.h"
+#include "intcodec.h"
+#include "equitySet.h"
+
+
+/*
+  The global new operators count each call in the memory pool
+  statistics (as in local_new.cpp), so the heap allocations of each
+  call and the heap counts written with the pool statistics are
+  taken from the same counters.
+ */
+void *operator new( size_t num_bytes )
+{
+  block_pool::note_heap_alloc( num_bytes );
+  return malloc( num_bytes );
+} // new
+
+
+void *operator new[]( size_t num_bytes )
+{
+  block_pool::note_heap_alloc( num_bytes );
+  return malloc( num_bytes );
+} // new []
+
+
+void operator delete( void *addr )
+{
+  free( addr );
+} // delete
+
+
+void operator delete[]( void *addr )
+{
+  free( addr );
+} // delete []
+
+
+
+/** \function
+  Elapsed (wall clock) time in seconds from an arbitrary starting
+  point
+ */
+static double nowSeconds()
+{
+#if defined(_WIN32)
+  LARGE_INTEGER count, freq;
+  QueryPerformanceCounter( &count );
+  QueryPerformanceFrequency( &freq );
+  return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+#endif
+} // nowSeconds
+
+
+
+/**
+  Time one phase of a benchmark loop.  The fastest call and the
+  heap allocations made by all of the calls are recorded.
+ */
+class phaseTimer
+{
+private:
+  double startTime;
+  size_t startCalls;
+  size_t startBytes;
+
+public:
+  /** the fastest call, in seconds */
+  double best;
+  /** the number of calls */
+  size_t count;
+  /** heap allocations and bytes for all of the calls */
+  size_t allocs;
+  size_t bytes;
+
+  phaseTimer()
+  {
+    best = 0.0;
+    count = 0;
+    allocs = 0;
+    bytes = 0;
+  }
+
+  void start()
+  {
+    block_pool::pool_stats s;
+    block_pool::get_pool_stats( s );
+    startCalls = s.heap_fallbacks;
+    startBytes = s.heap_bytes;
+    startTime = nowSeconds();
+  }
+
+  void stop()
+  {
+    const double t = nowSeconds() - startTime;
+    if (count == 0 || t < best) {
+      best = t;
+    }
+    count++;
+    block_pool::pool_stats s;
+    block_pool::get_pool_stats( s );
+    allocs += s.heap_fallbacks - startCalls;
+    bytes += s.heap_bytes - startBytes;
+  }
+}; // phaseTimer
+
+
+
+/** the result of one benchmark */
+typedef struct {
+  const char *input;
+  const char *op;
+  const char *kernel;
+  size_t N;
+  size_t elemSize;
+  size_t iterations;
+  double seconds;
+  double allocs;
+  double allocBytes;
+} benchResult;
+
+
+/** the results, and the minimum time for each benchmark loop */
+static benchResult *results = 0;
+static size_t numResults = 0;
+static size_t maxResults = 0;
+static double minSeconds = 0.05;
+
+/** every loop runs at least this many times */
+static const size_t minIterations = 3;
+
+
+/** \function
+  Record the result of a phase
+ */
+static void addResult( const char *input,
+                       const char *op,
+                       const char *kernel,
+                       const size_t N,
+                       const size_t elemSize,
+                       const phaseTimer &timer )
+{
+  if (numResults == maxResults) {
+    maxResults = (maxResults > 0) ? maxResults * 2 : 256;
+    benchResult *newResults = (benchResult *)malloc( maxResults * sizeof( benchResult ) );
+    if (numResults > 0) {
+      memcpy( newResults, results, numResults * sizeof( benchResult ) );
+    }
+    free( results );
+    results = newResults;
+  }
+  benchResult *r = &results[ numResults++ ];
+  r->input = input;
+  r->op = op;
+  r->kernel = kernel;
+  r->N = N;
+  r->elemSize = elemSize;
+  r->iterations = timer.count;
+  r->seconds = timer.best;
+  r->allocs = (timer.count > 0) ? (double)timer.allocs / (double)timer.count : 0.0;
+  r->allocBytes = (timer.count > 0) ? (double)timer.bytes / (double)timer.count : 0.0;
+
+  const double ns = (timer.best * 1e9) / (double)N;
+  const double gbs = (timer.best > 0) ? ((double)(N * elemSize) / timer.best) * 1e-9 : 0.0;
+  printf("%-8s %-14s %-12s %9lu  %10.3f  %8.3f  %8.1f\n",
+         input, op, kernel, (unsigned long)N, ns, gbs, r->allocs );
+} // addResult
+
+
+/** \function
+  Return true if a benchmark loop that started at <i>startTime</i>
+  should run again
+ */
+static bool more( const size_t iter, const double startTime )
+{
+  return (iter < minIterations || (nowSeconds() - startTime) < minSeconds);
+} // more
+
+
+
+/** \function
+  Time the forward and inverse transform of the wavelet <i>w</i>.
+  The inverse transform restores the data, so the forward transform
+  is always applied to the same values.
+ */
+template <class T_elem>
+void wave_bench( liftbase<T_elem *, T_elem> &w,
+                 const char *kernel,
+                 const char *input,
+                 const T_elem *signal,
+                 const size_t N )
+{
+  T_elem *vec = new T_elem[ N ];
+  memcpy( vec, signal, N * sizeof( T_elem ) );
+
+  phaseTimer forward, inverse;
+  const double startTime = nowSeconds();
+  for (size_t iter = 0; more( iter, startTime ); iter++) {
+    forward.start();
+    w.forwardTrans( vec, (int)N );
+    forward.stop();
+    inverse.start();
+    w.inverseTrans( vec, (int)N );
+    inverse.stop();
+  }
+  addResult( input, "forward", kernel, N, sizeof( T_elem ), forward );
+  addResult( input, "inverse", kernel, N, sizeof( T_elem ), inverse );
+
+  delete [] vec;
+} // wave_bench
+
+
+
+/** \function
+  Time the phases of the wavelet packet pipeline with the line
+  wavelet: building the tree, each of the cost functions, the best
+  basis (including the packbasis descriptor) and the inverse
+  transform.  The memory pool is freed after each pass.  Nothing is
+  recorded if the memory for the tree cannot be allocated.
+ */
+void packet_bench( const char *input,
+                   const double *signal,
+                   const size_t N )
+{
+  line<packcontainer> w;
+  block_pool mem_pool;
+  phaseTimer build, thresh, quant, shannon, best, inverse;
+
+  const double startTime = nowSeconds();
+  for (size_t iter = 0; more( iter, startTime ); iter++) {
+    build.start();
+    packtree tree( signal, N, &w );
+    build.stop();
+    if (! tree.ok()) {
+      printf("bench: the packet tree for %s (N = %lu) could not be allocated\n",
+             input, (unsigned long)N );
+      mem_pool.free_pool();
+      return;
+    }
+
+    packnode<double> *root = tree.getRoot();
+    thresh.start();
+    costthresh threshCost( root, 0.5 );
+    thresh.stop();
+
+    quant.start();
+    costquant quantCost( root, 0.01 );
+    quant.stop();
+
+    // the Shannon cost is calculated last, so it is the cost used
+    // by the best basis
+    shannon.start();
+    costshannon shannonCost( root );
+    shannon.stop();
+
+    best.start();
+    tree.bestBasis();
+    packbasis<double> basis = tree.getBestBasis();
+    best.stop();
+
+    inverse.start();
+    invpacktree inv( basis, &w );
+    inverse.stop();
+
+    if (iter == 0 && packprofile::enabled()) {
+      packprofile::stats treeStats;
+      packprofile::stats invStats;
+      tree.getStats( treeStats );
+      inv.getStats( invStats );
+      packprofile::add( treeStats, invStats );
+      printf("packet profile: %s, N = %lu\n", input, (unsigned long)N );
+      packprofile::pr( treeStats );
+    }
+
+    mem_pool.free_pool();
+  }
+  addResult( input, "packet build", "line", N, sizeof( double ), build );
+  addResult( input, "cost", "thresh", N, sizeof( double ), thresh );
+  addResult( input, "cost", "quant", N, sizeof( double ), quant );
+  addResult( input, "cost", "shannon", N, sizeof( double ), shannon );
+  addResult( input, "best basis", "line", N, sizeof( double ), best );
+  addResult( input, "packet inverse", "line", N, sizeof( double ), inverse );
+} // packet_bench
+
+
+
+/** \function
+  Time the lossless codec (encode and decode) with the Line and
+  Packet transforms.  The decoded data is checked once.
+ */
+void codec_bench( const char *input,
+                  const int *signal,
+                  const size_t N )
+{
+  const size_t bufLen = intcodec::maxBytes( N );
+  unsigned char *buf = new unsigned char[ bufLen ];
+  int *out = new int[ N ];
+  const intcodec::codecKind kinds[] = { intcodec::Line, intcodec::Packet };
+  const char *names[] = { "Line", "Packet" };
+
+  for (size_t k = 0; k < 2; k++) {
+    phaseTimer encode, decode;
+    bool ok = true;
+    const double startTime = nowSeconds();
+    for (size_t iter = 0; ok && more( iter, startTime ); iter++) {
+      encode.start();
+      const size_t len = intcodec::encode( signal, N, kinds[k], buf, bufLen );
+      encode.stop();
+      decode.start();
+      ok = intcodec::decode( buf, len, out, N );
+      decode.stop();
+      if (ok && iter == 0) {
+        ok = (memcmp( out, signal, N * sizeof( int ) ) == 0);
+      }
+    }
+    if (! ok) {
+      printf("codec_bench: %s codec failed for %s, N = %lu\n", 
+             names[k], input, (unsigned long)N );
+    }
+    else {
+      addResult( input, "encode", names[k], N, sizeof( int ), encode );
+      addResult( input, "decode", names[k], N, sizeof( int ), decode );
+    }
+  }
+
+  delete [] out;
+  delete [] buf;
+} // codec_bench
+
+
+
+/** \function
+  Generate a signal composed of a sum of sine waves (the same
+  signal as in freqtest).
+ */
+void gen_freqMix( double *vecY, size_t N )
+{
+  const double PI = 3.1415926535897932384626433832795;
+  const double range = 2 * PI;
+  const double incr = range / (double)N;
+
+  double point = 0.0;
+  for (size_t i = 0; i < N; i++) {
+    vecY[i] = 4 * sin( 64 * point ) + 
+              2 * sin( 32 * point ) + 
+              1 * sin( 16 * point ) +
+            0.5 * sin( 8  * point );
+    point = point + incr;
+  }
+} // gen_freqMix
+
+
+/** \function
+  Generate a linear chirp signal (the same signal as in freqtest)
+ */
+void gen_chirp( double *vecY, size_t N )
+{
+  const double PI = 3.1415926535897932384626433832795;
+  const double range = 2;
+  const double incr = range / (double)N;
+
+  double point = 0.0;
+  for (size_t i = 0; i < N; i++) {
+    vecY[i] = sin( 128 * PI * point * point );
+    point = point + incr;
+  }
+} // gen_chirp
+
+
+/** \function
+  Fill <i>vec</i> with N values of the equity close prices, one
+  equity after the other, starting again at the beginning if N is
+  longer than all of the equities together.
+ */
+void gen_equities( const equitySet &dataSet, double *vec, size_t N )
+{
+  size_t i = 0;
+  while (i < N) {
+    for (size_t s = 0; s < dataSet.numSymbols() && i < N; s++) {
+      const double *row = dataSet.row( s );
+      for (size_t d = dataSet.first( s ); d < dataSet.numDates() && i < N; d++) {
+        vec[i++] = row[d];
+      }
+    }
+  }
+} // gen_equities
+
+
+
+/** \function
+  Write the results as JSON
+ */
+bool writeJSON( const char *path )
+{
+  FILE *fp = fopen( path, "w" );
+  if (fp == 0) {
+    printf("bench: could not open %s for writing\n", path );
+    return false;
+  }
+  fprintf(fp, "{\n");
+  fprintf(fp, "  \"benchmark\": \"libpacket\",\n");
+  fprintf(fp, "  \"min_seconds\": %g,\n", minSeconds );
+  fprintf(fp, "  \"pool\": ");
+  block_pool::write_pool_stats( fp );
+  fprintf(fp, ",\n");
+  fprintf(fp, "  \"results\": [\n");
+  for (size_t i = 0; i < numResults; i++) {
+    const benchResult *r = &results[i];
+    const double ns = (r->seconds * 1e9) / (double)r->N;
+    const double gbs = (r->seconds > 0) ? ((double)(r->N * r->elemSize) / r->seconds) * 1e-9 : 0.0;
+    fprintf(fp, "    { \"input\": \"%s\", \"op\": \"%s\", \"kernel\": \"%s\", "
+            "\"N\": %lu, \"iterations\": %lu, \"ns_per_sample\": %.4f, "
+            "\"gb_per_sec\": %.4f, \"allocs_per_call\": %.2f, "
+            "\"alloc_bytes_per_call\": %.1f }%s\n",
+            r->input, r->op, r->kernel, (unsigned long)r->N, 
+            (unsigned long)r->iterations, ns, gbs, r->allocs, r->allocBytes,
+            (i + 1 < numResults) ? "," : "" );
+  }
+  fprintf(fp, "  ]\n");
+  fprintf(fp, "}\n");
+  fclose( fp );
+  return true;
+} // writeJSON
+
+
+
+/** \function
+  Run the benchmarks
+ */
+int main( int argc, char *argv[] )
+{
+  size_t minLog = 6;
+  size_t maxLog = 24;
+  const char *jsonPath = 0;
+  const char *tracePath = 0;
+  const char *dataDir = "../data/equities/";
+
+  for (int i = 1; i < argc; i++) {
+    if (i + 1 < argc && strcmp( argv[i], "-min" ) == 0) {
+      minLog = (size_t)atoi( argv[++i] );
+    }
+    else if (i + 1 < argc && strcmp( argv[i], "-max" ) == 0) {
+      maxLog = (size_t)atoi( argv[++i] );
+    }
+    else if (i + 1 < argc && strcmp( argv[i], "-time" ) == 0) {
+      minSeconds = atof( argv[++i] );
+    }
+    else if (i + 1 < argc && strcmp( argv[i], "-json" ) == 0) {
+      jsonPath = argv[++i];
+    }
+    else if (i + 1 < argc && strcmp( argv[i], "-data" ) == 0) {
+      dataDir = argv[++i];
+    }
+    else if (i + 1 < argc && strcmp( argv[i], "-trace" ) == 0) {
+      tracePath = argv[++i];
+    }
+    else {
+      printf("usage: bench [-min log2N] [-max log2N] [-time seconds] [-json file] [-data dir] [-trace file]\n");
+      return 1;
+    }
+  }
+  if (minLog < 1 || maxLog > 30 || minLog > maxLog) {
+    printf("bench: log2N must be between 1 and 30\n");
+    return 1;
+  }
+
+  // A full packet tree of N doubles holds (log2(N) + 1) * N doubles
+  // and 2N nodes, so the packet tree benchmarks are limited to
+  // N <= 2^22 (about 1.2 Gb of memory pool).
+  const size_t maxPacketN = (size_t)1 << 22;
+
+  equitySet dataSet;
+  const bool haveEquities = dataSet.load( dataDir, yahooTS::Close );
+  if (! haveEquities) {
+    printf("bench: no equity data in %s, the equities input is skipped\n", dataDir );
+  }
+
+  if (tracePath != 0) {
+    if (packtrace::compiled()) {
+      packtrace::enable();
+    }
+    else {
+      printf("bench: the library was not compiled with PACKET_TRACE, no trace is written\n");
+      tracePath = 0;
+    }
+  }
+
+  const char *inputs[] = { "freqMix", "chirp", "equities" };
+  const size_t numInputs = haveEquities ? 3 : 2;
+
+  printf("packet tree benchmarks are limited to N <= %lu by the size of the tree\n\n",
+         (unsigned long)maxPacketN );
+  printf("input    operation      kernel               N  ns/sample      GB/s    allocs\n");
+
+  for (size_t log = minLog; log <= maxLog; log++) {
+    const size_t N = (size_t)1 << log;
+    double *signal = new double[ N ];
+    int *intSignal = new int[ N ];
+
+    for (size_t in = 0; in < numInputs; in++) {
+      if (in == 0) {
+        gen_freqMix( signal, N );
+      }
+      else if (in == 1) {
+        gen_chirp( signal, N );
+      }
+      else {
+        gen_equities( dataSet, signal, N );
+      }
+      support::decimalToInt( intSignal, signal, N );
+
+      haar<double *> haarW;
+      line<double *> lineW;
+      Daubechies<double *> daubW;
+      wave_bench( haarW, "haar", inputs[in], (const double *)signal, N );
+      wave_bench( lineW, "line", inputs[in], (const double *)signal, N );
+      wave_bench( daubW, "daub", inputs[in], (const double *)signal, N );
+
+      haar_int haarInt;
+      line_int<int *> lineInt;
+      ts_trans_int tsInt;
+      wave_bench( haarInt, "haar_int", inputs[in], (const int *)intSignal, N );
+      wave_bench( lineInt, "line_int", inputs[in], (const int *)intSignal, N );
+      wave_bench( tsInt, "ts_int", inputs[in], (const int *)intSignal, N );
+
+      if (N <= maxPacketN) {
+        packet_bench( inputs[in], signal, N );
+      }
+
+      codec_bench( inputs[in], intSignal, N );
+    }
+
+    delete [] intSignal;
+    delete [] signal;
+  }
+
+  if (jsonPath != 0) {
+    writeJSON( jsonPath );
+  }
+  if (tracePath != 0) {
+    packtrace::disable();
+    if (packtrace::numDropped() > 0) {
+      printf("bench: %lu trace spans did not fit in the trace buffer\n",
+             (unsigned long)packtrace::numDropped() );
+    }
+    packtrace::write( tracePath );
+    packtrace::clear();
+  }
+  free( results );
+  return 0;
+}
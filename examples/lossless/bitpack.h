@@ -0,0 +1,415 @@
+
+#ifndef _BITPACK_H_
+#define _BITPACK_H_
+
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+/**
+  Frame of reference bit packing for integer vectors.
+
+  The support::vecWidth function estimates the number of bits needed
+  to represent a vector.  The functions in this class actually store
+  the vector in that number of bits.  A vector of integers is stored
+  as a reference value (the minimum of the vector) and the difference
+  between each element and the reference.  The differences are
+  unsigned and are stored in fields of <i>width</i> bits, where
+  <i>width</i> is the number of bits in the largest difference
+  ("frame of reference" coding).  The reference value itself is
+  stored as a zig-zag encoded variable length integer, so small
+  negative and positive references take one byte.
+
+  The packed bits are stored in 32-bit words.  Elements are packed
+  in blocks of <tt>blockLen</tt> (256) values.  Inside a block,
+  element <i>i</i> belongs to "lane" <i>i</i> % 8 and the eight lanes
+  are packed side by side: word <i>k</i> of lane <i>l</i> is stored in
+  word 8<i>k</i> + <i>l</i> of the block.  With this layout eight
+  consecutive elements are always at the same bit offset in eight
+  consecutive words, so an AVX2 unpack calculates eight elements with
+  one load, two shifts, a mask and an add.  The elements after the
+  last full block are packed one after the other into bytes (low
+  order bits first), so a short vector is not rounded up to a whole
+  word.
+
+  The scalar functions are the reference version.  When the code is
+  compiled for AVX2 (__AVX2__ is defined) full blocks are packed and
+  unpacked eight values at a time.  Both versions produce and read
+  the same bytes.  Words are stored in the byte order of the
+  processor (little endian on the x86).  The words follow the width
+  byte and the reference, so they are not aligned: the scalar
+  functions read and write them with memcpy (see getWord and putWord)
+  and the AVX2 functions use unaligned loads and stores.
+
+  All of the functions are static.  The constructor and destructor
+  are declared but not defined, as in the <tt>support</tt> class.
+ */
+class bitpack
+{
+public:
+  /** declare but do not define the constructor */
+  bitpack();
+  /** declare but do not define the destructor */
+  ~bitpack();
+
+  typedef enum { lanes = 8,
+                 blockLen = 256,
+                 maxVarintBytes = 5 } bogus;
+
+  /** zig-zag encoding: 0, -1, 1, -2, 2 ... map to 0, 1, 2, 3, 4 ... */
+  static unsigned int zigzag( const int v )
+  {
+    return ((unsigned int)v << 1) ^ (unsigned int)(v >> 31);
+  }
+
+  /** inverse of zigzag */
+  static int unzigzag( const unsigned int u )
+  {
+    return (int)(u >> 1) ^ -(int)(u & 1);
+  }
+
+  /** number of bits needed for the unsigned value <i>v</i> (0..32) */
+  static unsigned int bitWidth( unsigned int v )
+  {
+    unsigned int width = 0;
+    while (v != 0) {
+      width++;
+      v = v >> 1;
+    }
+    return width;
+  }
+
+  /** a mask with the low <i>width</i> bits set */
+  static unsigned int mask( const unsigned int width )
+  {
+    return (width >= 32) ? 0xffffffff : ((1u << width) - 1);
+  }
+
+  /**
+    Write <i>v</i> as a variable length integer (seven bits per byte,
+    low order bits first).  Returns the number of bytes written.
+  */
+  static size_t putVarint( unsigned char *buf, unsigned int v )
+  {
+    size_t n = 0;
+    while (v >= 0x80) {
+      buf[n++] = (unsigned char)(v | 0x80);
+      v = v >> 7;
+    }
+    buf[n++] = (unsigned char)v;
+    return n;
+  }
+
+  /**
+    Read a variable length integer.  Returns the number of bytes
+    read, or zero if the integer does not end in <i>len</i> bytes.
+   */
+  static size_t getVarint( const unsigned char *buf, const size_t len, unsigned int &v )
+  {
+    v = 0;
+    for (size_t n = 0; n < len && n < maxVarintBytes; n++) {
+      v = v | ((unsigned int)(buf[n] & 0x7f) << (7 * n));
+      if ((buf[n] & 0x80) == 0) {
+        return n + 1;
+      }
+    }
+    return 0;
+  }
+
+  /** read word <i>i</i> of <i>words</i> (no alignment is required) */
+  static unsigned int getWord( const unsigned char *words, const size_t i )
+  {
+    unsigned int w;
+    memcpy( &w, words + (i * sizeof( unsigned int )), sizeof( unsigned int ) );
+    return w;
+  }
+
+  /** write word <i>i</i> of <i>words</i> (no alignment is required) */
+  static void putWord( unsigned char *words, const size_t i, const unsigned int w )
+  {
+    memcpy( words + (i * sizeof( unsigned int )), &w, sizeof( unsigned int ) );
+  }
+
+  /** number of bytes used to pack <i>n</i> values of <i>width</i> bits */
+  static size_t packedBytes( const size_t n, const unsigned int width )
+  {
+    const size_t blocks = n / blockLen;
+    const size_t tail = n - (blocks * blockLen);
+    return (blocks * lanes * width * sizeof( unsigned int )) + (((tail * width) + 7) >> 3);
+  }
+
+  /**
+    Find the reference (minimum) value of a vector and the width
+    of the largest difference from the reference.
+   */
+  static void frame( const int *vec, const size_t n, int &ref, unsigned int &width )
+  {
+    int minVal = 0;
+    int maxVal = 0;
+    if (n > 0) {
+      minVal = vec[0];
+      maxVal = vec[0];
+      for (size_t i = 1; i < n; i++) {
+        minVal = (vec[i] < minVal) ? vec[i] : minVal;
+        maxVal = (vec[i] > maxVal) ? vec[i] : maxVal;
+      }
+    }
+    ref = minVal;
+    width = bitWidth( (unsigned int)maxVal - (unsigned int)minVal );
+  }
+
+  /**
+    Size, in bytes, of a vector stored with pack(): the width byte,
+    the reference and the packed values.
+   */
+  static size_t frameBytes( const int *vec, const size_t n )
+  {
+    int ref;
+    unsigned int width;
+    unsigned char tmp[ maxVarintBytes ];
+
+    frame( vec, n, ref, width );
+    return 1 + putVarint( tmp, zigzag( ref ) ) + packedBytes( n, width );
+  }
+
+  /**
+    Store the <i>n</i> values in <i>vec</i> in <i>buf</i>: a width
+    byte, the zig-zag encoded reference and the packed differences.
+    The buffer must have room for frameBytes( vec, n ) bytes.  Returns
+    the number of bytes written.
+   */
+  static size_t pack( const int *vec, const size_t n, unsigned char *buf )
+  {
+    int ref;
+    unsigned int width;
+
+    frame( vec, n, ref, width );
+    size_t len = 0;
+    buf[len++] = (unsigned char)width;
+    len += putVarint( buf + len, zigzag( ref ) );
+
+    const size_t numBytes = packedBytes( n, width );
+    if (width > 0) {
+      unsigned char *words = buf + len;
+      const size_t blockBytes = lanes * width * sizeof( unsigned int );
+      memset( words, 0, numBytes );
+      const size_t blocks = n / blockLen;
+      for (size_t b = 0; b < blocks; b++) {
+        packBlock( vec + (b * blockLen), ref, width, words + (b * blockBytes) );
+      }
+      packTail( vec + (blocks * blockLen),
+                n - (blocks * blockLen),
+                ref,
+                width,
+                words + (blocks * blockBytes) );
+    }
+    return len + numBytes;
+  } // pack
+
+  /**
+    Unpack <i>n</i> values that were stored by pack() into
+    <i>vec</i>.  Returns the number of bytes read or zero if the
+    data in <i>buf</i> is too short or is not valid.
+   */
+  static size_t unpack( const unsigned char *buf, const size_t len, int *vec, const size_t n )
+  {
+    if (len < 1 || buf[0] > 32) {
+      return 0;
+    }
+    const unsigned int width = buf[0];
+    unsigned int zref;
+    size_t refLen = getVarint( buf + 1, len - 1, zref );
+    if (refLen == 0) {
+      return 0;
+    }
+    const int ref = unzigzag( zref );
+    const size_t start = 1 + refLen;
+    const size_t numBytes = packedBytes( n, width );
+    if (numBytes > len - start) {
+      return 0;
+    }
+
+    if (width == 0) {
+      for (size_t i = 0; i < n; i++) {
+        vec[i] = ref;
+      }
+    }
+    else {
+      const unsigned char *words = buf + start;
+      const size_t blockBytes = lanes * width * sizeof( unsigned int );
+      const size_t blocks = n / blockLen;
+      for (size_t b = 0; b < blocks; b++) {
+        unpackBlock( words + (b * blockBytes), ref, width, vec + (b * blockLen) );
+      }
+      unpackTail( words + (blocks * blockBytes),
+                  ref,
+                  width,
+                  vec + (blocks * blockLen),
+                  n - (blocks * blockLen) );
+    }
+    return start + numBytes;
+  } // unpack
+
+private:
+  /** pack one block of blockLen values (lane layout) */
+  static void packBlock( const int *vec,
+                         const int ref,
+                         const unsigned int width,
+                         unsigned char *words )
+  {
+#if defined(__AVX2__)
+    const __m256i vref = _mm256_set1_epi32( ref );
+    for (unsigned int j = 0; j < blockLen / lanes; j++) {
+      const unsigned int bit = j * width;
+      const unsigned int k = bit >> 5;
+      const unsigned int off = bit & 31;
+      __m256i v = _mm256_sub_epi32( _mm256_loadu_si256( (const __m256i *)(vec + (j * lanes)) ), vref );
+      __m256i *w = (__m256i *)(words + (k * lanes * sizeof( unsigned int )));
+      __m256i cur = _mm256_loadu_si256( w );
+      cur = _mm256_or_si256( cur, _mm256_sll_epi32( v, _mm_cvtsi32_si128( off ) ) );
+      _mm256_storeu_si256( w, cur );
+      if (off + width > 32) {
+        _mm256_storeu_si256( w + 1, _mm256_srl_epi32( v, _mm_cvtsi32_si128( 32 - off ) ) );
+      }
+    }
+#else
+    for (unsigned int j = 0; j < blockLen / lanes; j++) {
+      const unsigned int bit = j * width;
+      const unsigned int k = bit >> 5;
+      const unsigned int off = bit & 31;
+      for (unsigned int l = 0; l < lanes; l++) {
+        unsigned int v = (unsigned int)vec[(j * lanes) + l] - (unsigned int)ref;
+        putWord( words, (k * lanes) + l, getWord( words, (k * lanes) + l ) | (v << off) );
+        if (off + width > 32) {
+          putWord( words, ((k + 1) * lanes) + l, v >> (32 - off) );
+        }
+      }
+    }
+#endif
+  } // packBlock
+
+  /** unpack one block of blockLen values */
+  static void unpackBlock( const unsigned char *words,
+                           const int ref,
+                           const unsigned int width,
+                           int *vec )
+  {
+#if defined(__AVX2__)
+    const __m256i vref = _mm256_set1_epi32( ref );
+    const __m256i vmask = _mm256_set1_epi32( (int)mask( width ) );
+    for (unsigned int j = 0; j < blockLen / lanes; j++) {
+      const unsigned int bit = j * width;
+      const unsigned int k = bit >> 5;
+      const unsigned int off = bit & 31;
+      const __m256i *w = (const __m256i *)(words + (k * lanes * sizeof( unsigned int )));
+      __m256i v = _mm256_srl_epi32( _mm256_loadu_si256( w ), _mm_cvtsi32_si128( off ) );
+      if (off + width > 32) {
+        v = _mm256_or_si256( v, _mm256_sll_epi32( _mm256_loadu_si256( w + 1 ),
+                                                  _mm_cvtsi32_si128( 32 - off ) ) );
+      }
+      v = _mm256_add_epi32( _mm256_and_si256( v, vmask ), vref );
+      _mm256_storeu_si256( (__m256i *)(vec + (j * lanes)), v );
+    }
+#else
+    const unsigned int m = mask( width );
+    for (unsigned int j = 0; j < blockLen / lanes; j++) {
+      const unsigned int bit = j * width;
+      const unsigned int k = bit >> 5;
+      const unsigned int off = bit & 31;
+      for (unsigned int l = 0; l < lanes; l++) {
+        unsigned int v = getWord( words, (k * lanes) + l ) >> off;
+        if (off + width > 32) {
+          v = v | (getWord( words, ((k + 1) * lanes) + l ) << (32 - off));
+        }
+        vec[(j * lanes) + l] = (int)((v & m) + (unsigned int)ref);
+      }
+    }
+#endif
+  } // unpackBlock
+
+  /** pack the values after the last full block into bytes */
+  static void packTail( const int *vec,
+                        const size_t n,
+                        const int ref,
+                        const unsigned int width,
+                        unsigned char *bytes )
+  {
+    unsigned long long acc = 0;
+    unsigned int bits = 0;
+    size_t pos = 0;
+    for (size_t i = 0; i < n; i++) {
+      const unsigned int v = (unsigned int)vec[i] - (unsigned int)ref;
+      acc = acc | ((unsigned long long)v << bits);
+      bits = bits + width;
+      while (bits >= 8) {
+        bytes[pos++] = (unsigned char)acc;
+        acc = acc >> 8;
+        bits = bits - 8;
+      }
+    }
+    if (bits > 0) {
+      bytes[pos] = (unsigned char)acc;
+    }
+  } // packTail
+
+  /** unpack the values after the last full block */
+  static void unpackTail( const unsigned char *bytes,
+                          const int ref,
+                          const unsigned int width,
+                          int *vec,
+                          const size_t n )
+  {
+    const unsigned int m = mask( width );
+    unsigned long long acc = 0;
+    unsigned int bits = 0;
+    size_t pos = 0;
+    for (size_t i = 0; i < n; i++) {
+      while (bits < width) {
+        acc = acc | ((unsigned long long)bytes[pos++] << bits);
+        bits = bits + 8;
+      }
+      vec[i] = (int)(((unsigned int)acc & m) + (unsigned int)ref);
+      acc = acc >> width;
+      bits = bits - width;
+    }
+  } // unpackTail
+
+}; // bitpack
+
+#endif
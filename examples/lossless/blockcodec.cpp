@@ -0,0 +1,276 @@
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "blockcodec.h"
+#include "bitpack.h"
+
+
+/** write a 32-bit value, low order byte first */
+static void put32( unsigned char *buf, const size_t val )
+{
+  buf[0] = (unsigned char)(val & 0xff);
+  buf[1] = (unsigned char)((val >> 8) & 0xff);
+  buf[2] = (unsigned char)((val >> 16) & 0xff);
+  buf[3] = (unsigned char)((val >> 24) & 0xff);
+} // put32
+
+
+/** read a 32-bit value, low order byte first */
+static size_t get32( const unsigned char *buf )
+{
+  return (size_t)buf[0] | ((size_t)buf[1] << 8) |
+         ((size_t)buf[2] << 16) | ((size_t)buf[3] << 24);
+} // get32
+
+
+/**
+  The number of values in block <i>b</i>
+ */
+size_t blockcodec::blockLength( const size_t b,
+                                const size_t N,
+                                const size_t blockLen )
+{
+  const size_t start = b * blockLen;
+  return (N - start < blockLen) ? N - start : blockLen;
+} // blockLength
+
+
+/**
+  An upper bound on the size of the encoding of N values in blocks
+  of <i>blockLen</i> values.  This is the size of the buffer that
+  should be passed to encode.
+ */
+size_t blockcodec::maxBytes( const size_t N, const size_t blockLen )
+{
+  size_t len = headerBytes;
+  if (blockLen > 0) {
+    const size_t numBlocks = (N + blockLen - 1) / blockLen;
+    len = len + (numBlocks * (1 + bitpack::maxVarintBytes + intcodec::maxBlockBytes( blockLen )));
+  }
+  return len;
+} // maxBytes
+
+
+/**
+  Encode <i>N</i> values in blocks of <i>blockLen</i> values.  Each
+  block is encoded with the transform <i>kind</i>, or with the
+  transform that gives the smallest result if <i>kind</i> is
+  <tt>intcodec::Smallest</tt>.  The result is written to
+  <i>buf</i>, which must have room for maxBytes( N, blockLen )
+  bytes.  If <i>entropy</i> is true the subbands of each block are
+  entropy coded (see rans).  If <i>kindCount</i> is not null,
+  element k is set to the number of blocks that were encoded with
+  transform kind k (the array must have intcodec::Smallest
+  elements).  Returns the number of bytes written or zero if there
+  is an error.
+ */
+size_t blockcodec::encode( const int *vec,
+                           const size_t N,
+                           const size_t blockLen,
+                           const intcodec::codecKind kind,
+                           unsigned char *buf,
+                           const size_t bufLen,
+                           const bool entropy,
+                           size_t *kindCount )
+{
+  if (vec == 0 || buf == 0 || N == 0) {
+    printf("blockcodec::encode: no data\n");
+    return 0;
+  }
+  if (blockLen < 2 || (blockLen & (blockLen - 1)) != 0) {
+    printf("blockcodec::encode: the block length must be a power of two\n");
+    return 0;
+  }
+  if (kind <= intcodec::BadKind || kind > intcodec::Smallest) {
+    printf("blockcodec::encode: bad transform kind\n");
+    return 0;
+  }
+  if (bufLen < maxBytes( N, blockLen )) {
+    printf("blockcodec::encode: the buffer is too small\n");
+    return 0;
+  }
+
+  const int numBlocks = (int)((N + blockLen - 1) / blockLen);
+  const size_t maxBlock = intcodec::maxBlockBytes( blockLen );
+  unsigned char *scratch = new unsigned char[ numBlocks * maxBlock ];
+  size_t *bodyLen = new size_t[ numBlocks ];
+  intcodec::codecKind *blockKind = new intcodec::codecKind[ numBlocks ];
+
+  // each block is encoded into its own region of the scratch buffer
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int b = 0; b < numBlocks; b++) {
+    const size_t n = blockLength( b, N, blockLen );
+    // a short block is not a power of two: only delta applies
+    intcodec::codecKind k = kind;
+    if (n < blockLen && kind != intcodec::Smallest) {
+      k = intcodec::Delta;
+    }
+    bodyLen[b] = intcodec::encodeBlock( vec + (b * blockLen), n, k,
+                                        scratch + (b * maxBlock), maxBlock, entropy );
+    blockKind[b] = k;
+  }
+
+  buf[0] = 'K';
+  buf[1] = 'P';
+  buf[2] = 'L';
+  buf[3] = 'B';
+  buf[4] = 1;
+  buf[5] = (unsigned char)(entropy ? intcodec::entropyFlag : 0);
+  buf[6] = 0;
+  buf[7] = 0;
+  put32( buf + 8, blockLen );
+  put32( buf + 12, N );
+  put32( buf + 16, numBlocks );
+  size_t len = headerBytes;
+
+  if (kindCount != 0) {
+    for (size_t k = 0; k < intcodec::Smallest; k++) {
+      kindCount[k] = 0;
+    }
+  }
+
+  for (int b = 0; b < numBlocks; b++) {
+    if (bodyLen[b] == 0) {
+      printf("blockcodec::encode: block %d could not be encoded\n", b );
+      len = 0;
+      break;
+    }
+    buf[len++] = (unsigned char)blockKind[b];
+    len += bitpack::putVarint( buf + len, (unsigned int)bodyLen[b] );
+    memcpy( buf + len, scratch + (b * maxBlock), bodyLen[b] );
+    len = len + bodyLen[b];
+    if (kindCount != 0) {
+      kindCount[ blockKind[b] ]++;
+    }
+  }
+
+  delete [] blockKind;
+  delete [] bodyLen;
+  delete [] scratch;
+  return len;
+} // encode
+
+
+/**
+  Return the number of values in an encoded buffer, or zero if the
+  buffer does not start with a valid header.
+ */
+size_t blockcodec::decodedLength( const unsigned char *buf, const size_t len )
+{
+  size_t N = 0;
+  if (buf != 0 && len >= headerBytes &&
+      buf[0] == 'K' && buf[1] == 'P' && buf[2] == 'L' && buf[3] == 'B' &&
+      buf[4] == 1) {
+    N = get32( buf + 12 );
+  }
+  return N;
+} // decodedLength
+
+
+/**
+  Decode the bytes produced by encode.  <i>vec</i> must have room
+  for <i>N</i> values, where N is the value returned by
+  decodedLength.  The block boundaries are found with a scan of the
+  block tags and lengths and then the blocks are decoded (in
+  parallel when OpenMP is enabled, see blockcodec).  Returns false
+  if the bytes are not a valid encoding.
+ */
+bool blockcodec::decode( const unsigned char *buf,
+                         const size_t len,
+                         int *vec,
+                         const size_t N )
+{
+  if (vec == 0 || N == 0 || decodedLength( buf, len ) != N) {
+    printf("blockcodec::decode: bad header\n");
+    return false;
+  }
+  const size_t blockLen = get32( buf + 8 );
+  const int numBlocks = (int)get32( buf + 16 );
+  if (blockLen == 0 || (size_t)numBlocks != (N + blockLen - 1) / blockLen) {
+    printf("blockcodec::decode: bad header\n");
+    return false;
+  }
+
+  const bool entropy = (buf[5] & intcodec::entropyFlag) != 0;
+  size_t *offset = new size_t[ numBlocks ];
+  size_t *bodyLen = new size_t[ numBlocks ];
+  intcodec::codecKind *blockKind = new intcodec::codecKind[ numBlocks ];
+  bool ok = true;
+
+  // find the transform kind, start and length of each block body
+  size_t pos = headerBytes;
+  for (int b = 0; ok && b < numBlocks; b++) {
+    unsigned int n = 0;
+    const size_t varLen = (pos < len) ? bitpack::getVarint( buf + pos + 1, len - pos - 1, n ) : 0;
+    if (varLen == 0 || n > len - pos - 1 - varLen ||
+        buf[pos] <= intcodec::BadKind || buf[pos] >= intcodec::Smallest) {
+      printf("blockcodec::decode: block %d is corrupt\n", b );
+      ok = false;
+    }
+    else {
+      blockKind[b] = (intcodec::codecKind)buf[pos];
+      offset[b] = pos + 1 + varLen;
+      bodyLen[b] = n;
+      pos = offset[b] + n;
+    }
+  }
+
+  if (ok) {
+    int numBad = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+:numBad)
+#endif
+    for (int b = 0; b < numBlocks; b++) {
+      const size_t n = blockLength( b, N, blockLen );
+      if (intcodec::decodeBlock( buf + offset[b], bodyLen[b], blockKind[b],
+                                 vec + (b * blockLen), n, entropy ) != bodyLen[b]) {
+        numBad++;
+      }
+    }
+    if (numBad > 0) {
+      printf("blockcodec::decode: %d blocks are corrupt\n", numBad );
+      ok = false;
+    }
+  }
+
+  delete [] blockKind;
+  delete [] bodyLen;
+  delete [] offset;
+  return ok;
+} // decode
@@ -0,0 +1,132 @@
+
+#ifndef _BLOCKCODEC_H_
+#define _BLOCKCODEC_H_
+
+#include <stddef.h>
+
+#include "intcodec.h"
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+
+/**
+  Adaptive lossless compression of a long integer time series.
+
+  No single transform is best for an entire time series: a quiet
+  stretch of a price series compresses best with a wavelet, while a
+  stretch with jumps may compress best with delta coding.  The
+  blockcodec splits the series into blocks of a fixed length
+  (a power of two) and encodes each block with intcodec::encodeBlock.
+  When the kind is <tt>intcodec::Smallest</tt> every transform is
+  tried on each block and the smallest result is kept, so the
+  transform adapts to the data.  The transform that was chosen is
+  recorded in a one byte tag at the start of each block.
+
+  The blocks are independent, so they can be encoded (and decoded)
+  in parallel with OpenMP.  The parallelism is opt-in: none of the
+  shipped builds enable OpenMP, so the blocks are processed one
+  after the other unless the code is compiled with OpenMP support
+  (e.g., /openmp or -fopenmp), which defines _OPENMP.  The result
+  is the same either way.
+  Each block is encoded into its own region of a scratch buffer and
+  the regions are then copied, in order, to the output.
+
+  The encoded bytes are
+
+  <pre>
+     4 bytes   the characters 'K', 'P', 'L', 'B'
+     1 byte    version (1)
+     1 byte    flags (intcodec::entropyFlag if the blocks are
+               entropy coded)
+     2 bytes   reserved (zero)
+     4 bytes   the block length
+     4 bytes   N, the number of values
+     4 bytes   the number of blocks
+     ...       the blocks
+  </pre>
+
+  and each block is
+
+  <pre>
+     1 byte    the transform kind (intcodec::codecKind)
+     varint    the length of the block body, in bytes
+     ...       the block body (see intcodec::encodeBlock)
+  </pre>
+
+  The last block is shorter than the others if N is not a multiple
+  of the block length.  Since it is not a power of two, it is
+  always delta coded.
+
+  Errors are reported with printf and a zero (or false) return
+  value.  All of the functions are static.  The constructor and
+  destructor are declared but not defined, as in the
+  <tt>support</tt> class.
+ */
+class blockcodec
+{
+public:
+  /** size of the header, in bytes */
+  typedef enum { headerBytes = 20 } bogus;
+
+private:
+  static size_t blockLength( const size_t b,
+                             const size_t N,
+                             const size_t blockLen );
+
+public:
+  /** declare but do not define the constructor */
+  blockcodec();
+  /** declare but do not define the destructor */
+  ~blockcodec();
+
+  static size_t maxBytes( const size_t N, const size_t blockLen );
+
+  static size_t encode( const int *vec,
+                        const size_t N,
+                        const size_t blockLen,
+                        const intcodec::codecKind kind,
+                        unsigned char *buf,
+                        const size_t bufLen,
+                        const bool entropy = false,
+                        size_t *kindCount = 0 );
+
+  static size_t decodedLength( const unsigned char *buf, const size_t len );
+
+  static bool decode( const unsigned char *buf,
+                      const size_t len,
+                      int *vec,
+                      const size_t N );
+}; // blockcodec
+
+#endif
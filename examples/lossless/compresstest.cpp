@@ -36,16 +36,31 @@
 
 
 #include <stdio.h>
-
-#include "invpacktree_int.h"
-#include "packtree_int.h"
+#include <time.h>
+
+#include "invpacktree.h"
+#include "packtree.h"
+#include "packquant.h"
+#include "line.h"
+#include "haar.h"
+#include "haaragg.h"
+#include "rangeinv.h"
+#include "costshannon.h"
+#include "costthresh.h"
 #include "support.h"
 #include "delta.h"
 #include "haar_int.h"
 #include "ts_trans_int.h"
 #include "line_int.h"
 #include "costwidth.h"
+#include "bitpack.h"
+#include "intcodec.h"
+#include "blockcodec.h"
+#include "tsfile.h"
 #include "yahooTS.h"
+#include "equityCache.h"
+#include "equitySet.h"
+#include "ohlcv.h"
 
 
 /**
@@ -136,6 +151,10 @@ size_t packet_calc( const int *intVec,
 
   // calculate the wavelet packet tree, using the line wavelet transform
   packtree_int tree( intVec, N, &line );
+  if (! tree.ok()) {
+    printf("Wavelet packet tree could not be allocated\n");
+    return 0;
+  }
 
   // get the root of the wavelet packet transform tree
   packnode<int> *treeRoot = tree.getRoot();
@@ -168,7 +187,7 @@ size_t packet_calc( const int *intVec,
 
   const int *invRslt = invtree.getData();
 
-  bool isEqual = compare( invRslt, copyVec, N );
+  bool isEqual = (invRslt != 0 && compare( invRslt, copyVec, N ));
   if (! isEqual)
     printf("Wavelet packet inverse is wrong\n");
 
@@ -238,6 +257,388 @@ size_t wave_calc( int *intVec,
 
 
 
+/**
+  Encode the data with the intcodec lossless codec, using the
+  transform <i>kind</i>, and check that the decoded result is the
+  same as the original data.  The size of the encoded data is
+  returned in bits, so that it can be compared to the width
+  estimates.  If <i>decodeRate</i> is not null the decode is
+  repeated and the decode rate (megabytes of int values per second)
+  is returned in <i>decodeRate</i>.  If <i>entropy</i> is true the
+  subbands are entropy coded with rANS instead of bit packed.
+ */
+size_t codec_calc( const int *copyVec,
+                   const int N,
+                   intcodec::codecKind kind,
+                   double *decodeRate = 0,
+                   const bool entropy = false )
+{
+  const size_t maxLen = intcodec::maxBytes( N );
+  unsigned char *buf = new unsigned char[ maxLen ];
+  int *decodeVec = new int[ N ];
+
+  const size_t len = intcodec::encode( copyVec, N, kind, buf, maxLen, entropy );
+  if (len == 0 || 
+      ! intcodec::decode( buf, len, decodeVec, N ) ||
+      ! compare( decodeVec, copyVec, N )) {
+    printf("intcodec %s: decode is wrong\n", intcodec::kindName( kind ) );
+  }
+
+  if (decodeRate != 0) {
+    const size_t reps = 2000;
+    clock_t start = clock();
+    for (size_t i = 0; i < reps; i++) {
+      intcodec::decode( buf, len, decodeVec, N );
+    }
+    double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+    double mbytes = (double)(reps * N * sizeof( int )) / (1024.0 * 1024.0);
+    *decodeRate = (secs > 0) ? mbytes / secs : 0;
+  }
+
+  delete [] decodeVec;
+  delete [] buf;
+  return len * 8;
+} // codec_calc
+
+
+/**
+  Encode the data in blocks of <i>blockLen</i> values with the
+  blockcodec and check that the decoded result is the same as the
+  original data.  Returns the size of the encoded data, in bytes.
+  If <i>kindCount</i> is not null, it is set to the number of blocks
+  that used each transform.
+ */
+size_t block_calc( const int *vec,
+                   const size_t N,
+                   const size_t blockLen,
+                   intcodec::codecKind kind,
+                   size_t *kindCount = 0,
+                   const bool entropy = false )
+{
+  const size_t maxLen = blockcodec::maxBytes( N, blockLen );
+  unsigned char *buf = new unsigned char[ maxLen ];
+  int *decodeVec = new int[ N ];
+
+  const size_t len = blockcodec::encode( vec, N, blockLen, kind, buf, maxLen, entropy, kindCount );
+  if (len == 0 ||
+      ! blockcodec::decode( buf, len, decodeVec, N ) ||
+      ! compare( decodeVec, vec, N )) {
+    printf("blockcodec %s: decode is wrong\n", intcodec::kindName( kind ) );
+  }
+
+  delete [] decodeVec;
+  delete [] buf;
+  return len;
+} // block_calc
+
+
+/**
+  Error bounded lossy compression of the (floating point) data with
+  the wavelet packet transform and the line wavelet.  Returns the
+  total width, in bits, of the quantized best basis coefficients.
+  The largest error after the inverse transform and the quantization
+  step are returned in <i>maxErr</i> and <i>step</i>.
+ */
+size_t lossy_calc( const double *realVec,
+                   const size_t N,
+                   const double errBound,
+                   double &maxErr,
+                   double &step )
+{
+  line<packcontainer> w;
+  packquant quant( realVec, N, &w, errBound );
+
+  maxErr = quant.maxError();
+  step = quant.step();
+  return quant.numBits();
+} // lossy_calc
+
+
+/**
+  Check range aggregate queries on Haar coefficients.  The integer
+  data is encoded with the intcodec Haar transform and the haar_int
+  coefficients are decoded without the inverse transform.  The
+  double data is transformed with the haar wavelet.  The aggregates
+  of a set of ranges are compared to the aggregates calculated from
+  the data.  Returns the average number of tree nodes visited per
+  query, or zero if a result is wrong.
+ */
+double agg_calc( const int *intVec, const double *realVec, const size_t N )
+{
+  const size_t maxLen = intcodec::maxBlockBytes( N );
+  unsigned char *buf = new unsigned char[ maxLen ];
+  int *intCoef = new int[ N ];
+  double *realCoef = new double[ N ];
+  bool ok = true;
+
+  intcodec::codecKind kind = intcodec::Haar;
+  const size_t len = intcodec::encodeBlock( intVec, N, kind, buf, maxLen );
+  ok = (len > 0 && intcodec::decodeCoef( buf, len, kind, intCoef, N ) == len);
+
+  for (size_t i = 0; i < N; i++) {
+    realCoef[i] = realVec[i];
+  }
+  haar<double *> w;
+  w.forwardTrans( realCoef, N );
+
+  haaragg_int intAgg( intCoef, N );
+  haaragg realAgg( realCoef, N );
+  size_t visited = 0;
+  size_t numQueries = 0;
+
+  for (size_t a = 0; ok && a < N; a += 37) {
+    for (size_t b = a + 1; ok && b <= N; b += 53) {
+      long long sum = 0;
+      long long mn = intVec[a];
+      long long mx = intVec[a];
+      double realSum = 0.0;
+      for (size_t i = a; i < b; i++) {
+        sum += intVec[i];
+        mn = (intVec[i] < mn) ? intVec[i] : mn;
+        mx = (intVec[i] > mx) ? intVec[i] : mx;
+        realSum += realVec[i];
+      }
+      haaragg_int::aggregate rslt;
+      intAgg.query( a, b, rslt );
+      visited += intAgg.nodesVisited();
+      numQueries++;
+      const double realMean = realAgg.mean( a, b );
+      ok = (rslt.sum == sum && rslt.min == mn && rslt.max == mx &&
+            fabs( realMean - realSum / (double)(b - a) ) < 1e-9);
+    }
+  }
+
+  delete [] realCoef;
+  delete [] intCoef;
+  delete [] buf;
+  return (ok && numQueries > 0) ? (double)visited / (double)numQueries : 0.0;
+} // agg_calc
+
+
+/**
+  Progressive decoding: encode the data with the intcodec transform
+  <i>kind</i> (Line or Packet, which both use the line_int wavelet)
+  and decode the coarse version <i>levels</i> levels up the
+  transform from a prefix of the encoding.  The coarse values are
+  checked against the low pass result of <i>levels</i> forward
+  line_int steps.  Returns the number of bytes of the encoding that
+  were read, or zero if the result is wrong.  The full length is
+  returned in <i>fullLen</i>.
+ */
+size_t coarse_calc( const int *intVec,
+                    const size_t N,
+                    const intcodec::codecKind kind,
+                    const size_t levels,
+                    size_t &fullLen )
+{
+  const size_t maxLen = intcodec::maxBytes( N );
+  unsigned char *buf = new unsigned char[ maxLen ];
+  const size_t n = N >> levels;
+  int *coarse = new int[ n ];
+  int *lowPass = new int[ N ];
+  for (size_t i = 0; i < N; i++) {
+    lowPass[i] = intVec[i];
+  }
+
+  fullLen = intcodec::encode( intVec, N, kind, buf, maxLen );
+  size_t used = intcodec::decodeCoarse( buf, fullLen, levels, coarse, n );
+  // decode again from only the bytes that were needed
+  if (used > 0 && intcodec::decodeCoarse( buf, used, levels, coarse, n ) != used) {
+    used = 0;
+  }
+
+  line_int<int *> line;
+  for (size_t l = 0; l < levels; l++) {
+    line.forwardStep( lowPass, (int)(N >> l) );
+  }
+  if (used > 0 && ! compare( coarse, lowPass, n )) {
+    used = 0;
+  }
+
+  delete [] lowPass;
+  delete [] coarse;
+  delete [] buf;
+  return used;
+} // coarse_calc
+
+
+/**
+  Check the ranged inverse transform (rangeinv).  The data is
+  transformed with the line wavelet, both as an ordered wavelet
+  transform and as a wavelet packet best basis (Shannon entropy
+  cost), and windows of <i>winLen</i> samples are reconstructed from
+  the coefficients and compared to the data.  The average number of
+  coefficients read per window is returned in <i>ordTouched</i> and
+  <i>packTouched</i>.  Returns false if a result is wrong.
+ */
+bool range_calc( const double *realVec,
+                 const size_t N,
+                 const size_t winLen,
+                 double &ordTouched,
+                 double &packTouched )
+{
+  double *coef = new double[ N ];
+  double *win = new double[ winLen ];
+  bool ok = true;
+
+  for (size_t i = 0; i < N; i++) {
+    coef[i] = realVec[i];
+  }
+  line<double *> w;
+  w.forwardTrans( coef, N );
+  rangeinv<double *> ordInv( &w );
+
+  line<packcontainer> pw;
+  packtree tree( realVec, N, &pw );
+  ok = tree.ok();
+  costshannon cost( tree.getRoot() );
+  tree.bestBasis();
+  packbasis<double> basis = tree.getBestBasis();
+  rangeinv<packcontainer> packInv( &pw );
+
+  size_t ordSum = 0;
+  size_t packSum = 0;
+  size_t numWin = 0;
+  for (size_t a = 0; ok && a + winLen <= N; a += 97) {
+    ok = ordInv.inverse( coef, N, a, a + winLen, win );
+    for (size_t i = 0; ok && i < winLen; i++) {
+      ok = (fabs( win[i] - realVec[a + i] ) < 1e-9);
+    }
+    ok = ok && packInv.inverse( basis, a, a + winLen, win );
+    for (size_t i = 0; ok && i < winLen; i++) {
+      ok = (fabs( win[i] - realVec[a + i] ) < 1e-9);
+    }
+    ordSum += ordInv.coefTouched();
+    packSum += packInv.coefTouched();
+    numWin++;
+  }
+
+  ordTouched = (numWin > 0) ? (double)ordSum / (double)numWin : 0.0;
+  packTouched = (numWin > 0) ? (double)packSum / (double)numWin : 0.0;
+
+  delete [] win;
+  delete [] coef;
+  return ok && numWin > 0;
+} // range_calc
+
+
+/**
+  The price cost function for ohlcv_calc: the number of values
+  that are larger than half a cent.  The constructor only takes the
+  tree root, as ohlcv::packetTrans requires.
+ */
+class costcents : public costthresh
+{
+public:
+  costcents( packnode<double> *root ) : costthresh( root, 0.005 ) {}
+}; // costcents
+
+
+/**
+  Pack and unpack a vector with bitpack at each of the byte offsets
+  0..3 of a buffer, for each field width, and check that the vector
+  is recovered.  The vector has two full blocks and a tail.  The
+  packed words follow the width byte and the reference, so they are
+  almost never aligned: build with -fsanitize=alignment to check
+  that they are only read and written with unaligned accesses.
+ */
+bool bitpack_calc()
+{
+  const size_t n = (2 * bitpack::blockLen) + 37;
+  int *vec = new int[ n ];
+  int *result = new int[ n ];
+  unsigned char *buf = new unsigned char[ 4 + 1 + bitpack::maxVarintBytes + (n * sizeof( int )) ];
+  bool ok = true;
+
+  for (unsigned int width = 0; ok && width <= 32; width++) {
+    const unsigned int m = bitpack::mask( width );
+    for (size_t i = 0; i < n; i++) {
+      vec[i] = (int)((((unsigned int)i * 2654435761u) & m) + 0x80000000u);
+    }
+    for (size_t offset = 0; ok && offset < 4; offset++) {
+      const size_t len = bitpack::pack( vec, n, buf + offset );
+      ok = (len == bitpack::frameBytes( vec, n ) &&
+            bitpack::unpack( buf + offset, len, result, n ) == len &&
+            compare( vec, result, n ));
+    }
+  }
+
+  delete [] buf;
+  delete [] result;
+  delete [] vec;
+  return ok;
+} // bitpack_calc
+
+
+/**
+  Load all of the columns of an equity in one call (see ohlcv) and
+  apply the ordered line wavelet to all of them (the volume with the
+  64-bit integer line wavelet).  Check that the inverse transform
+  recovers the data (the volume exactly).  Then calculate the best
+  basis of each column and check the inverse packet transform.  The
+  number of best basis nodes of each column (Open, High, Low, Close
+  and Volume) is returned in <i>nodes</i>.
+ */
+bool ohlcv_calc( const equityCache &cache,
+                 const char *name,
+                 const size_t N,
+                 size_t *nodes )
+{
+  ohlcv bars;
+  if (! bars.load( cache, name, N )) {
+    return false;
+  }
+
+  const size_t numPrices = ohlcv::numPrices;
+  double *prices = new double[ numPrices * N ];
+  int64_t *volume = new int64_t[ N ];
+  memcpy( prices, bars.prices(), numPrices * N * sizeof( double ) );
+  memcpy( volume, bars.volume(), N * sizeof( int64_t ) );
+
+  line<double *> w;
+  line_int<int64_t *, int64_t> wVol;
+  bars.forwardTrans( w, wVol );
+  bars.inverseTrans( w, wVol );
+
+  bool ok = true;
+  for (size_t i = 0; ok && i < numPrices * N; i++) {
+    ok = (fabs( bars.prices()[i] - prices[i] ) < 1e-9);
+  }
+  for (size_t i = 0; ok && i < N; i++) {
+    ok = (bars.volume()[i] == volume[i]);
+  }
+
+  line<packcontainer> packW;
+  line_int<basic_packcontainer<int64_t>, int64_t> packWVol;
+  packbasis<double> basis[ numPrices ];
+  packbasis<int64_t> volBasis;
+  ok = ok && bars.packetTrans<costcents, costwidth64>( &packW, &packWVol, basis, volBasis );
+
+  for (size_t c = 0; ok && c < numPrices; c++) {
+    invpacktree inv( basis[c], &packW );
+    const double *rslt = inv.getData();
+    ok = (rslt != 0);
+    for (size_t i = 0; ok && i < N; i++) {
+      ok = (fabs( rslt[i] - prices[(c * N) + i] ) < 1e-9);
+    }
+    nodes[c] = basis[c].numNodes();
+  }
+  if (ok) {
+    basic_invpacktree<int64_t> invVol( volBasis, &packWVol );
+    const int64_t *rslt = invVol.getData();
+    ok = (rslt != 0);
+    for (size_t i = 0; ok && i < N; i++) {
+      ok = (rslt[i] == volume[i]);
+    }
+    nodes[numPrices] = volBasis.numNodes();
+  }
+
+  delete [] volume;
+  delete [] prices;
+  return ok;
+} // ohlcv_calc
+
+
 /**
   Read in a set of equity time series file.  Calculate the
   number of bits needed to represent the data without
@@ -246,26 +647,40 @@ size_t wave_calc( int *intVec,
  */
 int main()
 {
-  const char *files[] = { "aa",    // Alcoa Aluminium
-			  "amat",  // Applied Materials
-			  "ba",    // Boeing
-			  "cof",   // Capital One
-			  "ge",    // General Electric
-			  "ibm",   // IBM Corp.
-			  "intc",  // Intel
-			  "mmm",   // 3M
-			  "mrk",   // Merck
-			  "wmt",   // Wal-Mart
-			  0        // The null pointer
-			};
-
   const size_t N = 512;
-  double realVec[ N ];
   int intVec[ N ];
 
-  // an instance of yahooTS with the path to the data directory
-  const char *dataDirPath = "..\\data\\equities\\";
-  yahooTS ts( dataDirPath );
+  // The prices are read from a binary cache of the equity files,
+  // which is built from all of the text files in the data directory
+  // the first time the program is run.
+  const char *dataDirPath = "../data/equities/";
+  const char *cachePath = "equities.kpeq";
+  equityCache cache;
+  FILE *cacheFile = fopen( cachePath, "rb" );
+  if (cacheFile != 0) {
+    fclose( cacheFile );
+  }
+  else {
+    equitySet dataSet;
+    if (dataSet.list( dataDirPath ) == 0 ||
+        ! equityCache::build( cachePath, dataDirPath, dataSet.symbols() )) {
+      return 1;
+    }
+  }
+  if (! cache.open( cachePath )) {
+    return 1;
+  }
+
+  // the symbols with at least N values, followed by the null pointer
+  const char **files = new const char *[ cache.numSymbols() + 1 ];
+  size_t numFiles = 0;
+  for (size_t i = 0; i < cache.numSymbols(); i++) {
+    if (cache.length( i ) >= N) {
+      files[numFiles] = cache.symbol( i );
+      numFiles++;
+    }
+  }
+  files[numFiles] = 0;
 
   printf("Equity Uncompressed  delta  Haar  line  TS    wavelet packet (line)\n");
 
@@ -273,12 +688,13 @@ int main()
   for (size_t i = 0; files[i] != 0; i++) {
     
     size_t n = N;
-    if (! ts.getTS( files[i], realVec, n, yahooTS::Close )) {
+    const double *realVec = cache.getTS( files[i], n, yahooTS::Close );
+    if (realVec == 0) {
       break;
     }
 
     if (n != N) {
-      printf("Error: %d out of %d data elements read\n", n, N );
+      printf("Error: %lu out of %lu data elements read\n", (unsigned long)n, (unsigned long)N );
       break;
     }
     
@@ -304,9 +720,254 @@ int main()
     
     const size_t packetWidth = packet_calc( intVec, copyVec, N );
     
-    printf("  %4s       %4d    %4d   %4d  %4d  %d      %4d\n", 
-	   files[i], beforeWidth, deltaWidth, haarWidth, lineWidth, tsTransWidth, packetWidth );
+    printf("  %4s       %4lu    %4lu   %4lu  %4lu  %lu      %4lu\n", 
+	   files[i], (unsigned long)beforeWidth, (unsigned long)deltaWidth,
+	   (unsigned long)haarWidth, (unsigned long)lineWidth,
+	   (unsigned long)tsTransWidth, (unsigned long)packetWidth );
+    
+  }
+
+  // The width estimates do not include the information needed to
+  // decode the data.  Encode the data with the lossless codec and
+  // print the actual size (in bits) for each transform.
+  printf("\nEncoded size in bits (intcodec)\n");
+  printf("Equity  delta  Haar  line  TS    packet  smallest  decode MB/sec\n");
+
+  for (size_t i = 0; files[i] != 0; i++) {
     
+    size_t n = N;
+    const double *realVec = cache.getTS( files[i], n, yahooTS::Close );
+    if (realVec == 0 || n != N) {
+      break;
+    }
+    support::decimalToInt( intVec, realVec, N );
+
+    double rate = 0;
+    const size_t deltaBits = codec_calc( intVec, N, intcodec::Delta );
+    const size_t haarBits = codec_calc( intVec, N, intcodec::Haar );
+    const size_t lineBits = codec_calc( intVec, N, intcodec::Line );
+    const size_t tsBits = codec_calc( intVec, N, intcodec::TS );
+    const size_t packetBits = codec_calc( intVec, N, intcodec::Packet );
+    const size_t smallBits = codec_calc( intVec, N, intcodec::Smallest, &rate );
+
+    printf("  %4s  %5lu  %5lu %5lu %5lu  %5lu   %5lu     %7.1f\n", 
+	   files[i], (unsigned long)deltaBits, (unsigned long)haarBits,
+	   (unsigned long)lineBits, (unsigned long)tsBits,
+	   (unsigned long)packetBits, (unsigned long)smallBits, rate );
+  }
+
+  // Round trip the bit packing at unaligned offsets
+  printf("\nBit packing round trip at unaligned offsets (bitpack): %s\n",
+         bitpack_calc() ? "correct" : "wrong" );
+
+  // Compare bit packing to entropy coding (rANS) of the subbands
+  printf("\nBit packed vs. entropy coded (rANS) size in bits (intcodec)\n");
+  printf("Equity  packet  packet rANS  smallest  smallest rANS  decode MB/sec  rANS decode MB/sec\n");
+
+  for (size_t i = 0; files[i] != 0; i++) {
+    
+    size_t n = N;
+    const double *realVec = cache.getTS( files[i], n, yahooTS::Close );
+    if (realVec == 0 || n != N) {
+      break;
+    }
+    support::decimalToInt( intVec, realVec, N );
+
+    double rate = 0;
+    double ransRate = 0;
+    const size_t packetBits = codec_calc( intVec, N, intcodec::Packet );
+    const size_t packetRans = codec_calc( intVec, N, intcodec::Packet, 0, true );
+    const size_t smallBits = codec_calc( intVec, N, intcodec::Smallest, &rate );
+    const size_t smallRans = codec_calc( intVec, N, intcodec::Smallest, &ransRate, true );
+
+    printf("  %4s  %5lu   %5lu        %5lu     %5lu          %7.1f        %7.1f\n", 
+	   files[i], (unsigned long)packetBits, (unsigned long)packetRans,
+	   (unsigned long)smallBits, (unsigned long)smallRans, rate, ransRate );
+  }
+
+  // Concatenate the close prices of all of the equities and encode
+  // the series in blocks.  Each block is encoded with a fixed
+  // transform or (adaptive) with the transform that gives the
+  // smallest block.
+  const size_t allLen = numFiles * N;
+  int *allVec = new int[ allLen ];
+  size_t allN = 0;
+  for (size_t i = 0; files[i] != 0; i++) {
+    size_t n = N;
+    const double *realVec = cache.getTS( files[i], n, yahooTS::Close );
+    if (realVec == 0 || n != N) {
+      break;
+    }
+    support::decimalToInt( allVec + allN, realVec, N );
+    allN = allN + N;
+  }
+
+  printf("\nBlock encoded size in bytes (blockcodec, %lu values)\n", (unsigned long)allN );
+  printf("Block   delta  Haar  line  TS    packet  adaptive  adaptive rANS  (delta/Haar/line/TS/packet blocks)\n");
+  const size_t blockLens[] = { 64, 128, 256, 512, 0 };
+  for (size_t i = 0; allN > 0 && blockLens[i] != 0; i++) {
+    const size_t blockLen = blockLens[i];
+    size_t count[ intcodec::Smallest ];
+    const size_t deltaBytes = block_calc( allVec, allN, blockLen, intcodec::Delta );
+    const size_t haarBytes = block_calc( allVec, allN, blockLen, intcodec::Haar );
+    const size_t lineBytes = block_calc( allVec, allN, blockLen, intcodec::Line );
+    const size_t tsBytes = block_calc( allVec, allN, blockLen, intcodec::TS );
+    const size_t packetBytes = block_calc( allVec, allN, blockLen, intcodec::Packet );
+    const size_t adaptBytes = block_calc( allVec, allN, blockLen, intcodec::Smallest, count );
+    const size_t ransBytes = block_calc( allVec, allN, blockLen, intcodec::Smallest, 0, true );
+
+    printf("  %4lu  %5lu  %5lu %5lu %5lu  %5lu   %5lu     %5lu          (%lu/%lu/%lu/%lu/%lu)\n",
+           (unsigned long)blockLen, (unsigned long)deltaBytes, (unsigned long)haarBytes,
+           (unsigned long)lineBytes, (unsigned long)tsBytes, (unsigned long)packetBytes,
+           (unsigned long)adaptBytes, (unsigned long)ransBytes,
+           (unsigned long)count[ intcodec::Delta ], (unsigned long)count[ intcodec::Haar ],
+           (unsigned long)count[ intcodec::Line ], (unsigned long)count[ intcodec::TS ],
+           (unsigned long)count[ intcodec::Packet ] );
+  }
+
+  // Write the concatenated series to a seekable file, with a time
+  // stamp (in seconds) for each trading day, and read back a range
+  // of the series.  Only the blocks that overlap the range are
+  // decoded.
+  if (allN > 0) {
+    const char *tsPath = "compresstest.kplf";
+    long long *times = new long long[ allN ];
+    long long day = 0;
+    for (size_t i = 0; i < allN; i++) {
+      if ((day % 7) == 5) {  // skip the weekend
+        day = day + 2;
+      }
+      times[i] = day * 86400;
+      day++;
+    }
+
+    tsfile tsf;
+    if (tsfile::write( tsPath, times, allVec, allN, 256, intcodec::Smallest, true ) &&
+        tsf.open( tsPath )) {
+      const size_t first = 1000;
+      const size_t count = 300;
+      long long *qTimes = new long long[ count ];
+      int *qVals = new int[ count ];
+      const size_t n = tsf.query( times[first], times[first + count - 1], qTimes, qVals, count );
+      bool ok = (n == count);
+      for (size_t i = 0; ok && i < n; i++) {
+        ok = (qTimes[i] == times[first + i] && qVals[i] == allVec[first + i]);
+      }
+      printf("\ntsfile: %lu samples in %lu blocks, query of %lu samples decoded %lu blocks: %s\n",
+             (unsigned long)tsf.length(), (unsigned long)tsf.numBlocks(),
+             (unsigned long)count, (unsigned long)tsf.blocksDecoded(),
+             ok ? "correct" : "wrong" );
+      tsf.close();
+      delete [] qVals;
+      delete [] qTimes;
+    }
+    remove( tsPath );
+    delete [] times;
+  }
+
+  delete [] allVec;
+
+  // Error bounded lossy compression of the prices (in dollars).
+  // The lossless packet width is the width of the integer (cents)
+  // wavelet packet best basis calculated above.
+  printf("\nError bounded lossy compression, size in bits (packquant, line wavelet)\n");
+  printf("Equity  lossless  bound 0.05  (error, step)   bound 0.25  (error, step)\n");
+
+  for (size_t i = 0; files[i] != 0; i++) {
+    size_t n = N;
+    const double *realVec = cache.getTS( files[i], n, yahooTS::Close );
+    if (realVec == 0 || n != N) {
+      break;
+    }
+    support::decimalToInt( intVec, realVec, N );
+    int *copyVec = copy( intVec, N );
+    const size_t packetWidth = packet_calc( intVec, copyVec, N );
+    delete [] copyVec;
+
+    double err1, step1, err2, step2;
+    const size_t bits1 = lossy_calc( realVec, N, 0.05, err1, step1 );
+    const size_t bits2 = lossy_calc( realVec, N, 0.25, err2, step2 );
+
+    printf("  %4s   %5lu     %5lu     (%5.3f, %5.3f)   %5lu     (%5.3f, %5.3f)\n",
+           files[i], (unsigned long)packetWidth, (unsigned long)bits1, err1, step1,
+           (unsigned long)bits2, err2, step2 );
   }
+
+  // Range aggregates (sum, mean, min and max) from the Haar
+  // coefficients, without the inverse transform
+  printf("\nRange queries on Haar coefficients (haaragg)\n");
+  printf("Equity  result   nodes per query\n");
+  for (size_t i = 0; files[i] != 0; i++) {
+    size_t n = N;
+    const double *realVec = cache.getTS( files[i], n, yahooTS::Close );
+    if (realVec == 0 || n != N) {
+      break;
+    }
+    support::decimalToInt( intVec, realVec, N );
+    const double nodes = agg_calc( intVec, realVec, N );
+    printf("  %4s  %s  %5.1f\n", files[i], (nodes > 0) ? "correct" : "wrong  ", nodes );
+  }
+
+  // Decode coarse versions of the data from a prefix of the
+  // encoding
+  printf("\nProgressive decoding, bytes read (intcodec, Line and Packet)\n");
+  printf("Equity  full   1/4    1/16   1/64  (Line)  full   1/4    1/16   1/64  (Packet)\n");
+  for (size_t i = 0; files[i] != 0; i++) {
+    size_t n = N;
+    const double *realVec = cache.getTS( files[i], n, yahooTS::Close );
+    if (realVec == 0 || n != N) {
+      break;
+    }
+    support::decimalToInt( intVec, realVec, N );
+    printf("  %4s", files[i] );
+    const intcodec::codecKind kinds[] = { intcodec::Line, intcodec::Packet };
+    for (size_t k = 0; k < 2; k++) {
+      for (size_t levels = 0; levels <= 6; levels += 2) {
+        size_t fullLen;
+        const size_t used = coarse_calc( intVec, N, kinds[k], levels, fullLen );
+        if (used == 0) {
+          printf("  wrong");
+        }
+        else {
+          printf("  %5lu", (unsigned long)used );
+        }
+      }
+      if (k == 0) {
+        printf("        ");
+      }
+    }
+    printf("\n");
+  }
+
+  // Reconstruct windows of 16 samples without the full inverse
+  // transform
+  printf("\nRanged inverse transform, 16 sample windows (rangeinv, line wavelet)\n");
+  printf("Equity  result   coefficients read (ordered, packet)\n");
+  for (size_t i = 0; files[i] != 0; i++) {
+    size_t n = N;
+    const double *realVec = cache.getTS( files[i], n, yahooTS::Close );
+    if (realVec == 0 || n != N) {
+      break;
+    }
+    double ordTouched, packTouched;
+    const bool ok = range_calc( realVec, N, 16, ordTouched, packTouched );
+    printf("  %4s  %s  %5.1f  %6.1f\n", files[i], ok ? "correct" : "wrong  ", 
+           ordTouched, packTouched );
+  }
+
+  // Transform all of the columns of each equity with one call
+  printf("\nAll columns in one call (ohlcv, line wavelet, 64-bit integer volume)\n");
+  printf("Equity  result   best basis nodes (Open High Low Close Volume)\n");
+  for (size_t i = 0; files[i] != 0; i++) {
+    size_t nodes[ ohlcv::numPrices + 1 ];
+    const bool ok = ohlcv_calc( cache, files[i], N, nodes );
+    printf("  %4s  %s", files[i], ok ? "correct" : "wrong  " );
+    for (size_t c = 0; ok && c <= ohlcv::numPrices; c++) {
+      printf("  %3lu", (unsigned long)nodes[c] );
+    }
+    printf("\n");
+  }
+
+  delete [] files;
   return 0;
 }
@@ -35,7 +35,7 @@
 #include "costwidth.h"
 #include "support.h"
 
-int 
+double 
 costwidth::costCalc( packnode<int> *root )
 {
   assert( root != 0 );
@@ -47,3 +47,17 @@ costwidth::costCalc( packnode<int> *root )
 
   return width;
 } // costCalc
+
+
+double 
+costwidth64::costCalc( packnode<int64_t> *root )
+{
+  assert( root != 0 );
+
+  size_t N = root->length();
+  const int64_t *a = root->getData();
+
+  size_t width = support::vecWidth( a, N );
+
+  return (double)width;
+} // costCalc
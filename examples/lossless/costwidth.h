@@ -36,7 +36,7 @@
  */
 
 
-#include "costbase_int.h"
+#include "costbase.h"
 
 /**
   For a wavelet packet tree node, consisting of <i>n</i> integer
@@ -48,9 +48,22 @@
 class costwidth : public costbase_int
 {
 protected:
-  int costCalc( packnode<int> *root );
+  double costCalc( packnode<int> *root );
 public:
   costwidth( packnode<int> *root ) { traverse( root ); }
 };
 
+
+/**
+  The bit width cost function for a tree of 64-bit integers (e.g.,
+  trading volume, which can overflow an int).
+ */
+class costwidth64 : public basic_costbase<int64_t>
+{
+protected:
+  double costCalc( packnode<int64_t> *root );
+public:
+  costwidth64( packnode<int64_t> *root ) { traverse( root ); }
+};
+
 #endif
@@ -37,6 +37,7 @@
 
 #include "stdio.h"
 #include "liftbase.h"
+#include "intlift.h"
 
 
 /**
@@ -118,25 +119,28 @@ protected:
     as the standard (real) version of the lifting scheme
     Haar transform.
 
+    The array is accessed through raw pointers to its two halves.
+    When the code is compiled for AVX2, eight elements are
+    calculated at a time (see intlift).
+
    */
   void predict( int *& vec, int N, transDirection direction )
   {
-    int half = N >> 1;
-
-    for (int i = 0; i < half; i++) {
-      int predictVal = vec[i];
-      int j = i + half;
-
-      if (direction == forward) {
-	vec[j] = vec[j] - predictVal;
-      }
-      else if (direction == inverse) {
-	vec[j] = vec[j] + predictVal;
-      }
-      else {
-	printf("haar_int::predict: bad direction value\n");
-      }
-    }    
+    const int half = N >> 1;
+    const bool fwd = (direction == forward);
+    const int *lhs = vec;
+    int *rhs = vec + half;
+    int i = 0;
+
+#if defined(__AVX2__)
+    for (; i + intlift::vecLen <= half; i += intlift::vecLen) {
+      __m256i r = intlift::load( rhs + i );
+      intlift::store( rhs + i, intlift::plusMinus( r, intlift::load( lhs + i ), !fwd ) );
+    }
+#endif
+    for (; i < half; i++) {
+      rhs[i] = intlift::plusMinus( rhs[i], lhs[i], !fwd );
+    }
   } // predict
 
   /**
@@ -150,23 +154,24 @@ protected:
    */
   void update( int *& vec, int N, transDirection direction )
   {
-    int half = N >> 1;
-
-    for (int i = 0; i < half; i++) {
-      int j = i + half;
+    const int half = N >> 1;
+    const bool fwd = (direction == forward);
+    int *lhs = vec;
+    const int *rhs = vec + half;
+    int i = 0;
+
+#if defined(__AVX2__)
+    for (; i + intlift::vecLen <= half; i += intlift::vecLen) {
+      // updateVal = floor( vec[j] / 2.0 )
+      __m256i updateVal = _mm256_srai_epi32( intlift::load( rhs + i ), 1 );
+      intlift::store( lhs + i, intlift::plusMinus( intlift::load( lhs + i ), updateVal, fwd ) );
+    }
+#endif
+    for (; i < half; i++) {
       // updateVal = floor( vec[j] / 2.0 )
-      int updateVal = vec[j] >> 1;
-
-      if (direction == forward) {
-	vec[i] = vec[i] + updateVal;
-      }
-      else if (direction == inverse) {
-	vec[i] = vec[i] - updateVal;
-      }
-      else {
-	printf("update_int: bad direction value\n");
-      }
-    }    
+      int updateVal = rhs[i] >> 1;
+      lhs[i] = intlift::plusMinus( lhs[i], updateVal, fwd );
+    }
   } // update
 
 }; // haar_int
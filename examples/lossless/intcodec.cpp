@@ -0,0 +1,802 @@
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "intcodec.h"
+#include "bitpack.h"
+#include "rans.h"
+#include "delta.h"
+#include "haar_int.h"
+#include "line_int.h"
+#include "ts_trans_int.h"
+#include "packtrace.h"
+
+
+/** write a 32-bit value, low order byte first */
+static void put32( unsigned char *buf, const size_t val )
+{
+  buf[0] = (unsigned char)(val & 0xff);
+  buf[1] = (unsigned char)((val >> 8) & 0xff);
+  buf[2] = (unsigned char)((val >> 16) & 0xff);
+  buf[3] = (unsigned char)((val >> 24) & 0xff);
+} // put32
+
+
+/** read a 32-bit value, low order byte first */
+static size_t get32( const unsigned char *buf )
+{
+  return (size_t)buf[0] | ((size_t)buf[1] << 8) |
+         ((size_t)buf[2] << 16) | ((size_t)buf[3] << 24);
+} // get32
+
+
+/**
+  Walk a packet shape bitmap (top down, left to right) and record
+  the length of each best basis node.  Returns false if the bitmap
+  does not describe a tree for <i>n</i> values.
+ */
+static bool walkShape( const unsigned char *shape,
+                       const size_t numBits,
+                       size_t &bit,
+                       const size_t n,
+                       size_t *lens,
+                       size_t &count )
+{
+  if (bit >= numBits) {
+    return false;
+  }
+  const bool split = ((shape[bit >> 3] >> (bit & 0x7)) & 0x1) != 0;
+  bit++;
+  if (split) {
+    if (n < 2) {
+      return false;
+    }
+    return walkShape( shape, numBits, bit, n/2, lens, count ) &&
+           walkShape( shape, numBits, bit, n/2, lens, count );
+  }
+  lens[count++] = n;
+  return true;
+} // walkShape
+
+
+/**
+  Calculate the inverse wavelet packet transform of a best basis
+  in place.  The best basis coefficients are stored one after the
+  other in <i>vec</i>, in the order of the shape bitmap.  When a
+  node is split, the two children are transformed first.  Since the
+  children are adjacent in <i>vec</i>, the inverse step reads them
+  from there and writes the parent to <i>tmp</i>, which is then
+  copied back.  This is the same calculation as the packbasis
+  version of invpacktree, but it does not allocate memory, so the
+  decoder can be called any number of times.
+ */
+static void inverseShape( const unsigned char *shape,
+                          size_t &bit,
+                          int *vec,
+                          const size_t n,
+                          int *tmp,
+                          line_int<int *> &line )
+{
+  const bool split = ((shape[bit >> 3] >> (bit & 0x7)) & 0x1) != 0;
+  bit++;
+  if (split) {
+    const size_t half = n >> 1;
+    inverseShape( shape, bit, vec, half, tmp, line );
+    inverseShape( shape, bit, vec + half, half, tmp, line );
+    line.inverseSpan( vec, vec + half, tmp, (int)n );
+    memcpy( vec, tmp, n * sizeof( int ) );
+  }
+} // inverseShape
+
+
+/**
+  Walk the best basis chosen by packetBasis (top down, left to
+  right), setting the shape bits and copying the coefficients of
+  the best basis nodes.  Node <i>h</i> is numbered in "heap" order
+  (the root is 1 and the children of node h are 2h and 2h+1), so
+  node h at level <i>l</i> is node h - 2<sup>l</sup> of the level.
+ */
+static void emitBasis( const int *tree,
+                       const size_t N,
+                       const unsigned char *chosen,
+                       const size_t h,
+                       const size_t level,
+                       unsigned char *shape,
+                       size_t &bit,
+                       int *coef,
+                       size_t &offset )
+{
+  if (chosen[h]) {
+    const size_t n = N >> level;
+    const size_t j = h - ((size_t)1 << level);
+    memcpy( coef + offset, tree + (level * N) + (j * n), n * sizeof( int ) );
+    offset = offset + n;
+    bit++;
+  }
+  else {
+    shape[bit >> 3] |= (unsigned char)(1 << (bit & 0x7));
+    bit++;
+    emitBasis( tree, N, chosen, 2*h, level + 1, shape, bit, coef, offset );
+    emitBasis( tree, N, chosen, (2*h) + 1, level + 1, shape, bit, coef, offset );
+  }
+} // emitBasis
+
+
+bool intcodec::isPower2( const size_t n )
+{
+  return (n > 0) && ((n & (n - 1)) == 0);
+} // isPower2
+
+
+/**
+  The maximum number of subbands for a transform kind.  For the
+  packet transform this is the number of best basis nodes, which
+  can be as large as N.
+ */
+size_t intcodec::numBands( const codecKind kind, const size_t N )
+{
+  size_t bands = 0;
+  if (kind == Delta) {
+    bands = (N > 1) ? 2 : 1;
+  }
+  else if (kind == Packet) {
+    bands = N;
+  }
+  else {
+    bands = 1;
+    for (size_t n = N; n > 1; n = n >> 1) {
+      bands++;
+    }
+  }
+  return bands;
+} // numBands
+
+
+/**
+  Fill in the subband lengths for a transform kind.  Returns the
+  number of subbands or zero if the packet shape is not valid.  For
+  the packet transform the number of bits in the shape bitmap is
+  returned in <i>numBits</i>.  <i>maxBits</i> is the number of bits
+  that are available in the buffer.
+ */
+size_t intcodec::bandLengths( const codecKind kind,
+                              const size_t N,
+                              const unsigned char *shape,
+                              const size_t maxBits,
+                              size_t &numBits,
+                              size_t *lens )
+{
+  size_t count = 0;
+  numBits = 0;
+  if (kind == Delta) {
+    lens[count++] = 1;
+    if (N > 1) {
+      lens[count++] = N - 1;
+    }
+  }
+  else if (kind == Packet) {
+    if (! walkShape( shape, maxBits, numBits, N, lens, count )) {
+      count = 0;
+    }
+  }
+  else {
+    lens[count++] = 1;
+    for (size_t n = 1; n < N; n = n << 1) {
+      lens[count++] = n;
+    }
+  }
+  return count;
+} // bandLengths
+
+
+/**
+  Calculate the wavelet packet tree of <i>vec</i> with the
+  <tt>line_int</tt> wavelet and choose the best basis, using the size
+  of the bit packed node (bitpack::frameBytes) as the cost.  The shape
+  of the best basis is written to <i>shape</i> (in the packbasis
+  format) and the best basis coefficients to <i>coef</i>.  Returns
+  the number of shape bits.
+
+  The result is the same as the best basis of a packtree_int with
+  this cost function.  The tree is stored in a single array with one
+  row of N values for each level, so the calculation allocates no
+  pool memory and can run in several threads at once.
+ */
+size_t intcodec::packetBasis( const int *vec,
+                              const size_t N,
+                              unsigned char *shape,
+                              int *coef )
+{
+  size_t levels = 0;
+  for (size_t n = N; n > 1; n = n >> 1) {
+    levels++;
+  }
+
+  int *tree = new int[ N * (levels + 1) ];
+  double *best = new double[ 2 * N ];
+  unsigned char *chosen = new unsigned char[ 2 * N ];
+  line_int<int *> line;
+
+  // level l + 1 is calculated from level l.  The low pass and high
+  // pass children of a node are next to each other in the next level
+  memcpy( tree, vec, N * sizeof( int ) );
+  for (size_t l = 0; l < levels; l++) {
+    const size_t n = N >> l;
+    PACKTRACE_SPAN( levelSpan, "level", n );
+    const int *src = tree + (l * N);
+    int *dst = tree + ((l + 1) * N);
+    for (size_t j = 0; j < ((size_t)1 << l); j++) {
+      line.forwardSpan( src + (j * n), dst + (j * n), dst + (j * n) + (n >> 1), (int)n );
+    }
+  }
+
+  // choose the best basis from the bottom up
+  PACKTRACE_SPAN( bestSpan, "best basis", N );
+  for (size_t l = levels + 1; l > 0; l--) {
+    const size_t level = l - 1;
+    const size_t n = N >> level;
+    for (size_t j = 0; j < ((size_t)1 << level); j++) {
+      const size_t h = ((size_t)1 << level) + j;
+      const double cost = (double)(bitpack::frameBytes( tree + (level * N) + (j * n), n ) * 8);
+      if (level == levels) {
+        best[h] = cost;
+        chosen[h] = 1;
+      }
+      else {
+        const double childCost = best[2*h] + best[(2*h) + 1];
+        chosen[h] = (cost <= childCost) ? 1 : 0;
+        best[h] = (cost <= childCost) ? cost : childCost;
+      }
+    }
+  }
+
+  memset( shape, 0, ((2 * N) + 7) >> 3 );
+  size_t bit = 0;
+  size_t offset = 0;
+  emitBasis( tree, N, chosen, 1, 0, shape, bit, coef, offset );
+
+  delete [] chosen;
+  delete [] best;
+  delete [] tree;
+  return bit;
+} // packetBasis
+
+
+/**
+  An upper bound on the size of the body of a block of N values
+  (see encodeBlock), for any transform kind.
+ */
+size_t intcodec::maxBlockBytes( const size_t N )
+{
+  // shape bitmap, per subband overhead (width, reference and word
+  // rounding) and the values at full width
+  const size_t perBand = 1 + bitpack::maxVarintBytes + sizeof( unsigned int );
+  return ((2 * N) + 7)/8 + ((N + 1) * perBand) + (N * sizeof( unsigned int ));
+} // maxBlockBytes
+
+
+/**
+  An upper bound on the size of the encoding of N values, for any
+  transform kind.  This is the size of the buffer that should be
+  passed to encode.
+ */
+size_t intcodec::maxBytes( const size_t N )
+{
+  return headerBytes + maxBlockBytes( N );
+} // maxBytes
+
+
+/**
+  Encode the data with one transform, without a header.
+ */
+size_t intcodec::encodeKind( const int *vec,
+                             const size_t N,
+                             const codecKind kind,
+                             unsigned char *buf,
+                             const size_t bufLen,
+                             const bool entropy )
+{
+  if (kind != Delta && ! isPower2( N )) {
+    printf("intcodec::encode: N = %u is not a power of two\n", (unsigned)N );
+    return 0;
+  }
+  if (kind == Packet && N < 2) {
+    printf("intcodec::encode: the packet transform needs at least two values\n");
+    return 0;
+  }
+  if (bufLen < maxBlockBytes( N )) {
+    printf("intcodec::encode: the buffer is too small\n");
+    return 0;
+  }
+
+  int *coef = new int[ N ];
+  size_t len = 0;
+
+  if (kind == Packet) {
+    const size_t numBits = packetBasis( vec, N, buf, coef );
+    len = (numBits + 7) >> 3;
+  }
+  else {
+    memcpy( coef, vec, N * sizeof( int ) );
+    if (kind == Delta) {
+      delta_trans<int> delta;
+      delta.forward( coef, N );
+    }
+    else {
+      haar_int haar;
+      line_int<int *> line;
+      ts_trans_int ts;
+      liftbase<int *, int> *w = &haar;
+      if (kind == Line) {
+        w = &line;
+      }
+      else if (kind == TS) {
+        w = &ts;
+      }
+      w->forwardTrans( coef, (int)N );
+    }
+  }
+
+  // the subbands
+  size_t *lens = new size_t[ numBands( kind, N ) ];
+  size_t numBits;
+  const size_t bands = bandLengths( kind, N, buf, len * 8, numBits, lens );
+  size_t offset = 0;
+  for (size_t b = 0; b < bands; b++) {
+    if (entropy) {
+      len += rans::pack( coef + offset, lens[b], buf + len );
+    }
+    else {
+      len += bitpack::pack( coef + offset, lens[b], buf + len );
+    }
+    offset = offset + lens[b];
+  }
+
+  delete [] lens;
+  delete [] coef;
+  return len;
+} // encodeKind
+
+
+/**
+  Encode a block of <i>N</i> values without the header.  This is
+  used by encode and by codecs that store many blocks (see
+  blockcodec), where the transform kind is stored by the caller.
+  If <i>kind</i> is <tt>Smallest</tt> each transform is tried and
+  <i>kind</i> is set to the transform that gave the smallest
+  result.  If <i>entropy</i> is true the subbands are entropy coded
+  (see rans) instead of bit packed.  The buffer must have room for
+  maxBlockBytes( N ) bytes.
+  Returns the number of bytes written or zero if there is an error.
+
+  The function does not use the memory pool, so blocks can be
+  encoded in several threads at once.
+ */
+size_t intcodec::encodeBlock( const int *vec,
+                              const size_t N,
+                              codecKind &kind,
+                              unsigned char *buf,
+                              const size_t bufLen,
+                              const bool entropy )
+{
+  PACKTRACE_SPAN( encodeSpan, "encode", N );
+  size_t len = 0;
+
+  if (vec == 0 || buf == 0 || N == 0) {
+    printf("intcodec::encode: no data\n");
+  }
+  else if (kind == Smallest) {
+    const size_t maxLen = maxBlockBytes( N );
+    unsigned char *tmp = new unsigned char[ maxLen ];
+    const codecKind kinds[] = { Delta, Haar, Line, TS, Packet };
+    const size_t numKinds = sizeof( kinds ) / sizeof( codecKind );
+
+    for (size_t k = 0; k < numKinds; k++) {
+      if (kinds[k] != Delta && (! isPower2( N ) || N < 2)) {
+        continue;
+      }
+      const size_t tmpLen = encodeKind( vec, N, kinds[k], tmp, maxLen, entropy );
+      if (tmpLen > 0 && (len == 0 || tmpLen < len)) {
+        if (bufLen < tmpLen) {
+          printf("intcodec::encode: the buffer is too small\n");
+          len = 0;
+          break;
+        }
+        memcpy( buf, tmp, tmpLen );
+        len = tmpLen;
+        kind = kinds[k];
+      }
+    }
+    delete [] tmp;
+  }
+  else if (kind > BadKind && kind < Smallest) {
+    len = encodeKind( vec, N, kind, buf, bufLen, entropy );
+  }
+  else {
+    printf("intcodec::encode: bad transform kind\n");
+  }
+  return len;
+} // encodeBlock
+
+
+/**
+  Encode <i>N</i> values with the transform <i>kind</i> and bit
+  packing (or entropy coding, if <i>entropy</i> is true).  The result
+  is written to <i>buf</i>, which must have room for maxBytes( N )
+  bytes.  Returns the number of bytes written or
+  zero if there is an error.
+ */
+size_t intcodec::encode( const int *vec,
+                         const size_t N,
+                         const codecKind kind,
+                         unsigned char *buf,
+                         const size_t bufLen,
+                         const bool entropy )
+{
+  size_t len = 0;
+
+  if (buf != 0 && bufLen >= headerBytes) {
+    codecKind blockKind = kind;
+    const size_t bodyLen = encodeBlock( vec, N, blockKind, buf + headerBytes, bufLen - headerBytes, entropy );
+    if (bodyLen > 0) {
+      buf[0] = 'K';
+      buf[1] = 'P';
+      buf[2] = 'L';
+      buf[3] = 'C';
+      buf[4] = 1;
+      buf[5] = (unsigned char)blockKind;
+      buf[6] = (unsigned char)(entropy ? entropyFlag : 0);
+      buf[7] = 0;
+      put32( buf + 8, N );
+      put32( buf + 12, bodyLen );
+      len = headerBytes + bodyLen;
+    }
+  }
+  else {
+    printf("intcodec::encode: the buffer is too small\n");
+  }
+  return len;
+} // encode
+
+
+/**
+  Return the number of values in an encoded buffer, or zero if the
+  buffer does not start with a valid header.
+ */
+size_t intcodec::decodedLength( const unsigned char *buf, const size_t len )
+{
+  size_t N = 0;
+  if (kindOf( buf, len ) != BadKind) {
+    N = get32( buf + 8 );
+  }
+  return N;
+} // decodedLength
+
+
+/**
+  Return the transform kind of an encoded buffer (BadKind if the
+  buffer does not start with a valid header).
+ */
+intcodec::codecKind intcodec::kindOf( const unsigned char *buf, const size_t len )
+{
+  codecKind kind = BadKind;
+  if (buf != 0 && len >= headerBytes &&
+      buf[0] == 'K' && buf[1] == 'P' && buf[2] == 'L' && buf[3] == 'C' &&
+      buf[4] == 1 && buf[5] > BadKind && buf[5] < Smallest) {
+    kind = (codecKind)buf[5];
+  }
+  return kind;
+} // kindOf
+
+
+/**
+  Decode the subbands of a block that was written by encodeBlock,
+  without the inverse transform.  For the wavelet kinds the result
+  is the output of forwardTrans (e.g., the haar_int coefficients,
+  which can be used for range queries with haaragg_int).  For the
+  packet transform it is the best basis coefficients, in the order
+  of the shape bitmap.  Returns the number of bytes read, or zero if
+  the bytes are not a valid encoding of <i>N</i> values.
+ */
+size_t intcodec::decodeCoef( const unsigned char *buf,
+                             const size_t len,
+                             const codecKind kind,
+                             int *vec,
+                             const size_t N,
+                             const bool entropy )
+{
+  if (buf == 0 || vec == 0 || N == 0 || kind <= BadKind || kind >= Smallest ||
+      (kind != Delta && ! isPower2( N )) || (kind == Packet && N < 2)) {
+    printf("intcodec::decode: bad block\n");
+    return 0;
+  }
+
+  size_t *lens = new size_t[ numBands( kind, N ) ];
+  size_t numBits;
+  const size_t bands = bandLengths( kind, N, buf, len * 8, numBits, lens );
+  size_t pos = (numBits + 7) >> 3;
+  bool ok = (bands > 0);
+  if (! ok) {
+    printf("intcodec::decode: bad packet shape\n");
+  }
+
+  size_t offset = 0;
+  for (size_t b = 0; ok && b < bands; b++) {
+    const size_t bandLen = entropy ? rans::unpack( buf + pos, len - pos, vec + offset, lens[b] )
+                                   : bitpack::unpack( buf + pos, len - pos, vec + offset, lens[b] );
+    if (bandLen == 0) {
+      printf("intcodec::decode: subband %u is corrupt\n", (unsigned)b );
+      ok = false;
+    }
+    pos = pos + bandLen;
+    offset = offset + lens[b];
+  }
+  delete [] lens;
+
+  return ok ? pos : 0;
+} // decodeCoef
+
+
+/**
+  Decode a block that was written by encodeBlock with the transform
+  <i>kind</i> and the same <i>entropy</i> flag.  Returns the number
+  of bytes read, or zero if the bytes are not a valid encoding of
+  <i>N</i> values.  Like encodeBlock, this function can be called
+  from several threads.
+ */
+size_t intcodec::decodeBlock( const unsigned char *buf,
+                              const size_t len,
+                              const codecKind kind,
+                              int *vec,
+                              const size_t N,
+                              const bool entropy )
+{
+  PACKTRACE_SPAN( decodeSpan, "decode", N );
+  const size_t pos = decodeCoef( buf, len, kind, vec, N, entropy );
+  if (pos > 0) {
+    if (kind == Delta) {
+      delta_trans<int> delta;
+      delta.inverse( vec, N );
+    }
+    else if (kind == Packet) {
+      line_int<int *> line;
+      int *tmp = new int[ N ];
+      size_t bit = 0;
+      inverseShape( buf, bit, vec, N, tmp, line );
+      delete [] tmp;
+    }
+    else {
+      haar_int haar;
+      line_int<int *> line;
+      ts_trans_int ts;
+      liftbase<int *, int> *w = &haar;
+      if (kind == Line) {
+        w = &line;
+      }
+      else if (kind == TS) {
+        w = &ts;
+      }
+      w->inverseTrans( vec, (int)N );
+    }
+  }
+  return pos;
+} // decodeBlock
+
+
+/**
+  Decode a coarse version of a block that was written by encodeBlock:
+  the inverse transform stops <i>levels</i> steps before the end and
+  the N/2<sup>levels</sup> low pass values at that level are written
+  to <i>vec</i>.  For the integer wavelets each value is the
+  (rounded) average of 2<sup>levels</sup> data values.
+
+  The subbands are stored from low to high frequency.  For the
+  wavelet kinds the first N/2<sup>levels</sup> coefficients are a
+  complete transform of the coarse level.  For the packet transform
+  the best basis nodes are stored in pre-order, so the nodes under
+  the low pass node at the coarse level come first.  Either way the
+  coarse version only needs a prefix of the block.  <i>len</i> may
+  be the length of a prefix, and the return value is the number of
+  bytes that were read, so a reader that has only read part of the
+  block can tell when it has enough.  Returns zero if the bytes are
+  not a valid encoding (or the prefix is too short).  The delta
+  encoding has no coarse levels.
+ */
+size_t intcodec::decodeCoarseBlock( const unsigned char *buf,
+                                    const size_t len,
+                                    const codecKind kind,
+                                    const size_t levels,
+                                    int *vec,
+                                    const size_t N,
+                                    const bool entropy )
+{
+  if (buf == 0 || vec == 0 || kind <= Delta || kind >= Smallest ||
+      ! isPower2( N ) || (kind == Packet && N < 2) || (N >> levels) == 0) {
+    printf("intcodec::decodeCoarse: bad block\n");
+    return 0;
+  }
+
+  size_t *lens = new size_t[ numBands( kind, N ) ];
+  size_t numBits;
+  const size_t bands = bandLengths( kind, N, buf, len * 8, numBits, lens );
+  size_t pos = (numBits + 7) >> 3;
+  bool ok = (bands > 0);
+  if (! ok) {
+    printf("intcodec::decodeCoarse: bad packet shape\n");
+  }
+
+  // The number of coefficients that are needed.  For the packet
+  // transform, the walk down the low pass side of the tree may end
+  // at a best basis node above the coarse level.
+  const size_t n = N >> levels;
+  size_t need = n;
+  size_t depth = levels;
+  if (kind == Packet) {
+    for (depth = 0; depth < levels; depth++) {
+      if (((buf[depth >> 3] >> (depth & 0x7)) & 0x1) == 0) {
+        break;
+      }
+    }
+    need = N >> depth;
+  }
+
+  int *coef = new int[ need ];
+  size_t offset = 0;
+  for (size_t b = 0; ok && b < bands && offset < need; b++) {
+    const size_t bandLen = entropy ? rans::unpack( buf + pos, len - pos, coef + offset, lens[b] )
+                                   : bitpack::unpack( buf + pos, len - pos, coef + offset, lens[b] );
+    if (bandLen == 0) {
+      printf("intcodec::decodeCoarse: subband %u is corrupt or missing\n", (unsigned)b );
+      ok = false;
+    }
+    pos = pos + bandLen;
+    offset = offset + lens[b];
+  }
+
+  if (ok) {
+    line_int<int *> line;
+    if (kind == Packet && depth == levels) {
+      // the subtree under the coarse node starts at shape bit
+      // <i>levels</i>, after the splits on the way down
+      int *tmp = new int[ n ];
+      size_t bit = levels;
+      inverseShape( buf, bit, coef, n, tmp, line );
+      delete [] tmp;
+    }
+    else if (kind == Packet) {
+      // a best basis node above the coarse level: calculate the
+      // low pass result with forward steps
+      int *rhs = new int[ need/2 ];
+      for (size_t m = need; m > n; m = m >> 1) {
+        int *lhs = new int[ m/2 ];
+        line.forwardSpan( coef, lhs, rhs, (int)m );
+        delete [] coef;
+        coef = lhs;
+      }
+      delete [] rhs;
+    }
+    else {
+      haar_int haar;
+      ts_trans_int ts;
+      liftbase<int *, int> *w = &haar;
+      if (kind == Line) {
+        w = &line;
+      }
+      else if (kind == TS) {
+        w = &ts;
+      }
+      w->inverseTransCoarse( coef, (int)N, (int)levels );
+    }
+    memcpy( vec, coef, n * sizeof( int ) );
+  }
+  delete [] coef;
+  delete [] lens;
+
+  return ok ? pos : 0;
+} // decodeCoarseBlock
+
+
+/**
+  Decode a coarse version, N/2<sup>levels</sup> values, of the data
+  from the bytes produced by encode (see decodeCoarseBlock).  The
+  bytes may be a prefix of the encoding.  <i>n</i> is the number of
+  values in <i>vec</i>, which must be N/2<sup>levels</sup>.  Returns
+  the number of bytes of the encoding that were read, or zero on an
+  error.
+ */
+size_t intcodec::decodeCoarse( const unsigned char *buf,
+                               const size_t len,
+                               const size_t levels,
+                               int *vec,
+                               const size_t n )
+{
+  const codecKind kind = kindOf( buf, len );
+  if (kind == BadKind || vec == 0) {
+    printf("intcodec::decodeCoarse: bad header\n");
+    return 0;
+  }
+  const size_t N = get32( buf + 8 );
+  if ((N >> levels) != n) {
+    printf("intcodec::decodeCoarse: wrong data length\n");
+    return 0;
+  }
+  size_t bodyLen = get32( buf + 12 );
+  if (bodyLen > len - headerBytes) {
+    bodyLen = len - headerBytes;
+  }
+  const bool entropy = (buf[6] & entropyFlag) != 0;
+  const size_t pos = decodeCoarseBlock( buf + headerBytes, bodyLen, kind, levels, vec, N, entropy );
+  return (pos > 0) ? headerBytes + pos : 0;
+} // decodeCoarse
+
+
+/**
+  Decode the bytes produced by encode.  <i>vec</i> must have room
+  for <i>N</i> values, where N is the value returned by
+  decodedLength.  Returns false if the bytes are not a valid
+  encoding.
+ */
+bool intcodec::decode( const unsigned char *buf,
+                       const size_t len,
+                       int *vec,
+                       const size_t N )
+{
+  const codecKind kind = kindOf( buf, len );
+  if (kind == BadKind || vec == 0) {
+    printf("intcodec::decode: bad header\n");
+    return false;
+  }
+  const size_t bodyLen = get32( buf + 12 );
+  if (get32( buf + 8 ) != N || bodyLen > len - headerBytes) {
+    printf("intcodec::decode: wrong data length\n");
+    return false;
+  }
+  const bool entropy = (buf[6] & entropyFlag) != 0;
+  return decodeBlock( buf + headerBytes, bodyLen, kind, vec, N, entropy ) == bodyLen;
+} // decode
+
+
+/**
+  The name of a transform kind (for printing)
+ */
+const char *intcodec::kindName( const codecKind kind )
+{
+  const char *names[] = { "bad", "delta", "Haar", "line", "TS", "packet", "smallest" };
+  const char *name = names[0];
+  if (kind > BadKind && kind <= Smallest) {
+    name = names[ kind ];
+  }
+  return name;
+} // kindName
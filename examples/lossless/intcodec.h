@@ -0,0 +1,216 @@
+
+#ifndef _INTCODEC_H_
+#define _INTCODEC_H_
+
+#include <stddef.h>
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+/**
+  Lossless compression of an integer time series.
+
+  The compresstest program estimates the number of bits needed to
+  represent a time series after a transform (delta, the S transform
+  <tt>haar_int</tt>, <tt>line_int</tt>, the TS transform and the
+  best basis of the wavelet packet transform).  This class actually
+  produces the compressed bytes and decodes them.
+
+  The encoder applies one of the transforms and then stores each
+  subband of the result with frame of reference bit packing (see
+  bitpack).  The subbands are:
+
+  <ul>
+  <li>
+  <b>Delta</b>: the first value and the N-1 differences.
+  </li>
+  <li>
+  <b>Haar</b>, <b>Line</b> and <b>TS</b>: the average in element 0
+  followed by the coefficient bands of length 1, 2, 4, ... N/2.
+  </li>
+  <li>
+  <b>Packet</b>: the best basis nodes of the integer wavelet packet
+  tree, built with <tt>line_int</tt>.  The best basis is chosen
+  with the size of the bit packed node as the cost (see
+  packetBasis).  The shape of the best basis tree is stored before
+  the subbands, in the same format as a packbasis descriptor.
+  </li>
+  </ul>
+
+  The encoded bytes are
+
+  <pre>
+     4 bytes   the characters 'K', 'P', 'L', 'C'
+     1 byte    version (1)
+     1 byte    transform kind (codecKind)
+     1 byte    flags (entropyFlag if the subbands are entropy coded)
+     1 byte    reserved (zero)
+     4 bytes   N, the number of values
+     4 bytes   length of the body, in bytes
+     ...       the body: the packet shape bitmap (packet only)
+               followed by the subbands, each stored by bitpack::pack
+  </pre>
+
+  The body is written by encodeBlock and read by decodeBlock.  Codecs
+  that store many blocks (see blockcodec) call these functions
+  directly and record the transform kind and length themselves.
+  None of the functions use the memory pool, so blocks can be
+  encoded and decoded in several threads at once.
+
+  Optionally, the subbands are entropy coded with rANS (see the rans
+  class) instead of bit packed.  Each subband (for the packet
+  transform, each best basis node) gets its own frequency table.
+
+  The subbands are stored from low to high frequency, so a coarse
+  version of the data (the low pass result some number of levels up
+  the transform) can be decoded from a prefix of the encoding (see
+  decodeCoarse).
+
+  The kind <tt>Smallest</tt> encodes the data with each of the
+  transforms and keeps the smallest result.  The wavelet transforms
+  are only tried when N is a power of two.
+
+  Errors (an output buffer that is too small, an N that is not a
+  power of two for a wavelet, a corrupt input buffer) are reported
+  with printf and a zero (or false) return value.
+
+  All of the functions are static.  The constructor and destructor
+  are declared but not defined, as in the <tt>support</tt> class.
+ */
+class intcodec
+{
+public:
+  /** the transform applied before bit packing */
+  typedef enum { BadKind = 0,
+                 Delta = 1,
+                 Haar = 2,
+                 Line = 3,
+                 TS = 4,
+                 Packet = 5,
+                 Smallest = 6 } codecKind;
+
+  /** size of the fixed part of the header, in bytes, and the header
+      flag that marks entropy coded subbands */
+  typedef enum { headerBytes = 16,
+                 entropyFlag = 1 } bogus;
+
+private:
+  static bool isPower2( const size_t n );
+
+  static size_t numBands( const codecKind kind,
+                          const size_t N );
+
+  static size_t bandLengths( const codecKind kind,
+                             const size_t N,
+                             const unsigned char *shape,
+                             const size_t maxBits,
+                             size_t &numBits,
+                             size_t *lens );
+
+  static size_t packetBasis( const int *vec,
+                             const size_t N,
+                             unsigned char *shape,
+                             int *coef );
+
+  static size_t encodeKind( const int *vec,
+                            const size_t N,
+                            const codecKind kind,
+                            unsigned char *buf,
+                            const size_t bufLen,
+                            const bool entropy );
+
+public:
+  /** declare but do not define the constructor */
+  intcodec();
+  /** declare but do not define the destructor */
+  ~intcodec();
+
+  static size_t maxBytes( const size_t N );
+
+  static size_t maxBlockBytes( const size_t N );
+
+  static size_t encodeBlock( const int *vec,
+                             const size_t N,
+                             codecKind &kind,
+                             unsigned char *buf,
+                             const size_t bufLen,
+                             const bool entropy = false );
+
+  static size_t decodeCoef( const unsigned char *buf,
+                            const size_t len,
+                            const codecKind kind,
+                            int *vec,
+                            const size_t N,
+                            const bool entropy = false );
+
+  static size_t decodeBlock( const unsigned char *buf,
+                             const size_t len,
+                             const codecKind kind,
+                             int *vec,
+                             const size_t N,
+                             const bool entropy = false );
+
+  static size_t decodeCoarseBlock( const unsigned char *buf,
+                                   const size_t len,
+                                   const codecKind kind,
+                                   const size_t levels,
+                                   int *vec,
+                                   const size_t N,
+                                   const bool entropy = false );
+
+  static size_t encode( const int *vec,
+                        const size_t N,
+                        const codecKind kind,
+                        unsigned char *buf,
+                        const size_t bufLen,
+                        const bool entropy = false );
+
+  static size_t decodedLength( const unsigned char *buf, const size_t len );
+
+  static codecKind kindOf( const unsigned char *buf, const size_t len );
+
+  static bool decode( const unsigned char *buf,
+                      const size_t len,
+                      int *vec,
+                      const size_t N );
+
+  static size_t decodeCoarse( const unsigned char *buf,
+                              const size_t len,
+                              const size_t levels,
+                              int *vec,
+                              const size_t n );
+
+  static const char *kindName( const codecKind kind );
+}; // intcodec
+
+#endif
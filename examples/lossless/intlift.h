@@ -0,0 +1,225 @@
+
+#ifndef _INTLIFT_H_
+#define _INTLIFT_H_
+
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+/**
+  Integer arithmetic shared by the integer to integer lifting scheme
+  wavelets (haar_int, line_int and ts_trans_int).
+
+  The integer wavelets round the result of a division by two or
+  four with the expression
+
+  <pre>
+     (int)((s/2.0) + 0.5)
+     (int)((s/4.0) + 0.5)
+  </pre>
+
+  where the cast truncates toward zero.  This is the same as the
+  C integer (truncating) division of (s + 1) by 2 and (s + 2) by 4.
+  The functions in this class calculate these values with shifts and
+  adds, so the wavelet kernels need no floating point conversions and
+  give exact results for any int value (the floating point version
+  loses precision when the magnitude of s is larger than
+  2<sup>24</sup>).
+
+  The sums are calculated in an unsigned type and cast back to the
+  signed type (as in bitpack and rans), so they wrap at the width of
+  the type rather than overflowing.  The int functions are
+  overloaded by templates for the other integer widths (int16_t and
+  int64_t), which wrap in the same way, so the 16-bit result is the
+  same as the result of the 16-bit vector functions.  The haar_int
+  and line_int kernels use add and extend for their other sums, so
+  their forward and inverse transforms are exact inverses for any
+  input values.
+
+  When the code is compiled for AVX2 (__AVX2__ is defined) there are
+  also versions of these functions that operate on eight 32-bit
+  integers or sixteen 16-bit integers at a time.  The scalar
+  functions are the reference version: the vector versions give
+  exactly the same result.
+
+  All of the functions are static.  The constructor and destructor
+  are declared but not defined, as in the <tt>support</tt> class.
+ */
+class intlift
+{
+public:
+  /** declare but do not define the constructor */
+  intlift();
+  /** declare but do not define the destructor */
+  ~intlift();
+
+  /** (s + 1)/2, truncated toward zero */
+  static int roundHalf( const int s )
+  {
+    const unsigned int u = (unsigned int)s + 1;
+    return (int)(u + (u >> 31)) >> 1;
+  }
+
+  /** (s + 2)/4, truncated toward zero */
+  static int roundQuarter( const int s )
+  {
+    const unsigned int u = (unsigned int)s + 2;
+    return (int)(u + (((int)u >> 31) & 3)) >> 2;
+  }
+
+  /** return x + v if <i>plus</i> is true, otherwise x - v */
+  static int plusMinus( const int x, const int v, const bool plus )
+  {
+    return plus ? (int)((unsigned int)x + (unsigned int)v)
+                : (int)((unsigned int)x - (unsigned int)v);
+  }
+
+  /** (s + 1)/2 for integer types other than int */
+  template <class T>
+  static T roundHalf( T s )
+  {
+    s = (T)((uint64_t)s + 1);
+    return (T)(s / 2);
+  }
+
+  /** (s + 2)/4 for integer types other than int */
+  template <class T>
+  static T roundQuarter( T s )
+  {
+    s = (T)((uint64_t)s + 2);
+    return (T)(s / 4);
+  }
+
+  /** plusMinus for integer types other than int */
+  template <class T>
+  static T plusMinus( const T x, const T v, const bool plus )
+  {
+    return plus ? (T)((uint64_t)x + (uint64_t)v)
+                : (T)((uint64_t)x - (uint64_t)v);
+  }
+
+  /** x + y, wrapped to the width of the type */
+  template <class T>
+  static T add( const T x, const T y )
+  {
+    return (T)((uint64_t)x + (uint64_t)y);
+  }
+
+  /** 2y - x (the next point on the line through x and y), wrapped */
+  template <class T>
+  static T extend( const T x, const T y )
+  {
+    return (T)(((uint64_t)y << 1) - (uint64_t)x);
+  }
+
+#if defined(__AVX2__)
+  /** the number of int (and int16_t) values in a vector */
+  typedef enum { vecLen = 8, vecLen16 = 16 } bogus;
+
+  /** load eight values (no alignment is required) */
+  static __m256i load( const int *p )
+  {
+    return _mm256_loadu_si256( (const __m256i *)p );
+  }
+
+  /** store eight values (no alignment is required) */
+  static void store( int *p, const __m256i v )
+  {
+    _mm256_storeu_si256( (__m256i *)p, v );
+  }
+
+  /** vector version of roundHalf */
+  static __m256i roundHalf( __m256i s )
+  {
+    s = _mm256_add_epi32( s, _mm256_set1_epi32( 1 ) );
+    return _mm256_srai_epi32( _mm256_add_epi32( s, _mm256_srli_epi32( s, 31 ) ), 1 );
+  }
+
+  /** vector version of roundQuarter */
+  static __m256i roundQuarter( __m256i s )
+  {
+    s = _mm256_add_epi32( s, _mm256_set1_epi32( 2 ) );
+    __m256i bias = _mm256_and_si256( _mm256_srai_epi32( s, 31 ),
+                                     _mm256_set1_epi32( 3 ) );
+    return _mm256_srai_epi32( _mm256_add_epi32( s, bias ), 2 );
+  }
+
+  /** vector version of plusMinus */
+  static __m256i plusMinus( const __m256i x, const __m256i v, const bool plus )
+  {
+    return plus ? _mm256_add_epi32( x, v ) : _mm256_sub_epi32( x, v );
+  }
+
+  /** load sixteen int16_t values */
+  static __m256i load( const int16_t *p )
+  {
+    return _mm256_loadu_si256( (const __m256i *)p );
+  }
+
+  /** store sixteen int16_t values */
+  static void store( int16_t *p, const __m256i v )
+  {
+    _mm256_storeu_si256( (__m256i *)p, v );
+  }
+
+  /** roundHalf on sixteen int16_t values */
+  static __m256i roundHalf16( __m256i s )
+  {
+    s = _mm256_add_epi16( s, _mm256_set1_epi16( 1 ) );
+    return _mm256_srai_epi16( _mm256_add_epi16( s, _mm256_srli_epi16( s, 15 ) ), 1 );
+  }
+
+  /** roundQuarter on sixteen int16_t values */
+  static __m256i roundQuarter16( __m256i s )
+  {
+    s = _mm256_add_epi16( s, _mm256_set1_epi16( 2 ) );
+    __m256i bias = _mm256_and_si256( _mm256_srai_epi16( s, 15 ),
+                                     _mm256_set1_epi16( 3 ) );
+    return _mm256_srai_epi16( _mm256_add_epi16( s, bias ), 2 );
+  }
+
+  /** plusMinus on sixteen int16_t values */
+  static __m256i plusMinus16( const __m256i x, const __m256i v, const bool plus )
+  {
+    return plus ? _mm256_add_epi16( x, v ) : _mm256_sub_epi16( x, v );
+  }
+#endif
+
+}; // intlift
+
+#endif
@@ -39,6 +39,7 @@
 
 #include "stdio.h"
 #include "liftbase.h"
+#include "intlift.h"
 
 
 /**
@@ -55,9 +56,17 @@
   the mean.  That is, when the transform is calculated, the first
   element of the result array will not be the mean.
 
+  The second template argument is the integer type of the data
+  elements (int by default; int16_t and int64_t are also supported).
+  The arithmetic wraps at the width of this type (the sums are
+  calculated with the intlift functions, in an unsigned type), so the
+  forward and inverse transforms are exact inverses of each other for
+  any input values.  The AVX2 kernels calculate eight int or sixteen int16_t
+  elements at a time.  The int64_t version uses the scalar loops.
+
  */
-template<class T>
-class line_int : public liftbase<T, int>
+template<class T, class T_elem = int>
+class line_int : public liftbase<T, T_elem>
 {
 public:
   /** the constructor does nothing */
@@ -71,9 +80,9 @@ private:
     Given y1 at x-coordinate 0 and y2 at x-coordinate
     1, calculate y, at x-coordinate 2.
    */
-   int new_n_plus1( int y1, int y2)
+   T_elem new_n_plus1( T_elem y1, T_elem y2)
    {
-     int y = 2 * y2 - y1;
+     T_elem y = intlift::extend( y1, y2 );
      return y;
    }
 
@@ -82,9 +91,9 @@ private:
     Given a point y1 at x-coordinate 0 and y2 at x-coordinate 1,
     calculate y at x-coordinate -1.
    */
-  int new_n_minus1( int y1, int y2)
+  T_elem new_n_minus1( T_elem y1, T_elem y2)
   {
-    int y = 2 * y1 - y2;
+    T_elem y = intlift::extend( y2, y1 );
     return y;
   }
 
@@ -128,16 +137,21 @@ protected:
     the same as the Haar wavelet.  We "predict" that the odd value
     vec[1] will be the same as the even value, vec[0].
 
+    The prediction (a<sub>j,i</sub> + a<sub>j,i+1</sub>)/2 is rounded
+    with integer shifts and adds (see intlift::roundHalf).  This
+    function works on any object that acts like an array and is the
+    reference version of predictSpan.
+
    */
   void predict( T & vec, int N, transDirection direction )
   {
     int half = N >> 1;
-    int predictVal;
+    T_elem predictVal;
 
     for (int i = 0; i < half; i++) {
       int j = i + half;
       if (i < half-1) {
-	predictVal = (int)((((float)vec[i] + (float)vec[i+1])/2.0) + 0.5);
+	predictVal = intlift::roundHalf( intlift::add<T_elem>( vec[i], vec[i+1] ) );
       }
       else if (N == 2) {
 	predictVal = vec[0];
@@ -145,15 +159,15 @@ protected:
       else {
 	// i == half-1
 	// Calculate the last "odd" prediction
-	int n_plus1 = new_n_plus1( vec[i-1], vec[i] );
-	predictVal = (int)((((float)vec[i] + (float)n_plus1)/2.0) + 0.5);
+	T_elem n_plus1 = new_n_plus1( vec[i-1], vec[i] );
+	predictVal = intlift::roundHalf( intlift::add<T_elem>( vec[i], n_plus1 ) );
       }
 
       if (direction == forward) {
-	vec[j] = vec[j] - predictVal;
+	vec[j] = intlift::plusMinus( (T_elem)vec[j], predictVal, false );
       }
       else if (direction == inverse) {
-	vec[j] = vec[j] + predictVal;
+	vec[j] = intlift::plusMinus( (T_elem)vec[j], predictVal, true );
       }
       else {
 	printf("line::predict: bad direction value\n");
@@ -230,6 +244,8 @@ protected:
     Because interpolated values are used, the average is not
     perfectly maintained.
 
+    This function is the reference version of updateSpan.
+
   */
   void update( T & vec, int N, transDirection direction )
   {
@@ -237,23 +253,23 @@ protected:
 
     for (int i = 0; i < half; i++) {
       int j = i + half;
-      int val;
+      T_elem val;
 
       if (i == 0 && N == 2) {
-	val = (int)(((float)vec[j]/2.0) + 0.5);
+	val = intlift::roundHalf( (T_elem)vec[j] );
       }
       else if (i == 0 && N > 2) {
-	int v_n_minus_1 = new_n_minus1( vec[j], vec[j+1] );
-	val = (int)((((float)v_n_minus_1 + (float)vec[j])/4.0) + 0.5);
+	T_elem v_n_minus_1 = new_n_minus1( vec[j], vec[j+1] );
+	val = intlift::roundQuarter( intlift::add<T_elem>( v_n_minus_1, vec[j] ) );
       }
       else {
-	val = (int)((((float)vec[j-1] + (float)vec[j])/4.0) + 0.5);
+	val = intlift::roundQuarter( intlift::add<T_elem>( vec[j-1], vec[j] ) );
       }
       if (direction == forward) {
-	vec[i] = vec[i] + val;
+	vec[i] = intlift::plusMinus( (T_elem)vec[i], val, true );
       }
       else if (direction == inverse) {
-	vec[i] = vec[i] - val;
+	vec[i] = intlift::plusMinus( (T_elem)vec[i], val, false );
       }
       else {
 	printf("update: bad direction value\n");
@@ -262,6 +278,177 @@ protected:
   } // update
 
 
+  /**
+    The vector part of predictSpan.  Returns the index of the first
+    element that was not calculated (zero if there is no vector
+    version of the loop for the element type).
+   */
+  template <class E>
+  static int predictVec( const E *lhs, E *rhs, const int last, const bool plus )
+  {
+    return 0;
+  }
+
+  /** The vector part of updateSpan (see predictVec) */
+  template <class E>
+  static int updateVec( E *lhs, const E *rhs, const int half, const bool plus )
+  {
+    return 1;
+  }
+
+#if defined(__AVX2__)
+  /** predictVec for int, eight elements at a time */
+  static int predictVec( const int *lhs, int *rhs, const int last, const bool plus )
+  {
+    int i = 0;
+    for (; i + intlift::vecLen <= last; i += intlift::vecLen) {
+      __m256i sum = _mm256_add_epi32( intlift::load( lhs + i ), 
+                                      intlift::load( lhs + i + 1 ) );
+      intlift::store( rhs + i, intlift::plusMinus( intlift::load( rhs + i ),
+                                                   intlift::roundHalf( sum ),
+                                                   plus ) );
+    }
+    return i;
+  } // predictVec
+
+  /** predictVec for int16_t, sixteen elements at a time */
+  static int predictVec( const int16_t *lhs, int16_t *rhs, const int last, const bool plus )
+  {
+    int i = 0;
+    for (; i + intlift::vecLen16 <= last; i += intlift::vecLen16) {
+      __m256i sum = _mm256_add_epi16( intlift::load( lhs + i ), 
+                                      intlift::load( lhs + i + 1 ) );
+      intlift::store( rhs + i, intlift::plusMinus16( intlift::load( rhs + i ),
+                                                     intlift::roundHalf16( sum ),
+                                                     plus ) );
+    }
+    return i;
+  } // predictVec
+
+  /** updateVec for int, eight elements at a time */
+  static int updateVec( int *lhs, const int *rhs, const int half, const bool plus )
+  {
+    int i = 1;
+    for (; i + intlift::vecLen <= half; i += intlift::vecLen) {
+      __m256i sum = _mm256_add_epi32( intlift::load( rhs + i - 1 ), 
+                                      intlift::load( rhs + i ) );
+      intlift::store( lhs + i, intlift::plusMinus( intlift::load( lhs + i ),
+                                                   intlift::roundQuarter( sum ),
+                                                   plus ) );
+    }
+    return i;
+  } // updateVec
+
+  /** updateVec for int16_t, sixteen elements at a time */
+  static int updateVec( int16_t *lhs, const int16_t *rhs, const int half, const bool plus )
+  {
+    int i = 1;
+    for (; i + intlift::vecLen16 <= half; i += intlift::vecLen16) {
+      __m256i sum = _mm256_add_epi16( intlift::load( rhs + i - 1 ), 
+                                      intlift::load( rhs + i ) );
+      intlift::store( lhs + i, intlift::plusMinus16( intlift::load( lhs + i ),
+                                                     intlift::roundQuarter16( sum ),
+                                                     plus ) );
+    }
+    return i;
+  } // updateVec
+#endif
+
+  /**
+    Predict step on raw arrays.  The even elements are in <i>lhs</i>
+    and the odd elements are in <i>rhs</i>.  The calculation is the
+    same as predict, but the special case at the end of the array is
+    peeled off of the loop and, when there is a vector version of
+    the loop for the element type (see predictVec), most of the
+    elements are calculated by the vector loop.
+   */
+  static void predictSpan( const T_elem *lhs, 
+                           T_elem *rhs, 
+                           const int half, 
+                           transDirection direction )
+  {
+    const bool plus = (direction == inverse);
+    const int last = half - 1;
+    T_elem predictVal;
+    int i = predictVec( lhs, rhs, last, plus );
+
+    for (; i < last; i++) {
+      predictVal = intlift::roundHalf( intlift::add( lhs[i], lhs[i+1] ) );
+      rhs[i] = intlift::plusMinus( rhs[i], predictVal, plus );
+    }
+
+    // the last "odd" prediction
+    if (half == 1) {
+      predictVal = lhs[0];
+    }
+    else {
+      T_elem n_plus1 = intlift::extend( lhs[last-1], lhs[last] );
+      predictVal = intlift::roundHalf( intlift::add( lhs[last], n_plus1 ) );
+    }
+    rhs[last] = intlift::plusMinus( rhs[last], predictVal, plus );
+  } // predictSpan
+
+
+  /**
+    Update step on raw arrays.  The calculation is the same as
+    update, with the special case at the start of the array peeled
+    off of the loop.
+   */
+  static void updateSpan( T_elem *lhs, 
+                          const T_elem *rhs, 
+                          const int half, 
+                          transDirection direction )
+  {
+    const bool plus = (direction == forward);
+    T_elem val;
+
+    // the first element
+    if (half == 1) {
+      val = intlift::roundHalf( rhs[0] );
+    }
+    else {
+      T_elem v_n_minus_1 = intlift::extend( rhs[1], rhs[0] );
+      val = intlift::roundQuarter( intlift::add( v_n_minus_1, rhs[0] ) );
+    }
+    lhs[0] = intlift::plusMinus( lhs[0], val, plus );
+
+    int i = updateVec( lhs, rhs, half, plus );
+
+    for (; i < half; i++) {
+      val = intlift::roundQuarter( intlift::add( rhs[i-1], rhs[i] ) );
+      lhs[i] = intlift::plusMinus( lhs[i], val, plus );
+    }
+  } // updateSpan
+
+public:
+
+  /**
+    Forward step on raw arrays (used by the integer wavelet packet
+    tree)
+   */
+  bool forwardSpan( const T_elem *src, T_elem *lhs, T_elem *rhs, const int n )
+  {
+    const int half = n >> 1;
+
+    splitHalves( src, lhs, rhs, n );
+    predictSpan( lhs, rhs, half, forward );
+    updateSpan( lhs, rhs, half, forward );
+    return true;
+  } // forwardSpan
+
+  /**
+    Inverse step on raw arrays
+   */
+  bool inverseSpan( T_elem *lhs, T_elem *rhs, T_elem *dst, const int n )
+  {
+    const int half = n >> 1;
+
+    updateSpan( lhs, rhs, half, inverse );
+    predictSpan( lhs, rhs, half, inverse );
+    mergeHalves( lhs, rhs, dst, n );
+    return true;
+  } // inverseSpan
+
 }; // line_int
 
 
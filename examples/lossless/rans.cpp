@@ -0,0 +1,314 @@
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "rans.h"
+#include "bitpack.h"
+
+
+/**
+  Scale the token counts so that they add up to probScale.  Every
+  token that occurs gets a frequency of at least one.  The rounding
+  error is added to (or taken from) the most frequent token.
+ */
+void rans::normalize( const size_t *count,
+                      const size_t numSyms,
+                      const size_t n,
+                      unsigned int *freq )
+{
+  unsigned int sum = 0;
+  size_t maxSym = 0;
+  for (size_t t = 0; t < numSyms; t++) {
+    freq[t] = 0;
+    if (count[t] > 0) {
+      freq[t] = (unsigned int)((count[t] * probScale) / n);
+      if (freq[t] == 0) {
+        freq[t] = 1;
+      }
+    }
+    sum = sum + freq[t];
+    if (count[t] > count[maxSym]) {
+      maxSym = t;
+    }
+  }
+  freq[maxSym] = freq[maxSym] + probScale - sum;
+} // normalize
+
+
+/**
+  Store the <i>n</i> values in <i>vec</i> in <i>buf</i>, entropy
+  coded if that is smaller than bit packing.  The buffer must have
+  room for bitpack::frameBytes( vec, n ) bytes.  Returns the number
+  of bytes written.
+ */
+size_t rans::pack( const int *vec, const size_t n, unsigned char *buf )
+{
+  const size_t packLen = bitpack::frameBytes( vec, n );
+  if (n < minLen) {
+    return bitpack::pack( vec, n, buf );
+  }
+
+  // the reference is the middle of the range, so the differences of
+  // a subband that is centered on zero are small
+  int minVal = vec[0];
+  int maxVal = vec[0];
+  for (size_t i = 1; i < n; i++) {
+    if (vec[i] < minVal) minVal = vec[i];
+    if (vec[i] > maxVal) maxVal = vec[i];
+  }
+  const int ref = (int)(((long long)minVal + (long long)maxVal) / 2);
+
+  unsigned char *token = new unsigned char[ n ];
+  size_t count[ numTokens ];
+  memset( count, 0, sizeof( count ) );
+  size_t numSyms = 1;
+  size_t extraBits = 0;
+  for (size_t i = 0; i < n; i++) {
+    const unsigned int z = bitpack::zigzag( (int)((unsigned int)vec[i] - (unsigned int)ref) );
+    const unsigned int t = bitpack::bitWidth( z );
+    token[i] = (unsigned char)t;
+    count[t]++;
+    if (t + 1 > numSyms) {
+      numSyms = t + 1;
+    }
+    extraBits = extraBits + ((t > 0) ? t - 1 : 0);
+  }
+
+  unsigned int freq[ numTokens ];
+  unsigned int cum[ numTokens ];
+  normalize( count, numSyms, n, freq );
+  cum[0] = 0;
+  for (size_t t = 1; t < numSyms; t++) {
+    cum[t] = cum[t-1] + freq[t-1];
+  }
+
+  // rANS encode the tokens backwards.  A token costs at most
+  // probBits bits, plus the final states.
+  const size_t maxRans = (n * 2) + (numStates * 4) + 16;
+  unsigned char *ransBuf = new unsigned char[ maxRans ];
+  unsigned char *end = ransBuf + maxRans;
+  unsigned char *p = end;
+  unsigned int state[ numStates ];
+  for (size_t s = 0; s < numStates; s++) {
+    state[s] = (unsigned int)stateLow;
+  }
+  for (size_t i = n; i > 0; i--) {
+    const unsigned int t = token[i-1];
+    unsigned int x = state[(i-1) & (numStates-1)];
+    const unsigned int xMax = (((unsigned int)stateLow >> probBits) << 8) * freq[t];
+    while (x >= xMax) {
+      *--p = (unsigned char)(x & 0xff);
+      x = x >> 8;
+    }
+    x = ((x / freq[t]) << probBits) + (x % freq[t]) + cum[t];
+    state[(i-1) & (numStates-1)] = x;
+  }
+  for (size_t s = numStates; s > 0; s--) {
+    const unsigned int x = state[s-1];
+    *--p = (unsigned char)(x >> 24);
+    *--p = (unsigned char)(x >> 16);
+    *--p = (unsigned char)(x >> 8);
+    *--p = (unsigned char)x;
+  }
+  const size_t ransLen = (size_t)(end - p);
+
+  size_t tableLen = 1;
+  unsigned char scratch[ bitpack::maxVarintBytes ];
+  for (size_t t = 0; t < numSyms; t++) {
+    tableLen += bitpack::putVarint( scratch, freq[t] );
+  }
+  const size_t totalLen = 1 + bitpack::putVarint( scratch, bitpack::zigzag( ref ) ) +
+                          tableLen + bitpack::putVarint( scratch, (unsigned int)ransLen ) +
+                          ransLen + ((extraBits + 7) >> 3);
+
+  size_t len = 0;
+  if (totalLen >= packLen) {
+    len = bitpack::pack( vec, n, buf );
+  }
+  else {
+    buf[len++] = (unsigned char)ransTag;
+    len += bitpack::putVarint( buf + len, bitpack::zigzag( ref ) );
+    buf[len++] = (unsigned char)numSyms;
+    for (size_t t = 0; t < numSyms; t++) {
+      len += bitpack::putVarint( buf + len, freq[t] );
+    }
+    len += bitpack::putVarint( buf + len, (unsigned int)ransLen );
+    memcpy( buf + len, p, ransLen );
+    len = len + ransLen;
+
+    // the extra bits, low order bits first
+    unsigned char *bits = buf + len;
+    memset( bits, 0, (extraBits + 7) >> 3 );
+    unsigned long long acc = 0;
+    size_t accBits = 0;
+    size_t pos = 0;
+    for (size_t i = 0; i < n; i++) {
+      const unsigned int t = token[i];
+      if (t > 1) {
+        const unsigned int z = bitpack::zigzag( (int)((unsigned int)vec[i] - (unsigned int)ref) );
+        acc = acc | ((unsigned long long)(z & bitpack::mask( t - 1 )) << accBits);
+        accBits = accBits + (t - 1);
+        while (accBits >= 8) {
+          bits[pos++] = (unsigned char)(acc & 0xff);
+          acc = acc >> 8;
+          accBits = accBits - 8;
+        }
+      }
+    }
+    if (accBits > 0) {
+      bits[pos++] = (unsigned char)acc;
+    }
+    len = len + pos;
+  }
+
+  delete [] ransBuf;
+  delete [] token;
+  return len;
+} // pack
+
+
+/**
+  Unpack <i>n</i> values that were stored by pack() into
+  <i>vec</i>.  Returns the number of bytes read or zero if the data
+  in <i>buf</i> is too short or is not valid.
+ */
+size_t rans::unpack( const unsigned char *buf,
+                     const size_t len,
+                     int *vec,
+                     const size_t n )
+{
+  if (len == 0) {
+    return 0;
+  }
+  if (buf[0] != ransTag) {
+    return bitpack::unpack( buf, len, vec, n );
+  }
+
+  size_t pos = 1;
+  unsigned int zref;
+  size_t varLen = bitpack::getVarint( buf + pos, len - pos, zref );
+  if (varLen == 0 || pos + varLen >= len) {
+    return 0;
+  }
+  pos = pos + varLen;
+  const int ref = bitpack::unzigzag( zref );
+
+  const size_t numSyms = buf[pos++];
+  if (numSyms == 0 || numSyms > numTokens) {
+    return 0;
+  }
+  unsigned int freq[ numTokens ];
+  unsigned int cum[ numTokens ];
+  unsigned int sum = 0;
+  for (size_t t = 0; t < numSyms; t++) {
+    varLen = bitpack::getVarint( buf + pos, len - pos, freq[t] );
+    if (varLen == 0 || freq[t] > probScale) {
+      return 0;
+    }
+    pos = pos + varLen;
+    cum[t] = sum;
+    sum = sum + freq[t];
+  }
+  unsigned int ransLen;
+  varLen = bitpack::getVarint( buf + pos, len - pos, ransLen );
+  if (sum != probScale || varLen == 0 || ransLen < numStates * 4 ||
+      ransLen > len - pos - varLen) {
+    return 0;
+  }
+  pos = pos + varLen;
+
+  // the token of each slot of the probability scale
+  unsigned char slotToken[ probScale ];
+  for (size_t t = 0; t < numSyms; t++) {
+    memset( slotToken + cum[t], (int)t, freq[t] );
+  }
+
+  const unsigned char *p = buf + pos;
+  const unsigned char *end = p + ransLen;
+  unsigned int state[ numStates ];
+  for (size_t s = 0; s < numStates; s++) {
+    state[s] = (unsigned int)p[0] | ((unsigned int)p[1] << 8) |
+               ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+    p = p + 4;
+  }
+
+  // the extra bits start after the rANS bytes
+  const unsigned char *bits = end;
+  const size_t bitsLen = len - (pos + ransLen);
+  size_t bitPos = 0;
+  unsigned long long acc = 0;
+  size_t accBits = 0;
+  bool ok = true;
+
+  for (size_t i = 0; i < n && ok; i++) {
+    unsigned int x = state[i & (numStates-1)];
+    const unsigned int slot = x & (probScale - 1);
+    const unsigned int t = slotToken[ slot ];
+    x = (freq[t] * (x >> probBits)) + slot - cum[t];
+    while (x < (unsigned int)stateLow && p < end) {
+      x = (x << 8) | *p++;
+    }
+    state[i & (numStates-1)] = x;
+
+    unsigned int z = 0;
+    if (t > 0) {
+      const unsigned int numExtra = t - 1;
+      while (accBits < numExtra && bitPos < bitsLen) {
+        acc = acc | ((unsigned long long)bits[bitPos++] << accBits);
+        accBits = accBits + 8;
+      }
+      if (accBits < numExtra) {
+        ok = false;
+      }
+      z = (1u << numExtra) | (unsigned int)(acc & bitpack::mask( numExtra ));
+      acc = acc >> numExtra;
+      accBits = accBits - numExtra;
+    }
+    vec[i] = (int)((unsigned int)ref + (unsigned int)bitpack::unzigzag( z ));
+  }
+
+  // a valid stream ends with all of the rANS bytes read and the
+  // states back at their initial value
+  for (size_t s = 0; s < numStates; s++) {
+    if (state[s] != (unsigned int)stateLow) {
+      ok = false;
+    }
+  }
+  if (p != end) {
+    ok = false;
+  }
+  return ok ? pos + ransLen + bitPos : 0;
+} // unpack
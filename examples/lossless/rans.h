@@ -0,0 +1,115 @@
+
+#ifndef _RANS_H_
+#define _RANS_H_
+
+#include <stddef.h>
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+
+/**
+  Entropy coding of a subband with a table based rANS (range
+  asymmetric numeral system) coder.
+
+  Bit packing (see bitpack) stores every element of a subband in
+  the width of the largest element.  The coefficients produced by
+  the lifting wavelets are peaked around zero, so most of them need
+  far fewer bits than the largest one.  This class codes each
+  element as a <i>token</i>, the number of significant bits in the
+  zig-zag encoded difference from a reference value (0..32), and
+  the bits below the leading one bit of the difference (the "extra"
+  bits), which are stored as they are.  The tokens are entropy
+  coded with rANS using a frequency table that is calculated for the
+  subband, so each best basis node of a wavelet packet tree gets its
+  own table.
+
+  The tokens are coded with four interleaved rANS states (element
+  <i>i</i> uses state <i>i</i> % 4).  The coder is the byte
+  oriented rANS with 32-bit states and a probability scale of
+  2<sup>12</sup>.  The encoder runs backwards over the subband and
+  the decoder forwards.
+
+  The format of a subband is
+
+  <pre>
+     1 byte    ransTag (0xff)
+     varint    zig-zag encoded reference value
+     1 byte    number of tokens in the frequency table (1..33)
+     varints   the frequency of each token (the sum is 4096)
+     varint    length of the rANS bytes
+     ...       the rANS bytes (the four initial states come first)
+     ...       the extra bits, low order bits first
+  </pre>
+
+  A subband that is short, or that would not be smaller when
+  entropy coded, is stored with bitpack::pack instead.  The first
+  byte of a bit packed subband is the width (0..32), so unpack can
+  tell the two formats apart.  The result is never larger than the
+  bit packed subband, so the buffer sizes of bitpack apply.
+
+  All of the functions are static.  The constructor and destructor
+  are declared but not defined, as in the <tt>support</tt> class.
+ */
+class rans
+{
+public:
+  typedef enum { ransTag = 0xff,
+                 numTokens = 33,
+                 numStates = 4,
+                 probBits = 12,
+                 probScale = 1 << 12,
+                 minLen = 32,
+                 stateLow = 1 << 23 } bogus;
+
+private:
+  static void normalize( const size_t *count,
+                         const size_t numSyms,
+                         const size_t n,
+                         unsigned int *freq );
+
+public:
+  /** declare but do not define the constructor */
+  rans();
+  /** declare but do not define the destructor */
+  ~rans();
+
+  static size_t pack( const int *vec, const size_t n, unsigned char *buf );
+
+  static size_t unpack( const unsigned char *buf,
+                        const size_t len,
+                        int *vec,
+                        const size_t n );
+}; // rans
+
+#endif
@@ -184,3 +184,40 @@ size_t support::vecWidth( const int *vec, const size_t N )
   }
   return totalWidth;
 } // vecWidth( int *)
+
+
+/**
+  Calculate the number of bits needed to represent a 64-bit
+  integer value (e.g., a trading volume), with a sign bit, as in
+  valWidth( int ).
+ */
+size_t support::valWidth( const int64_t val )
+{
+  const uint64_t wholeNum = (val < 0) ? (uint64_t)0 - (uint64_t)val : (uint64_t)val;
+  size_t width = 1;
+  if (wholeNum > 0) {
+    width++;
+    uint64_t power = 1;
+    while (power < wholeNum && width < 65) {
+      power = power << 1;
+      width++;
+    }
+  }
+  return width;
+} // valWidth( int64_t )
+
+
+/**
+  Calculate the minimum number of bits needed to represent the
+  values in a 64-bit integer vector.
+ */
+size_t support::vecWidth( const int64_t *vec, const size_t N )
+{
+  size_t totalWidth = 0;
+  if (vec != 0) {
+    for (size_t i = 0; i < N; i++) {
+      totalWidth += valWidth( vec[i] );
+    }
+  }
+  return totalWidth;
+} // vecWidth( int64_t *)
@@ -2,6 +2,8 @@
 #ifndef _SUPPORT_H_
 #define _SUPPORT_H_
 
+#include <stdint.h>
+
 
 /** \file
 
@@ -87,6 +89,11 @@ public:
 
   static size_t vecWidth( const int *vec, 
 				const size_t N );
+
+  static size_t valWidth( const int64_t val );
+
+  static size_t vecWidth( const int64_t *vec, 
+			  const size_t N );
   static void roundToInt( int *intVec, 
 			  const double *realVec, 
 			  const size_t len );
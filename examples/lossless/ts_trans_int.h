@@ -80,7 +80,7 @@
   functions.  An additional <tt>predict2()</tt> function is added
   that implements interpolation step.
 
-  Since an extra step has been added, the <tt>forwardStep</tt> and
+  Since an extra step has been added, the <tt>forwardLift</tt> and
   <tt>inverseStep</tt> functions in the base class (<tt>liftbase</tt>)
   are over-ridden by ts_trans_int.
 
@@ -217,61 +217,73 @@ protected:
     calculation is the same as the Haar wavelet (e.g., no
     interpolation factor is added in).
 
+    The interpolation value is
+
+    <pre>
+    floor((y<sub>n-1</sub> - y<sub>n+1</sub>)/4.0 + 0.5)
+    </pre>
+
+    which is calculated with integer shifts and adds (see
+    intlift::roundQuarter).  The special cases at the start and the
+    end of the array are peeled off of the loop, so the loop over
+    the interior elements has no branches.  When the code is
+    compiled for AVX2 the interior elements are calculated eight at
+    a time.
    */
   void predict2( int *& vec, int N, transDirection direction )
   {
-    int half = N >> 1;
-    int predictVal;
-
-    for (int i = 0; i < half; i++) {
-      int j = i + half;
-      int y_n_plus1;
-      int y_n_minus1;
-
-      if (N == 2) {
-	y_n_minus1 = vec[0];
-	y_n_plus1 = vec[0];
-      }
-      else if (i == 0) {
-	y_n_minus1 = new_n_minus1( vec[0], vec[1] );
-	y_n_plus1 = vec[1];
-      }
-      else if (i < half-1) {
-	y_n_minus1 = vec[i-1];
-	y_n_plus1  = vec[i+1];
+    const int half = N >> 1;
+    const bool fwd = (direction == forward);
+    const int *s = vec;
+    int *d = vec + half;
+
+    if (N == 2) {
+      // y_n_minus1 == y_n_plus1 == vec[0]
+      d[0] = intlift::plusMinus( d[0], intlift::roundQuarter( 0 ), fwd );
+    }
+    else if (half > 1) {
+      const int last = half - 1;
+      // the first element, i == 0
+      int y_n_minus1 = new_n_minus1( s[0], s[1] );
+      int predictVal = intlift::roundQuarter( y_n_minus1 - s[1] );
+      d[0] = intlift::plusMinus( d[0], predictVal, fwd );
+
+      // the interior elements, 0 < i < half-1
+      int i = 1;
+#if defined(__AVX2__)
+      for (; i + intlift::vecLen <= last; i += intlift::vecLen) {
+        __m256i diff = _mm256_sub_epi32( intlift::load( s + i - 1 ),
+                                         intlift::load( s + i + 1 ) );
+        intlift::store( d + i, intlift::plusMinus( intlift::load( d + i ),
+                                                   intlift::roundQuarter( diff ),
+                                                   fwd ) );
       }
-      else { // i == half-1
-	y_n_minus1 = vec[i-1];
-	y_n_plus1  = new_n_plus1( vec[i-1], vec[i] );
+#endif
+      for (; i < last; i++) {
+        predictVal = intlift::roundQuarter( s[i-1] - s[i+1] );
+        d[i] = intlift::plusMinus( d[i], predictVal, fwd );
       }
 
-      predictVal = (int)( (((float)y_n_minus1 - (float)y_n_plus1)/4.0) + 0.5 );
-
-      if (direction == forward) {
-	vec[j] = vec[j] + predictVal;
-      }
-      else if (direction == inverse) {
-	vec[j] = vec[j] - predictVal;
-      }
-      else {
-	printf("haar_int::predict: bad direction value\n");
-      }
-    }      
+      // the last element, i == half-1
+      int y_n_plus1 = new_n_plus1( s[last-1], s[last] );
+      predictVal = intlift::roundQuarter( s[last-1] - y_n_plus1 );
+      d[last] = intlift::plusMinus( d[last], predictVal, fwd );
+    }
   } // predict2
 
-public:
   /**
-    One TS transform forward step.  This extends the S transform
-    (Haar integer transform) with the predict2 step.
+    The lifting steps of one TS transform forward step.  This extends
+    the S transform (Haar integer transform) with the predict2 step.
+    The split step is applied by forwardStep in the base class.
    */
-  void forwardStep( int *& vec, const int n )
+  void forwardLift( int *& vec, const int n )
   {
-    split( vec, n );
     predict( vec, n, forward );
     update( vec, n, forward );
     predict2( vec, n, forward );
-  } // forwardStep
+  } // forwardLift
 
+public:
   /**
     One TS transform inverse step.  This extends the S transform
     (Haar integer transform) with the predict2 step.
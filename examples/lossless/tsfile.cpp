@@ -0,0 +1,493 @@
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "tsfile.h"
+#include "bitpack.h"
+
+
+/** write a 32-bit value, low order byte first */
+static void put32( unsigned char *buf, const size_t val )
+{
+  buf[0] = (unsigned char)(val & 0xff);
+  buf[1] = (unsigned char)((val >> 8) & 0xff);
+  buf[2] = (unsigned char)((val >> 16) & 0xff);
+  buf[3] = (unsigned char)((val >> 24) & 0xff);
+} // put32
+
+
+/** read a 32-bit value, low order byte first */
+static size_t get32( const unsigned char *buf )
+{
+  return (size_t)buf[0] | ((size_t)buf[1] << 8) |
+         ((size_t)buf[2] << 16) | ((size_t)buf[3] << 24);
+} // get32
+
+
+/** write a 64-bit value, low order byte first */
+static void put64( unsigned char *buf, const unsigned long long val )
+{
+  put32( buf, (size_t)(val & 0xffffffff) );
+  put32( buf + 4, (size_t)(val >> 32) );
+} // put64
+
+
+/** read a 64-bit value, low order byte first */
+static unsigned long long get64( const unsigned char *buf )
+{
+  return (unsigned long long)get32( buf ) | ((unsigned long long)get32( buf + 4 ) << 32);
+} // get64
+
+
+tsfile::tsfile()
+{
+  base = 0;
+  fileLen = 0;
+#if defined(_WIN32)
+  fileHandle = INVALID_HANDLE_VALUE;
+  mapHandle = 0;
+#else
+  fd = -1;
+#endif
+  blockLen_ = 0;
+  numBlocks_ = 0;
+  N_ = 0;
+  entropy = false;
+  index = 0;
+  blocksDecoded_ = 0;
+} // tsfile
+
+
+tsfile::~tsfile()
+{
+  close();
+} // ~tsfile
+
+
+/**
+  Encode one block: the values with intcodec and the timestamps as
+  delta coded offsets from the first timestamp.  On entry <i>len</i>
+  is the position in <i>buf</i> and on exit it is the position after
+  the block.
+ */
+bool tsfile::encodeBlock( const long long *times,
+                          const int *vec,
+                          const size_t n,
+                          const intcodec::codecKind kind,
+                          const bool entropy,
+                          unsigned char *buf,
+                          size_t &len )
+{
+  const size_t maxBlock = intcodec::maxBlockBytes( n );
+  unsigned char *body = new unsigned char[ maxBlock ];
+  int *offsets = new int[ n ];
+  bool ok = true;
+
+  for (size_t i = 0; i < n && ok; i++) {
+    const long long diff = times[i] - times[0];
+    if (diff < 0 || diff > 0x7fffffff || (i > 0 && times[i] < times[i-1])) {
+      printf("tsfile::write: the timestamps decrease or are too far apart\n");
+      ok = false;
+    }
+    offsets[i] = (int)diff;
+  }
+
+  // a block that is not a power of two can only be delta coded
+  intcodec::codecKind blockKind = kind;
+  if (kind != intcodec::Smallest && (n & (n - 1)) != 0) {
+    blockKind = intcodec::Delta;
+  }
+
+  size_t bodyLen = 0;
+  if (ok) {
+    bodyLen = intcodec::encodeBlock( vec, n, blockKind, body, maxBlock, entropy );
+    ok = (bodyLen > 0);
+  }
+  if (ok) {
+    buf[len++] = (unsigned char)blockKind;
+    len += bitpack::putVarint( buf + len, (unsigned int)bodyLen );
+    memcpy( buf + len, body, bodyLen );
+    len = len + bodyLen;
+
+    intcodec::codecKind timeKind = intcodec::Delta;
+    bodyLen = intcodec::encodeBlock( offsets, n, timeKind, body, maxBlock, entropy );
+    ok = (bodyLen > 0);
+  }
+  if (ok) {
+    len += bitpack::putVarint( buf + len, (unsigned int)bodyLen );
+    memcpy( buf + len, body, bodyLen );
+    len = len + bodyLen;
+  }
+
+  delete [] offsets;
+  delete [] body;
+  return ok;
+} // encodeBlock
+
+
+/**
+  Write the <i>N</i> samples (<i>times</i> and <i>vec</i>) to the
+  file <i>path</i>, in blocks of <i>blockLenArg</i> samples (or <i>N</i>
+  samples, if <i>N</i> is smaller).  The values in each block are
+  encoded with the transform <i>kind</i> (or the smallest transform,
+  for intcodec::Smallest) and are entropy coded if <i>entropy</i> is
+  true.  Returns false if there is an error.
+ */
+bool tsfile::write( const char *path,
+                    const long long *times,
+                    const int *vec,
+                    const size_t N,
+                    const size_t blockLenArg,
+                    const intcodec::codecKind kind,
+                    const bool entropy )
+{
+  if (path == 0 || times == 0 || vec == 0 || N == 0 || blockLenArg == 0 ||
+      kind <= intcodec::BadKind || kind > intcodec::Smallest) {
+    printf("tsfile::write: bad arguments\n");
+    return false;
+  }
+
+  FILE *fp = fopen( path, "wb" );
+  if (fp == 0) {
+    printf("tsfile::write: could not open %s\n", path );
+    return false;
+  }
+
+  // a block is never longer than the series (open checks this)
+  const size_t blockLen = (blockLenArg < N) ? blockLenArg : N;
+  const size_t numBlocks = (N + blockLen - 1) / blockLen;
+  const size_t maxBlock = 1 + (2 * bitpack::maxVarintBytes) + (2 * intcodec::maxBlockBytes( blockLen ));
+  unsigned char *buf = new unsigned char[ maxBlock ];
+  unsigned char *index = new unsigned char[ numBlocks * indexBytes ];
+  unsigned char header[ headerBytes ];
+
+  memset( header, 0, headerBytes );
+  bool ok = (fwrite( header, 1, headerBytes, fp ) == headerBytes);
+  unsigned long long offset = headerBytes;
+
+  for (size_t b = 0; b < numBlocks && ok; b++) {
+    const size_t start = b * blockLen;
+    const size_t n = (N - start < blockLen) ? N - start : blockLen;
+    size_t len = 0;
+    ok = encodeBlock( times + start, vec + start, n, kind, entropy, buf, len ) &&
+         fwrite( buf, 1, len, fp ) == len;
+    if (ok && b > 0 && times[start] < times[start-1]) {
+      printf("tsfile::write: the timestamps decrease\n");
+      ok = false;
+    }
+
+    unsigned char *entry = index + (b * indexBytes);
+    put64( entry, (unsigned long long)times[start] );
+    put64( entry + 8, (unsigned long long)times[start + n - 1] );
+    put64( entry + 16, offset );
+    put32( entry + 24, len );
+    put32( entry + 28, n );
+    offset = offset + len;
+  }
+
+  if (ok) {
+    ok = (fwrite( index, 1, numBlocks * indexBytes, fp ) == numBlocks * indexBytes);
+  }
+
+  if (ok) {
+    header[0] = 'K';
+    header[1] = 'P';
+    header[2] = 'L';
+    header[3] = 'F';
+    header[4] = 1;
+    header[5] = (unsigned char)(entropy ? intcodec::entropyFlag : 0);
+    put32( header + 8, blockLen );
+    put32( header + 12, numBlocks );
+    put64( header + 16, N );
+    put64( header + 24, offset );
+    ok = (fseek( fp, 0, SEEK_SET ) == 0) &&
+         (fwrite( header, 1, headerBytes, fp ) == headerBytes);
+  }
+
+  if (fclose( fp ) != 0) {
+    ok = false;
+  }
+  if (! ok) {
+    printf("tsfile::write: error writing %s\n", path );
+  }
+
+  delete [] index;
+  delete [] buf;
+  return ok;
+} // write
+
+
+/**
+  Map the file <i>path</i> into memory and check the header and the
+  index.  Returns false if the file cannot be opened or is not a
+  valid tsfile.
+ */
+bool tsfile::open( const char *path )
+{
+  close();
+
+#if defined(_WIN32)
+  fileHandle = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, 0,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+  if (fileHandle == INVALID_HANDLE_VALUE) {
+    printf("tsfile::open: could not open %s\n", path );
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (GetFileSizeEx( fileHandle, &size ) && size.QuadPart > 0) {
+    fileLen = (size_t)size.QuadPart;
+    mapHandle = CreateFileMappingA( fileHandle, 0, PAGE_READONLY, 0, 0, 0 );
+    if (mapHandle != 0) {
+      base = (const unsigned char *)MapViewOfFile( mapHandle, FILE_MAP_READ, 0, 0, 0 );
+    }
+  }
+#else
+  fd = ::open( path, O_RDONLY );
+  if (fd < 0) {
+    printf("tsfile::open: could not open %s\n", path );
+    return false;
+  }
+  struct stat st;
+  if (fstat( fd, &st ) == 0 && st.st_size > 0) {
+    fileLen = (size_t)st.st_size;
+    void *p = mmap( 0, fileLen, PROT_READ, MAP_SHARED, fd, 0 );
+    if (p != MAP_FAILED) {
+      base = (const unsigned char *)p;
+    }
+  }
+#endif
+  if (base == 0) {
+    printf("tsfile::open: could not map %s\n", path );
+    close();
+    return false;
+  }
+
+  bool ok = (fileLen >= headerBytes &&
+             base[0] == 'K' && base[1] == 'P' && base[2] == 'L' && base[3] == 'F' &&
+             base[4] == 1);
+  if (ok) {
+    entropy = (base[5] & intcodec::entropyFlag) != 0;
+    blockLen_ = get32( base + 8 );
+    numBlocks_ = get32( base + 12 );
+    N_ = (size_t)get64( base + 16 );
+    const unsigned long long indexOffset = get64( base + 24 );
+    ok = (blockLen_ > 0 && blockLen_ <= N_ && numBlocks_ == (N_ + blockLen_ - 1) / blockLen_ &&
+          indexOffset <= fileLen &&
+          (fileLen - indexOffset) / indexBytes >= numBlocks_);
+    if (ok) {
+      index = base + indexOffset;
+    }
+  }
+  for (size_t b = 0; ok && b < numBlocks_; b++) {
+    const unsigned char *entry = index + (b * indexBytes);
+    const unsigned long long offset = get64( entry + 16 );
+    const size_t len = get32( entry + 24 );
+    ok = (offset >= headerBytes && offset <= fileLen && len <= fileLen - offset &&
+          get32( entry + 28 ) == ((b + 1 < numBlocks_) ? blockLen_ : N_ - (b * blockLen_)) &&
+          firstTime( b ) <= lastTime( b ) &&
+          (b == 0 || lastTime( b - 1 ) <= firstTime( b )));
+  }
+  if (! ok) {
+    printf("tsfile::open: %s is not a valid tsfile\n", path );
+    close();
+  }
+  return ok;
+} // open
+
+
+/**
+  Unmap and close the file
+ */
+void tsfile::close()
+{
+#if defined(_WIN32)
+  if (base != 0) {
+    UnmapViewOfFile( base );
+  }
+  if (mapHandle != 0) {
+    CloseHandle( mapHandle );
+  }
+  if (fileHandle != INVALID_HANDLE_VALUE) {
+    CloseHandle( fileHandle );
+  }
+  fileHandle = INVALID_HANDLE_VALUE;
+  mapHandle = 0;
+#else
+  if (base != 0) {
+    munmap( (void *)base, fileLen );
+  }
+  if (fd >= 0) {
+    ::close( fd );
+  }
+  fd = -1;
+#endif
+  base = 0;
+  fileLen = 0;
+  index = 0;
+  blockLen_ = 0;
+  numBlocks_ = 0;
+  N_ = 0;
+  blocksDecoded_ = 0;
+} // close
+
+
+/** the first timestamp of block <i>b</i> */
+long long tsfile::firstTime( const size_t b ) const
+{
+  return (long long)get64( index + (b * indexBytes) );
+} // firstTime
+
+
+/** the last timestamp of block <i>b</i> */
+long long tsfile::lastTime( const size_t b ) const
+{
+  return (long long)get64( index + (b * indexBytes) + 8 );
+} // lastTime
+
+
+/**
+  Decode the timestamps and values of block <i>b</i>.  The arrays
+  must have room for the block length.  <i>offsets</i> is work space
+  for the timestamp offsets.
+ */
+bool tsfile::decodeBlock( const size_t b,
+                          long long *times,
+                          int *vals,
+                          int *offsets ) const
+{
+  const unsigned char *entry = index + (b * indexBytes);
+  const unsigned char *block = base + get64( entry + 16 );
+  const size_t len = get32( entry + 24 );
+  const size_t n = get32( entry + 28 );
+
+  bool ok = (len > 0 && block[0] > intcodec::BadKind && block[0] < intcodec::Smallest);
+  const intcodec::codecKind kind = (intcodec::codecKind)block[0];
+  size_t pos = 1;
+
+  unsigned int bodyLen = 0;
+  size_t varLen = ok ? bitpack::getVarint( block + pos, len - pos, bodyLen ) : 0;
+  ok = (varLen > 0 && bodyLen <= len - pos - varLen);
+  if (ok) {
+    pos = pos + varLen;
+    ok = (intcodec::decodeBlock( block + pos, bodyLen, kind, vals, n, entropy ) == bodyLen);
+    pos = pos + bodyLen;
+  }
+  if (ok) {
+    varLen = bitpack::getVarint( block + pos, len - pos, bodyLen );
+    ok = (varLen > 0 && bodyLen <= len - pos - varLen);
+  }
+  if (ok) {
+    pos = pos + varLen;
+    ok = (intcodec::decodeBlock( block + pos, bodyLen, intcodec::Delta, offsets, n, entropy ) == bodyLen);
+    if (ok) {
+      const long long start = firstTime( b );
+      for (size_t i = 0; i < n; i++) {
+        times[i] = start + offsets[i];
+      }
+    }
+  }
+  if (! ok) {
+    printf("tsfile: block %u is corrupt\n", (unsigned)b );
+  }
+  return ok;
+} // decodeBlock
+
+
+/**
+  Return the samples with timestamps in the range [<i>t0</i>,
+  <i>t1</i>] (inclusive).  The timestamps and values are written to
+  <i>times</i> and <i>vals</i>, which have room for <i>maxN</i>
+  samples.  Only the blocks whose timestamp range overlaps the
+  query are decoded.  Returns the number of samples, which is at
+  most maxN.
+ */
+size_t tsfile::query( const long long t0,
+                      const long long t1,
+                      long long *times,
+                      int *vals,
+                      const size_t maxN )
+{
+  size_t count = 0;
+  if (base == 0 || t1 < t0) {
+    return count;
+  }
+
+  // binary search for the first block that ends at or after t0
+  size_t lo = 0;
+  size_t hi = numBlocks_;
+  while (lo < hi) {
+    const size_t mid = (lo + hi) / 2;
+    if (lastTime( mid ) < t0) {
+      lo = mid + 1;
+    }
+    else {
+      hi = mid;
+    }
+  }
+
+  long long *blockTimes = new long long[ blockLen_ ];
+  int *blockVals = new int[ blockLen_ ];
+  int *offsets = new int[ blockLen_ ];
+
+  for (size_t b = lo; b < numBlocks_ && firstTime( b ) <= t1 && count < maxN; b++) {
+    if (! decodeBlock( b, blockTimes, blockVals, offsets )) {
+      break;
+    }
+    blocksDecoded_++;
+    const size_t n = get32( index + (b * indexBytes) + 28 );
+    for (size_t i = 0; i < n && count < maxN; i++) {
+      if (blockTimes[i] >= t0 && blockTimes[i] <= t1) {
+        times[count] = blockTimes[i];
+        vals[count] = blockVals[i];
+        count++;
+      }
+    }
+  }
+
+  delete [] offsets;
+  delete [] blockVals;
+  delete [] blockTimes;
+  return count;
+} // query
@@ -0,0 +1,167 @@
+
+#ifndef _TSFILE_H_
+#define _TSFILE_H_
+
+#include <stddef.h>
+
+#include "intcodec.h"
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+
+/**
+  A seekable file of compressed time series values.
+
+  The codecs (intcodec, blockcodec) compress an array in memory.  A
+  tsfile stores a time series (a timestamp and an integer value for
+  each sample) on disk, in blocks that can be decoded independently.
+  An index at the end of the file records the timestamp range and
+  the file offset of each block.  A reader maps the file into memory
+  and decodes only the blocks that overlap a query range, so a query
+  on a large file does not touch the rest of the file.
+
+  The file layout is
+
+  <pre>
+     header (headerBytes)
+        4 bytes   the characters 'K', 'P', 'L', 'F'
+        1 byte    version (1)
+        1 byte    flags (intcodec::entropyFlag if the values are
+                  entropy coded)
+        2 bytes   reserved (zero)
+        4 bytes   the block length
+        4 bytes   the number of blocks
+        8 bytes   N, the number of samples
+        8 bytes   the file offset of the index
+     blocks
+        1 byte    the transform kind of the values (intcodec::codecKind)
+        varint    length of the values body
+        ...       the values (see intcodec::encodeBlock)
+        varint    length of the timestamp body
+        ...       the timestamps, as delta coded (intcodec::Delta)
+                  offsets from the first timestamp of the block
+     index (indexBytes per block)
+        8 bytes   the first timestamp of the block
+        8 bytes   the last timestamp of the block
+        8 bytes   the file offset of the block
+        4 bytes   the length of the block, in bytes
+        4 bytes   the number of samples in the block
+  </pre>
+
+  All values are stored low order byte first.  The timestamps are
+  64-bit integers (e.g., seconds or days since an epoch) and must not
+  decrease.  Inside a block the offset of each timestamp from the
+  first timestamp must fit in 31 bits.
+
+  The static function write creates a file.  A tsfile object opens a
+  file for reading.  Errors are reported with printf and a false (or
+  zero) return value.
+ */
+class tsfile
+{
+public:
+  typedef enum { headerBytes = 32,
+                 indexBytes = 32 } bogus;
+
+private:
+  /** disallow the copy constructor */
+  tsfile( const tsfile &rhs ) {}
+
+  /** the start of the mapped file */
+  const unsigned char *base;
+  /** the length of the file */
+  size_t fileLen;
+#if defined(_WIN32)
+  /** the file and mapping handles */
+  void *fileHandle;
+  void *mapHandle;
+#else
+  /** the file descriptor */
+  int fd;
+#endif
+
+  size_t blockLen_;
+  size_t numBlocks_;
+  size_t N_;
+  bool entropy;
+  /** the start of the index */
+  const unsigned char *index;
+  /** the number of blocks decoded since the file was opened */
+  size_t blocksDecoded_;
+
+  long long firstTime( const size_t b ) const;
+  long long lastTime( const size_t b ) const;
+  bool decodeBlock( const size_t b,
+                    long long *times,
+                    int *vals,
+                    int *offsets ) const;
+
+  static bool encodeBlock( const long long *times,
+                           const int *vec,
+                           const size_t n,
+                           const intcodec::codecKind kind,
+                           const bool entropy,
+                           unsigned char *buf,
+                           size_t &len );
+
+public:
+  tsfile();
+  ~tsfile();
+
+  static bool write( const char *path,
+                     const long long *times,
+                     const int *vec,
+                     const size_t N,
+                     const size_t blockLen,
+                     const intcodec::codecKind kind,
+                     const bool entropy = false );
+
+  bool open( const char *path );
+  void close();
+
+  /** the number of samples in the file */
+  size_t length() const { return N_; }
+  /** the number of blocks in the file */
+  size_t numBlocks() const { return numBlocks_; }
+  /** the number of blocks decoded by queries */
+  size_t blocksDecoded() const { return blocksDecoded_; }
+
+  size_t query( const long long t0,
+                const long long t1,
+                long long *times,
+                int *vals,
+                const size_t maxN );
+}; // tsfile
+
+#endif
@@ -36,6 +36,7 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "haar.h"
 #include "haar_classic.h"
@@ -45,6 +46,7 @@
 #include "packcontainer.h"
 #include "packtree.h"
 #include "invpacktree.h"
+#include "packbasis.h"
 
 #include "costshannon.h"
 #include "costthresh.h"
@@ -128,6 +130,8 @@ main()
   size_t len = sizeof(data)/sizeof(double);
   // testWaveletTrans( data, len );
 
+  block_pool mem_pool;
+
   // The "Haar" classic transform
   haar_classic<packcontainer> h;
 
@@ -183,6 +187,26 @@ main()
 
   printf("\n");
 
+  // Get the best basis as a packbasis descriptor.  The descriptor
+  // is a single block of memory that does not reference the tree,
+  // so it can be copied (or written to a file) with memcpy.
+  packbasis<double> basis = tree.getBestBasis();
+
+  char *bytes = (char *)mem_pool.pool_alloc( basis.byteSize() );
+  memcpy( bytes, basis.bytes(), basis.byteSize() );
+
+  packbasis<double> basisCopy( bytes, basis.byteSize() );
+  printf("Best basis descriptor: %d nodes, %d bytes\n", 
+         (int)basisCopy.numNodes(), (int)basisCopy.byteSize() );
+  basisCopy.pr();
+
+  invpacktree basisInv( basisCopy, &h );
+
+  printf("Inverse wavelet packet transform from the descriptor:\n");
+  basisInv.pr();
+
+  printf("\n");
+
   // Calculate the inverse wavelet packet transform from the
   // "best basis" list.
   invpacktree invtree( bestBasis, &h );
@@ -191,7 +215,6 @@ main()
   invtree.pr();
 
   // free the memory pool
-  block_pool mem_pool;
   mem_pool.free_pool();
 
   return 0;
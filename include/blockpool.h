@@ -56,6 +56,19 @@
   instance a window into the global state.  The limitation is that
   only one memory pool can be used.
 
+  Allocations that are too large for a normal block (see
+  set_map_threshold) get a block of their own, which is mapped
+  directly from the operating system and can optionally use large
+  pages (see set_large_pages).  There is no limit on the size of an
+  allocation other than the memory available.  If memory cannot be
+  allocated, pool_alloc prints an error and returns zero.
+
+  Memory is aligned to sizeof(size_t) bytes unless a larger alignment
+  is passed to pool_alloc.  The wavelet packet code allocates its
+  coefficient arrays with simd_align (64 byte) alignment, so vector
+  kernels can use aligned loads.  The blocks are not cleared when
+  they are allocated (see set_zero_fill).
+
   Originally written November, 1996<br>
   Revised for the wavelet packet transform code March 2002
 
@@ -65,14 +78,31 @@
 
 class block_pool {
 public: // typedefs and variables
-  /** the largest block of memory that can be allocated is the
-     page_size * max_block_multiple */
+  /** blocks larger than page_size * max_block_multiple (the default
+     map threshold, see set_map_threshold) are mapped directly from
+     the operating system.  Mapped blocks that use large pages are
+     rounded up to a multiple of the large page size. */
   typedef enum { one_kay = 1024,
 		 page_size = (4 * one_kay),  /* 4 Kb */
 		 max_block_multiple = 256,   /* 1 Mb */
+		 large_page_size = (2 * one_kay * one_kay), /* 2 Mb */
+		 simd_align = 64,            /* cache line and AVX-512 vector */
 		 last_enum
 	       } bogus;
 
+  /** 
+    Large page use for mapped blocks (see set_large_pages):
+    no_large_pages uses the normal page size,
+    transparent_large_pages asks the kernel to back the block with
+    transparent huge pages (madvise MADV_HUGEPAGE) and
+    explicit_large_pages maps the block from the reserved huge page
+    pool (MAP_HUGETLB), falling back to transparent huge pages if
+    none are available.  Large pages are only used on Linux.
+   */
+  typedef enum { no_large_pages,
+                 transparent_large_pages,
+                 explicit_large_pages } large_page_kind;
+
   /** typedef for memory block chain */
   typedef struct block_chain_struct {
     /** pointer to the current block */
@@ -86,8 +116,44 @@ public: // typedefs and variables
        
     /** pointer to the next block */
     block_chain_struct *next_block;
+
+    /** true if the block was mapped from the operating system
+        (see MapAlloc), false if it was allocated by MemAlloc */
+    bool mapped;
   } block_chain;
 
+  /** 
+    Memory pool statistics (see get_pool_stats).  The requested,
+    reserved, block and waste values describe the current pool and
+    are set to zero by free_pool.  The other values accumulate until
+    reset_pool_stats is called.
+   */
+  typedef struct {
+    /** bytes requested from pool_alloc (before alignment) */
+    size_t requested;
+    /** bytes allocated from the system for the blocks in the pool */
+    size_t reserved;
+    /** number of blocks in the pool */
+    size_t blocks;
+    /** number of the blocks that are mapped (see set_map_threshold) */
+    size_t mapped_blocks;
+    /** bytes reserved but not handed out (alignment, block headers
+        and the unused ends of the blocks): reserved - requested */
+    size_t waste;
+    /** the largest value of reserved */
+    size_t high_water;
+    /** number of calls to pool_alloc */
+    size_t alloc_calls;
+    /** number of calls to free_pool */
+    size_t free_calls;
+    /** number of pool_alloc calls that failed (out of memory) */
+    size_t alloc_failures;
+    /** number of allocations from the global heap (see note_heap_alloc) */
+    size_t heap_fallbacks;
+    /** bytes allocated from the global heap */
+    size_t heap_bytes;
+  } pool_stats;
+
 private:
   /** allocation granularity */
   static size_t alloc_gran;
@@ -98,18 +164,44 @@ private:
   /** current block memory is being allocated from */
   static block_chain *current_block;    
 
+  /** statistics for the pool (see get_pool_stats) */
+  static pool_stats stats;
+
+  /** blocks larger than this are mapped (see set_map_threshold) */
+  static size_t map_threshold;
+
+  /** large page use for mapped blocks (see set_large_pages) */
+  static large_page_kind large_pages;
+
+  /** if true, new blocks are set to zero (see set_zero_fill) */
+  static bool zero_fill;
+
 
 private: // class functions
   block_chain *new_block( size_t block_size );
-  void *add_block( size_t block_size );
+  block_chain *add_block( size_t block_size );
   void init_pool(void);
 
+  static void *MapAlloc( size_t n_bytes );
+  static void MapFree( void *addr, size_t n_bytes );
+
+  /** the number of bytes needed to align the next allocation in
+      block <i>p</i> to <i>align</i> (a power of two) bytes */
+  static size_t align_pad( block_chain *p, size_t align )
+  {
+    const size_t addr = (size_t)p->block + p->bytes_used;
+    return ((addr + (align-1)) & ~(align-1)) - addr;
+  }
+
 
 protected:
   /**
-    Allocate memory using <i>calloc</i>.  The POSIX calloc function
-    sets the memory to zero (in contrast to <i>malloc</i> which
-    allocates the memory without initializing it.
+    Allocate memory using <i>malloc</i>, which allocates the memory
+    without initializing it.  The wavelet packet code writes every
+    element of the arrays that it allocates, so clearing the blocks
+    would only cost time.  If zero fill has been turned on (see
+    set_zero_fill) the memory is allocated with <i>calloc</i>, which
+    sets it to zero.
 
 <pre>
       #include <stdlib>
@@ -127,7 +219,7 @@ protected:
    */
   virtual void *MemAlloc( size_t n_bytes )
   {
-    void *rtn = calloc( n_bytes, 1 );
+    void *rtn = zero_fill ? calloc( n_bytes, 1 ) : malloc( n_bytes );
     return rtn;
   }
   /**
@@ -145,9 +237,26 @@ public: // class functions
   block_pool(void) {}
 
   void free_pool(void);
-  void *pool_alloc( size_t block_size );
+  void *pool_alloc( size_t block_size, size_t align = sizeof( size_t ) );
   void print_block_pool_info( FILE *fp = stdout );
 
+  static void set_map_threshold( size_t n_bytes );
+  /** get the size above which blocks are mapped */
+  static size_t get_map_threshold(void) { return map_threshold; }
+  /** set the large page use for mapped blocks */
+  static void set_large_pages( large_page_kind kind ) { large_pages = kind; }
+  /** set new blocks to zero (true) or leave them uninitialized
+      (false, the default).  Mapped blocks are always zero. */
+  static void set_zero_fill( bool fill ) { zero_fill = fill; }
+  /** return true if new blocks are set to zero */
+  static bool get_zero_fill(void) { return zero_fill; }
+
+  static void get_pool_stats( pool_stats &s );
+  static void reset_pool_stats(void);
+  static void write_pool_stats( FILE *fp );
+
+  static void note_heap_alloc( size_t num_bytes );
+
 }; // class block_pool
 
 
@@ -166,5 +275,8 @@ public: // class functions
 /** return the next block_chain structure in the list */
 #define Chain_next(p)             ((p)->next_block)
 
+/** return true if the block was mapped from the operating system */
+#define Chain_mapped(p)           ((p)->mapped)
+
 
 #endif
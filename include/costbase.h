@@ -3,6 +3,8 @@
 #define _COSTBASE_H_
 
 #include "packnode.h"
+#include "packprofile.h"
+#include "packtrace.h"
 
 /** \file
 
@@ -57,6 +59,9 @@
   The pure virtual function costCalc, which calculates the cost
   function, must be defined by the subclass.
 
+  The class is a template for the type of the packet tree elements.
+  The cost itself is always a double.
+
   A description of the cost functions associated with the wavelet
   packet transform can be found in Chapter 8 of <i>Ripples in
   Mathematics</i> by Jense and la Cour-Harbo.
@@ -65,35 +70,56 @@
 
  */
 
-class costbase
+template <class T>
+class basic_costbase
 {
 private:
   /** disallow the copy constructor */
-  costbase( const costbase &rhs ) {}
+  basic_costbase( const basic_costbase &rhs ) {}
 
-protected:
   /**
-    Recursively traverse the wavelet packet tree and calculate the cost
+    Recursively walk the wavelet packet tree and calculate the cost
     function.
     */
-  void traverse( packnode<double> *node )
+  void costWalk( packnode<T> *node )
   {
     if (node != 0) {
       double cost = costCalc( node );
       node->cost( cost );
+      PACKPROF_COUNT( Cost, 1, 0, node->length() );
     
-      traverse( node->lhsChild() );
-      traverse( node->rhsChild() );
+      costWalk( node->lhsChild() );
+      costWalk( node->rhsChild() );
     }
+  } // costWalk
+
+protected:
+  /**
+    Traverse the wavelet packet tree and calculate the cost function
+    (the time is recorded in the Cost phase, see packprofile, and
+    as a "cost" span, see packtrace).
+    */
+  void traverse( packnode<T> *node )
+  {
+    PACKPROF_START( start );
+    PACKTRACE_SPAN( costSpan, "cost", (node != 0) ? node->length() : 0 );
+    costWalk( node );
+    PACKPROF_STOP( Cost, start );
   } // traverse 
 
   /** Cost function to be defined by the subclass */
-  virtual double costCalc(packnode<double> *node) = 0;
+  virtual double costCalc(packnode<T> *node) = 0;
 
 public:
   /** The default constructor does nothing */
-  costbase() {}
+  basic_costbase() {}
+}; // basic_costbase
+
+
+/** cost function base class for double packet trees */
+typedef basic_costbase<double> costbase;
 
-}; // costbase
+/** cost function base class for integer packet trees */
+typedef basic_costbase<int> costbase_int;
 
 #endif
@@ -0,0 +1,75 @@
+
+#ifndef _COSTQUANT_H_
+#define _COSTQUANT_H_
+
+#include "costbase.h"
+#include "packnode.h"
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+/**
+  The costquant class is the cost function for error bounded lossy
+  compression (see packquant).  Each coefficient is quantized to the
+  nearest multiple of a quantization step and the cost of a node is
+  the total number of bits needed to represent the quantized
+  values: a sign bit plus the width of the magnitude for each value.
+  This is the same width measure that the lossless compression
+  code uses for integer coefficients (support::vecWidth), applied to
+  the quantized values.
+
+  \author Ian Kaplan
+ */
+class costquant : public costbase
+{
+private:
+  /** quantization step */
+  double step;
+
+protected:
+  double costCalc( packnode<double> *node );
+
+public:
+  /** Calculate the quantized width cost function for the wavelet
+      packet tree, with the quantization step <i>s</i> */
+  costquant( packnode<double> *node, const double s )
+  {
+    step = s;
+    traverse( node );
+  }
+
+  static double quantize( const double v, const double step );
+  static size_t quantWidth( const double q );
+}; // costquant
+
+#endif
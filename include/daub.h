@@ -120,6 +120,10 @@
   matrix discussion above is based on material from <i>Ripples in
   Mathematics</i>, by Jensen and Cour-Harbo.  Any error are mine.
 
+  The second template argument is the type of the data elements
+  (double by default).  The filter coefficients are stored in this
+  type, so a float instantiation calculates in single precision.
+
   <b>Author</b>: Ian Kaplan<br>
   <b>Use</b>: You may use this software for any purpose as long
   as I cannot be held liable for the result.  Please credit me
@@ -128,8 +132,8 @@
   This comment is formatted for the doxygen documentation generator
 
  */
-template <class T>
-class Daubechies : public liftbase<T, double> {
+template <class T, class T_elem = double>
+class Daubechies : public liftbase<T, T_elem> {
   
 protected:
   void predict( T& vec, int N, transDirection direction )
@@ -143,13 +147,27 @@ protected:
   } // update
   
 private:
+  /**
+    The transform is not applied to data sets with less than four
+    elements.  The data is copied, unchanged, into the two halves.
+   */
+  static void copyHalves( const T_elem *src, T_elem *lhs, T_elem *rhs, const int n )
+  {
+    const int half = n >> 1;
+
+    for (int i = 0; i < half; i++) {
+      lhs[i] = src[i];
+      rhs[i] = src[i+half];
+    }
+  } // copyHalves
+
   /** forward transform scaling coefficients */
-  double h0, h1, h2, h3;
+  T_elem h0, h1, h2, h3;
   /** forward transform wave coefficients */
-  double g0, g1, g2, g3;
+  T_elem g0, g1, g2, g3;
   
-  double Ih0, Ih1, Ih2, Ih3;
-  double Ig0, Ig1, Ig2, Ig3;
+  T_elem Ih0, Ih1, Ih2, Ih3;
+  T_elem Ig0, Ig1, Ig2, Ig3;
 
 public:
   
@@ -163,7 +181,7 @@ public:
       int i, j;
       const int half = n >> 1;
       
-      double* tmp = new double[n];
+      T_elem* tmp = new T_elem[n];
       
       for (i = 0, j = 0; j < n-3; j += 2, i++) {
 	tmp[i]      = a[j]*h0 + a[j+1]*h1 + a[j+2]*h2 + a[j+3]*h3;
@@ -191,7 +209,7 @@ public:
       int i, j;
       const int half = n >> 1;
       
-      double* tmp = new double[n];
+      T_elem* tmp = new T_elem[n];
       
       for (i = 0, j = 0; j < n-3; j += 2, i++) {
 	tmp[i+half] = a[j]*h0 + a[j+1]*h1 + a[j+2]*h2 + a[j+3]*h3;
@@ -208,6 +226,136 @@ public:
     }
   }
   
+  /**
+    Forward Daubechies D4 transform step, calculated out of place.
+    The result is calculated from <i>src</i> and written directly
+    into <i>a</i>, so no temporary array is needed.
+    */
+  void forwardStepFrom( const T_elem *src, T& a, const int n )
+  {
+    if (n >= 4) {
+      int i, j;
+      const int half = n >> 1;
+      
+      for (i = 0, j = 0; j < n-3; j += 2, i++) {
+	a[i]      = src[j]*h0 + src[j+1]*h1 + src[j+2]*h2 + src[j+3]*h3;
+	a[i+half] = src[j]*g0 + src[j+1]*g1 + src[j+2]*g2 + src[j+3]*g3;
+      }
+      
+      a[i]      = src[n-2]*h0 + src[n-1]*h1 + src[0]*h2 + src[1]*h3;
+      a[i+half] = src[n-2]*g0 + src[n-1]*g1 + src[0]*g2 + src[1]*g3;
+    }
+    else {
+      for (int i = 0; i < n; i++) {
+	a[i] = src[i];
+      }
+    }
+  }
+  
+  /**
+    Out of place version of forwardStepRev
+    */
+  void forwardStepRevFrom( const T_elem *src, T& a, const int n )
+  {
+    if (n >= 4) {
+      int i, j;
+      const int half = n >> 1;
+      
+      for (i = 0, j = 0; j < n-3; j += 2, i++) {
+	a[i+half] = src[j]*h0 + src[j+1]*h1 + src[j+2]*h2 + src[j+3]*h3;
+	a[i]      = src[j]*g0 + src[j+1]*g1 + src[j+2]*g2 + src[j+3]*g3;
+      }
+      
+      a[i+half] = src[n-2]*h0 + src[n-1]*h1 + src[0]*h2 + src[1]*h3;
+      a[i]      = src[n-2]*g0 + src[n-1]*g1 + src[0]*g2 + src[1]*g3;
+    }
+    else {
+      for (int i = 0; i < n; i++) {
+	a[i] = src[i];
+      }
+    }
+  }
+  
+  /**
+    Forward Daubechies D4 step on raw arrays.  The smoothed values
+    are written to <i>lhs</i> and the wavelet coefficients to
+    <i>rhs</i>.  The wrap-around step is peeled off of the loop.
+   */
+  bool forwardSpan( const T_elem *src, T_elem *lhs, T_elem *rhs, const int n )
+  {
+    if (n >= 4) {
+      const int last = (n >> 1) - 1;
+      
+      for (int i = 0; i < last; i++) {
+	const T_elem *s = src + 2*i;
+	lhs[i] = s[0]*h0 + s[1]*h1 + s[2]*h2 + s[3]*h3;
+	rhs[i] = s[0]*g0 + s[1]*g1 + s[2]*g2 + s[3]*g3;
+      }
+      
+      lhs[last] = src[n-2]*h0 + src[n-1]*h1 + src[0]*h2 + src[1]*h3;
+      rhs[last] = src[n-2]*g0 + src[n-1]*g1 + src[0]*g2 + src[1]*g3;
+    }
+    else {
+      copyHalves( src, lhs, rhs, n );
+    }
+    return true;
+  } // forwardSpan
+
+  /**
+    Raw array version of forwardStepRev, where the wavelet
+    coefficients are written to <i>lhs</i> and the smoothed values
+    are written to <i>rhs</i>.
+   */
+  bool forwardSpanRev( const T_elem *src, T_elem *lhs, T_elem *rhs, const int n )
+  {
+    if (n >= 4) {
+      forwardSpan( src, rhs, lhs, n );
+    }
+    else {
+      copyHalves( src, lhs, rhs, n );
+    }
+    return true;
+  } // forwardSpanRev
+
+  /**
+    Inverse Daubechies D4 step on raw arrays.  The result is written
+    to <i>dst</i>, so no temporary array is needed.
+   */
+  bool inverseSpan( T_elem *lhs, T_elem *rhs, T_elem *dst, const int n )
+  {
+    if (n >= 4) {
+      const int half = n >> 1;
+      
+      dst[0] = lhs[half-1]*Ih0 + rhs[half-1]*Ih1 + lhs[0]*Ih2 + rhs[0]*Ih3;
+      dst[1] = lhs[half-1]*Ig0 + rhs[half-1]*Ig1 + lhs[0]*Ig2 + rhs[0]*Ig3;
+      for (int i = 0; i < half-1; i++) {
+	dst[2*i+2] = lhs[i]*Ih0 + rhs[i]*Ih1 + lhs[i+1]*Ih2 + rhs[i+1]*Ih3;
+	dst[2*i+3] = lhs[i]*Ig0 + rhs[i]*Ig1 + lhs[i+1]*Ig2 + rhs[i+1]*Ig3;
+      }
+    }
+    else {
+      const int half = n >> 1;
+
+      for (int i = 0; i < half; i++) {
+	dst[i] = lhs[i];
+	dst[i+half] = rhs[i];
+      }
+    }
+    return true;
+  } // inverseSpan
+
+  /** The D4 kernels wrap around the end of the data */
+  bool spanPeriodic() const
+  {
+    return true;
+  } // spanPeriodic
+
+  /** The normalized low pass result is sqrt(2) times the average */
+  double lowPassGain() const
+  {
+    return sqrt( 2.0 );
+  } // lowPassGain
+
   /**
     Inverse Daubechies D4 transform
     */
@@ -218,7 +366,7 @@ public:
       const int half = n >> 1;
       const int halfPls1 = half + 1;
       
-      double* tmp = new double[n];
+      T_elem* tmp = new T_elem[n];
       
       //      last smooth val  last coef.  first smooth  first coef
       tmp[0] = a[half-1]*Ih0 + a[n-1]*Ih1 + a[0]*Ih2 + a[half]*Ih3;
@@ -74,8 +74,9 @@ public:
 	/** pointer to the next element */
         list_type *next;
         /** override the default new operator to allocate
-           list_type objects from the a memory pool */
-        void *operator new(size_t num_bytes)
+           list_type objects from the a memory pool (new returns
+           zero if the memory cannot be allocated) */
+        void *operator new(size_t num_bytes) throw()
         {
           block_pool mem_pool;
 
@@ -114,12 +115,16 @@ public:
   } // dealloc
 
 
-  /** add an element to the FIFO list */
-  void add( T data )
+  /** add an element to the FIFO list.  Return false if the memory
+      for the list element could not be allocated. */
+  bool add( T data )
   {
     list_type *t;
     
     t = new list_type();
+    if (t == 0) {
+      return false;
+    }
     t->data = data;
     t->next = 0;
     if (list == 0) {
@@ -130,6 +135,7 @@ public:
       tail->next = t;
       tail = t;
     }
+    return true;
   }  // add
 
 
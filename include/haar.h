@@ -69,14 +69,18 @@
   Objects that act like arrays define the left hand side and right
   hand side index operators: [].
 
+  The second template argument is the type of the data elements.  It
+  defaults to double (the float version is used by the float packet
+  tree).
+
   See www.bearcave.com for more information on wavelets and the
   wavelet lifting scheme.
 
   \author Ian Kaplan
 
  */
-template <class T>
-class haar : public liftbase<T, double> {
+template <class T, class T_elem = double>
+class haar : public liftbase<T, T_elem> {
 
 protected:
   /**
@@ -87,7 +91,7 @@ protected:
     int half = N >> 1;
 
     for (int i = 0; i < half; i++) {
-      double predictVal = vec[i];
+      T_elem predictVal = vec[i];
       int j = i + half;
 
       if (direction == forward) {
@@ -137,7 +141,7 @@ protected:
 
     for (int i = 0; i < half; i++) {
       int j = i + half;
-      double updateVal = vec[j] / 2.0;
+      T_elem updateVal = vec[j] / 2.0;
 
       if (direction == forward) {
 	vec[i] = vec[i] + updateVal;
@@ -181,7 +185,7 @@ protected:
    */
   void normalize( T& vec, int N, transDirection direction )
   {
-    const double sqrt2 = sqrt( 2.0 );
+    const T_elem sqrt2 = sqrt( 2.0 );
     int half = N >> 1;
 
     for (int i = 0; i < half; i++) {
@@ -213,16 +217,62 @@ protected:
   }  // inverseStep
 
   /**
-    One step in the forward wavelet transform, with normalization
+    The lifting steps of the forward wavelet transform, with
+    normalization.  The split step is applied by forwardStep
+    (or forwardStepFrom) in the base class.
    */
-  void forwardStep( T& vec, const int n )
+  void forwardLift( T& vec, const int n )
   {
-    split( vec, n );
     predict( vec, n, forward );
     update( vec, n, forward );
     normalize( vec, n, forward );
-  } // forwardStep
+  } // forwardLift
+
+public:
+
+  /**
+    Forward Haar step on raw arrays: the predict, update and
+    normalize steps are fused into a single loop over the
+    even/odd pairs of <i>src</i>.
+   */
+  bool forwardSpan( const T_elem *src, T_elem *lhs, T_elem *rhs, const int n )
+  {
+    const T_elem sqrt2 = sqrt( 2.0 );
+    const int half = n >> 1;
+
+    for (int i = 0; i < half; i++) {
+      T_elem even = src[2*i];
+      T_elem odd = src[2*i+1] - even;
+      even = even + (odd / 2);
+      lhs[i] = sqrt2 * even;
+      rhs[i] = odd/sqrt2;
+    }
+    return true;
+  } // forwardSpan
 
+  /**
+    Inverse Haar step on raw arrays, fused with the merge step.
+   */
+  bool inverseSpan( T_elem *lhs, T_elem *rhs, T_elem *dst, const int n )
+  {
+    const T_elem sqrt2 = sqrt( 2.0 );
+    const int half = n >> 1;
+
+    for (int i = 0; i < half; i++) {
+      T_elem even = lhs[i]/sqrt2;
+      T_elem odd = sqrt2 * rhs[i];
+      even = even - (odd / 2);
+      dst[2*i] = even;
+      dst[2*i+1] = odd + even;
+    }
+    return true;
+  } // inverseSpan
+
+  /** The normalized low pass result is sqrt(2) times the average */
+  double lowPassGain() const
+  {
+    return sqrt( 2.0 );
+  } // lowPassGain
 
 }; // haar
 
@@ -101,14 +101,18 @@
   Objects that act like arrays define the left hand side and right
   hand side index operators: [].
 
+  The second template argument is the type of the data elements.  It
+  defaults to double (the float version is used by the float packet
+  tree).
+
   See www.bearcave.com for more information on wavelets and the
   wavelet lifting scheme.
 
   \author Ian Kaplan
 
  */
-template <class T>
-class haar_classic : public liftbase<T, double> {
+template <class T, class T_elem = double>
+class haar_classic : public liftbase<T, T_elem> {
 
 protected:
 
@@ -122,7 +126,7 @@ protected:
     int cnt = 0;
 
     for (int i = 0; i < half; i++) {
-      double predictVal = vec[i];
+      T_elem predictVal = vec[i];
       int j = i + half;
 
       if (direction == forward) {
@@ -148,7 +152,7 @@ protected:
 
     for (int i = 0; i < half; i++) {
       int j = i + half;
-      double updateVal = vec[j];
+      T_elem updateVal = vec[j];
 
       if (direction == forward) {
 	vec[i] = vec[i] - updateVal;
@@ -162,6 +166,40 @@ protected:
     }
   } // update
 
+public:
+
+  /**
+    Forward step on raw arrays.  The split, predict and update
+    steps are fused into a single loop.
+   */
+  bool forwardSpan( const T_elem *src, T_elem *lhs, T_elem *rhs, const int n )
+  {
+    const int half = n >> 1;
+
+    for (int i = 0; i < half; i++) {
+      T_elem a = src[2*i];
+      T_elem d = (a - src[2*i+1])/2;
+      lhs[i] = a - d;
+      rhs[i] = d;
+    }
+    return true;
+  } // forwardSpan
+
+  /**
+    Inverse step on raw arrays, fused with the merge step.
+   */
+  bool inverseSpan( T_elem *lhs, T_elem *rhs, T_elem *dst, const int n )
+  {
+    const int half = n >> 1;
+
+    for (int i = 0; i < half; i++) {
+      T_elem a = lhs[i] + rhs[i];
+      dst[2*i] = a;
+      dst[2*i+1] = a - (2 * rhs[i]);
+    }
+    return true;
+  } // inverseSpan
+
 }; // haar_classic
 
 #endif
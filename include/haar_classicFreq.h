@@ -72,11 +72,14 @@
   These equations differ from the Haar classic forward transform
   equations.
 
+  As in haar_classic, the second template argument is the type of
+  the data elements.
+
   \author Ian Kaplan
 
  */
-template <class T>
-class haar_classicFreq : public haar_classic<T> {
+template <class T, class T_elem = double>
+class haar_classicFreq : public haar_classic<T, T_elem> {
 protected:
 
   /**
@@ -158,6 +161,34 @@ public:
     updateRev( vec, n, forward );
   }
 
+  /**
+    Out of place version of forwardStepRev.  The data in <i>src</i>
+    is split directly into <i>vec</i>.
+   */
+  void forwardStepRevFrom( const T_elem *src, T& vec, const int n )
+  {
+    splitCopy( src, vec, n ); 
+    predictRev( vec, n, forward );
+    updateRev( vec, n, forward );
+  }
+
+  /**
+    Raw array version of forwardStepRev.  The high pass result is
+    written to <i>lhs</i> and the low pass result to <i>rhs</i>.
+   */
+  bool forwardSpanRev( const T_elem *src, T_elem *lhs, T_elem *rhs, const int n )
+  {
+    const int half = n >> 1;
+
+    for (int i = 0; i < half; i++) {
+      T_elem b = src[2*i+1];
+      T_elem d = (src[2*i] - b)/2;
+      lhs[i] = d;
+      rhs[i] = b + d;
+    }
+    return true;
+  } // forwardSpanRev
+
   /**
 
     One inverse step of the reverse Haar classic transform, where the
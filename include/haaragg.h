@@ -0,0 +1,318 @@
+
+#ifndef _HAARAGG_H_
+#define _HAARAGG_H_
+
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+/**
+  Range aggregates (sum, mean, energy, minimum and maximum) calculated
+  directly from Haar wavelet coefficients.
+
+  The Haar transform (haar or haar_int) replaces each pair of values
+  with an average and a difference, level by level, so after
+  forwardTrans the array holds the average of the whole data set in
+  element 0 and the differences in bands of 1, 2, 4 ... N/2 elements.
+  The difference coefficients form a binary tree: using "heap"
+  numbering (the root is 1 and the children of node h are 2h and
+  2h+1), the coefficient of node h is element h of the array, and
+  node h at level j covers 2<sup>-j</sup>N consecutive samples.
+
+  If the average A of a node is known, the averages of its children
+  are calculated from A and the node's difference coefficient D:
+
+  <pre>
+     haar:      A<sub>L</sub> = A - D/sqrt(s)   A<sub>R</sub> = A + D/sqrt(s)
+     haar_int:  A<sub>L</sub> = A - floor(D/2)  A<sub>R</sub> = A<sub>L</sub> + D
+  </pre>
+
+  where s is the number of samples in the node.  The square root
+  comes from the normalization step of the haar class, which also
+  scales the overall average: A = vec[0]/sqrt(N).
+
+  So every sample in a node is A plus an offset that depends only on
+  the difference coefficients below the node.  The constructor
+  calculates, for each node, the sum of the offsets, the sum of the
+  squared offsets and the smallest and largest offset in one bottom
+  up pass over the coefficients (no inverse transform is
+  calculated).  A query for the range [a, b) walks down from the root,
+  calculating child averages along the way.  A node that is inside
+  the range is answered from its average and its offset sums:
+
+  <pre>
+     sum    = s A + S1
+     energy = s A<sup>2</sup> + 2 A S1 + S2
+     min    = A + minimum offset
+     max    = A + maximum offset
+  </pre>
+
+  where s is the number of samples in the node.  At most two nodes
+  per level are partly inside the range, so a query reads O(log N)
+  coefficients.  The minimum and maximum are exact, not
+  approximations.
+
+  The coefficients are not copied: the array passed to the
+  constructor must not change while the object is used.  The
+  offset tables take four values per coefficient.
+
+  The class is a template for the coefficient type and the type used
+  for sums.  <tt>haaragg</tt> is the version for the double haar
+  transform and <tt>haaragg_int</tt> the version for the haar_int
+  (S transform) coefficients, where sums, minima and maxima are exact
+  64-bit integers.  The energy is always a double.
+
+  \author Ian Kaplan
+ */
+template <class T_elem, class T_sum>
+class basic_haaragg
+{
+public:
+  /** the aggregates of a range */
+  typedef struct {
+    /** number of samples */
+    size_t count;
+    /** sum of the samples */
+    T_sum sum;
+    /** sum of the squares of the samples */
+    double energy;
+    /** smallest sample */
+    T_sum min;
+    /** largest sample */
+    T_sum max;
+  } aggregate;
+
+private:
+  /** disallow the copy constructor */
+  basic_haaragg( const basic_haaragg &rhs ) {}
+
+  /** the Haar coefficients */
+  const T_elem *coef;
+  /** number of coefficients */
+  size_t N;
+  /** sum of the offsets from the node average, for each node */
+  T_sum *sumOff;
+  /** sum of the squared offsets, for each node */
+  double *sqrOff;
+  /** smallest and largest offset, for each node */
+  T_sum *minOff;
+  T_sum *maxOff;
+  /** number of nodes visited by the last query */
+  size_t visited;
+
+  /** the child average offsets for a (normalized) haar difference
+      coefficient of a node with <i>s</i> samples */
+  static void childOffsets( const double d, const size_t s, double &lhs, double &rhs )
+  {
+    rhs = d / sqrt( (double)s );
+    lhs = -rhs;
+  }
+
+  /** the child average offsets for a haar_int difference coefficient */
+  static void childOffsets( const int d, const size_t s, T_sum &lhs, T_sum &rhs )
+  {
+    lhs = -(T_sum)(d >> 1);
+    rhs = lhs + (T_sum)d;
+  }
+
+  /** the average of all of the data, for haar coefficients */
+  static double rootAverage( const double c, const size_t n )
+  {
+    return c / sqrt( (double)n );
+  }
+
+  /** the average of all of the data, for haar_int coefficients */
+  static T_sum rootAverage( const int c, const size_t n )
+  {
+    return (T_sum)c;
+  }
+
+  /** add the aggregates of a node inside the range */
+  void addNode( const size_t h, const size_t s, const T_sum avg, aggregate &rslt ) const
+  {
+    T_sum s1 = 0;
+    double s2 = 0.0;
+    T_sum mn = 0;
+    T_sum mx = 0;
+    if (h < N) {
+      s1 = sumOff[h];
+      s2 = sqrOff[h];
+      mn = minOff[h];
+      mx = maxOff[h];
+    }
+    const double a = (double)avg;
+    if (rslt.count == 0 || avg + mn < rslt.min) {
+      rslt.min = avg + mn;
+    }
+    if (rslt.count == 0 || avg + mx > rslt.max) {
+      rslt.max = avg + mx;
+    }
+    rslt.count = rslt.count + s;
+    rslt.sum = rslt.sum + ((T_sum)s * avg) + s1;
+    rslt.energy = rslt.energy + ((double)s * a * a) + (2.0 * a * (double)s1) + s2;
+  }
+
+  /** walk down the tree, adding the nodes that are inside [a, b) */
+  void walk( const size_t h,
+             const size_t lo,
+             const size_t s,
+             const T_sum avg,
+             const size_t a,
+             const size_t b,
+             aggregate &rslt )
+  {
+    visited++;
+    if (lo >= a && lo + s <= b) {
+      addNode( h, s, avg, rslt );
+    }
+    else if (lo < b && lo + s > a) {
+      T_sum lhs, rhs;
+      childOffsets( coef[h], s, lhs, rhs );
+      const size_t half = s >> 1;
+      walk( 2*h, lo, half, avg + lhs, a, b, rslt );
+      walk( (2*h) + 1, lo + half, half, avg + rhs, a, b, rslt );
+    }
+  }
+
+public:
+  /**
+    Calculate the offset tables for the <i>n</i> Haar coefficients in
+    <i>vec</i> (the result of forwardTrans).  <i>n</i> must be a power
+    of two.
+   */
+  basic_haaragg( const T_elem *vec, const size_t n )
+  {
+    coef = vec;
+    N = n;
+    visited = 0;
+    sumOff = new T_sum[ N ];
+    sqrOff = new double[ N ];
+    minOff = new T_sum[ N ];
+    maxOff = new T_sum[ N ];
+
+    // bottom up: node h has s samples, its children s/2 samples.
+    // The children of the nodes at the lowest level are samples,
+    // whose offsets are zero.
+    size_t s = 2;
+    for (size_t levelStart = N >> 1; levelStart >= 1; levelStart = levelStart >> 1) {
+      const double half = (double)(s >> 1);
+      for (size_t h = levelStart; h < 2 * levelStart; h++) {
+        T_sum lhs, rhs;
+        childOffsets( coef[h], s, lhs, rhs );
+        T_sum s1L = 0, s1R = 0, mnL = 0, mnR = 0, mxL = 0, mxR = 0;
+        double s2L = 0.0, s2R = 0.0;
+        if (2*h < N) {
+          s1L = sumOff[2*h];      s1R = sumOff[(2*h) + 1];
+          s2L = sqrOff[2*h];      s2R = sqrOff[(2*h) + 1];
+          mnL = minOff[2*h];      mnR = minOff[(2*h) + 1];
+          mxL = maxOff[2*h];      mxR = maxOff[(2*h) + 1];
+        }
+        const T_sum halfS = (T_sum)(s >> 1);
+        sumOff[h] = (halfS * (lhs + rhs)) + s1L + s1R;
+        sqrOff[h] = (half * (double)lhs * (double)lhs) + (2.0 * (double)lhs * (double)s1L) + s2L +
+                    (half * (double)rhs * (double)rhs) + (2.0 * (double)rhs * (double)s1R) + s2R;
+        minOff[h] = (lhs + mnL < rhs + mnR) ? lhs + mnL : rhs + mnR;
+        maxOff[h] = (lhs + mxL > rhs + mxR) ? lhs + mxL : rhs + mxR;
+      }
+      s = s << 1;
+    }
+  }
+
+  /** free the offset tables */
+  ~basic_haaragg()
+  {
+    delete [] maxOff;
+    delete [] minOff;
+    delete [] sqrOff;
+    delete [] sumOff;
+  }
+
+  /**
+    Calculate the aggregates of the samples [a, b).  Returns false
+    (and prints an error) if the range is empty or is outside the
+    data.
+   */
+  bool query( const size_t a, const size_t b, aggregate &rslt )
+  {
+    rslt.count = 0;
+    rslt.sum = 0;
+    rslt.energy = 0.0;
+    rslt.min = 0;
+    rslt.max = 0;
+    visited = 0;
+    if (a >= b || b > N) {
+      printf("haaragg::query: bad range [%u, %u)\n", (unsigned)a, (unsigned)b );
+      return false;
+    }
+    walk( 1, 0, N, rootAverage( coef[0], N ), a, b, rslt );
+    return true;
+  }
+
+  /** sum of the samples [a, b) */
+  T_sum sum( const size_t a, const size_t b )
+  {
+    aggregate rslt;
+    query( a, b, rslt );
+    return rslt.sum;
+  }
+
+  /** mean of the samples [a, b) */
+  double mean( const size_t a, const size_t b )
+  {
+    aggregate rslt;
+    return (query( a, b, rslt )) ? (double)rslt.sum / (double)rslt.count : 0.0;
+  }
+
+  /** sum of the squares of the samples [a, b) */
+  double energy( const size_t a, const size_t b )
+  {
+    aggregate rslt;
+    query( a, b, rslt );
+    return rslt.energy;
+  }
+
+  /** number of tree nodes visited by the last query */
+  size_t nodesVisited() const { return visited; }
+}; // basic_haaragg
+
+
+/** aggregates for haar (double) coefficients */
+typedef basic_haaragg<double, double> haaragg;
+
+/** aggregates for haar_int (S transform) coefficients */
+typedef basic_haaragg<int, long long> haaragg_int;
+
+#endif
@@ -41,6 +41,8 @@
 #include "packcontainer.h"
 #include "packdata.h"
 #include "packdata_list.h"
+#include "packbasis.h"
+#include "packprofile.h"
 
 
 /**
@@ -59,7 +61,14 @@
   to this constructor.
 
   After the constructor completes, the data result can be
-  obtained by calling the getData() function.
+  obtained by calling the getData() function.  If the memory
+  for the calculation could not be allocated, getData() returns
+  zero.
+
+  The class is a template for the type of the data elements, which
+  must match the type of the packet tree (packtree is the double
+  version, packtree_int the integer version used for lossless
+  compression).
 
   The wavelet transforms used by this object are all derived
   from the liftbase class and are "lifting scheme" wavelet
@@ -80,35 +89,75 @@
   \author Ian Kaplan
 
  */
-class invpacktree {
+template <class T>
+class basic_invpacktree {
 private:
   /** wavelet transform object */
-  liftbase<packcontainer, double> *waveObj;
+  liftbase<basic_packcontainer<T>, T> *waveObj;
   /** disallow the copy constructor */
-  invpacktree( const invpacktree &rhs ) {}
+  basic_invpacktree( const basic_invpacktree &rhs ) {}
 
   /** inverse wavelet packet transform calculation stack */
-  LIST<packcontainer *> stack;
+  LIST<basic_packcontainer<T> *> stack;
 
   /** pointer to the inverse transform result */
-  const double *data;
+  const T *data;
   /** length of data */
   size_t N;
+  /** true if memory for the calculation could not be allocated */
+  bool allocError;
+  /** the phase timers and counters of the inverse transform */
+  packprofile::stats profStats;
 
 private:
-  void new_level( packdata<double> *elem );
-  void add_elem( packdata<double> *elem );
+  void new_level( packdata<T> *elem );
+  void add_elem( packdata<T> *elem );
   void reduce();
+  void add_basis( packbasis<T> &basis,
+                  T *vec,
+                  size_t &bit,
+                  size_t &offset,
+                  const size_t n,
+                  const typename packdata<T>::transformKind kind );
+  void skip_basis( packbasis<T> &basis,
+                   size_t &bit,
+                   size_t &offset,
+                   const size_t n );
+  void add_coarse( packbasis<T> &basis,
+                   T *vec,
+                   size_t &bit,
+                   size_t &offset,
+                   const size_t n,
+                   const size_t levels );
+  void finish();
 
 public:
-  invpacktree( packdata_list<double> &list, 
-	       liftbase<packcontainer, double> *w );
+  basic_invpacktree( packdata_list<T> &list, 
+                     liftbase<basic_packcontainer<T>, T> *w );
+  basic_invpacktree( packbasis<T> &basis,
+                     liftbase<basic_packcontainer<T>, T> *w );
+  basic_invpacktree( packbasis<T> &basis,
+                     liftbase<basic_packcontainer<T>, T> *w,
+                     const size_t levels );
   /** The destructor does nothing */
-  ~invpacktree() {}
+  ~basic_invpacktree() {}
 
   /** Get the result of the inverse packet transform */
-  const double *getData() { return data; }
+  const T *getData() { return data; }
+  /** Get the length of the result */
+  size_t length() const { return N; }
+  /** Get the phase timers and counters for the inverse transform
+      (see packprofile) */
+  void getStats( packprofile::stats &s ) const { s = profStats; }
   void pr();
-};
+}; // basic_invpacktree
+
+
+/** inverse wavelet packet transform for double values */
+typedef basic_invpacktree<double> invpacktree;
+
+/** inverse wavelet packet transform for integer values (lossless
+    compression) */
+typedef basic_invpacktree<int> invpacktree_int;
 
 #endif
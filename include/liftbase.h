@@ -29,6 +29,7 @@
   */ 
 
 #include <assert.h>
+#include <math.h>
 
 /**
   This is the base class for simple Lifting Scheme wavelets using
@@ -163,27 +164,43 @@ protected:
     inverse = 2 
   } transDirection;
 
+private:
+  /** split and merge temporaries up to this length are on the stack */
+  typedef enum { localBufLen = 128 } bogus;
+
+protected:
+
 
   /**
     Split the <i>vec</i> into even and odd elements,
     where the even elements are in the first half
     of the vector and the odd elements are in the
     second half.
+
+    The odd elements are copied to a temporary array of N/2
+    elements, so the split is O(N).  (The original version of
+    this function moved the elements with pairwise swaps, which
+    needs no temporary but is O(N<sup>2</sup>).)  Small temporaries
+    are allocated on the stack.
    */
   void split( T& vec, int N )
   {
-    
-    int start = 1;
-    int end = N - 1;
-
-    while (start < end) {
-      for (int i = start; i < end; i = i + 2) {
-	T_elem tmp = vec[i];
-	vec[i] = vec[i+1];
-	vec[i+1] = tmp;
-      }
-      start = start + 1;
-      end = end - 1;
+    const int half = N >> 1;
+    T_elem localBuf[ localBufLen ];
+    T_elem *odd = (half <= localBufLen) ? localBuf : new T_elem[ half ];
+
+    for (int i = 0; i < half; i++) {
+      odd[i] = vec[2*i+1];
+    }
+    for (int i = 1; i < half; i++) {
+      vec[i] = vec[2*i];
+    }
+    for (int i = 0; i < half; i++) {
+      vec[half+i] = odd[i];
+    }
+
+    if (odd != localBuf) {
+      delete [] odd;
     }
   }
 
@@ -193,22 +210,132 @@ protected:
     half of the N element region.  The result will be the
     combination of the odd and even elements in a region
     of length N.
-    
+
+    As in split, the even elements are copied to a temporary so
+    the merge is O(N).  Writing the result from the start of the
+    array never overwrites an odd element that has not been read.
    */
   void merge( T& vec, int N )
+  {
+    const int half = N >> 1;
+    T_elem localBuf[ localBufLen ];
+    T_elem *even = (half <= localBufLen) ? localBuf : new T_elem[ half ];
+
+    for (int i = 0; i < half; i++) {
+      even[i] = vec[i];
+    }
+    for (int i = 0; i < half; i++) {
+      T_elem odd = vec[half+i];
+      vec[2*i] = even[i];
+      vec[2*i+1] = odd;
+    }
+
+    if (even != localBuf) {
+      delete [] even;
+    }
+  }
+
+
+  /**
+    Split the N elements of <i>src</i> into <i>vec</i>, where the
+    even elements are in the first half of <i>vec</i> and the odd
+    elements are in the second half.
+
+    This is an out-of-place version of <tt>split</tt>.  It is used
+    by the wavelet packet transform, where the data from the parent
+    node is split directly into the storage for the child nodes.
+   */
+  void splitCopy( const T_elem *src, T& vec, int N )
   {
     int half = N >> 1;
-    int start = half-1;
-    int end = half;
-    
-    while (start > 0) {
-      for (int i = start; i < end; i = i + 2) {
-	T_elem tmp = vec[i];
-	vec[i] = vec[i+1];
-	vec[i+1] = tmp;
+
+    for (int i = 0; i < half; i++) {
+      vec[i] = src[2*i];
+      vec[i+half] = src[2*i+1];
+    }
+  }
+
+
+  /**
+    Split kernel for raw arrays: split the N elements of <i>src</i>
+    into the even elements, which are written to <i>lhs</i>, and the
+    odd elements, which are written to <i>rhs</i>.  The loop has no
+    branches or index operator calls, so the compiler can vectorize
+    it.
+   */
+  static void splitHalves( const T_elem *src, 
+                           T_elem *lhs, 
+                           T_elem *rhs, 
+                           int N )
+  {
+    int half = N >> 1;
+
+    for (int i = 0; i < half; i++) {
+      lhs[i] = src[2*i];
+      rhs[i] = src[2*i+1];
+    }
+  }
+
+  /**
+    Merge kernel for raw arrays: the inverse of splitHalves.  The
+    elements of <i>lhs</i> and <i>rhs</i> are interleaved into the
+    N element array <i>dst</i>.
+   */
+  static void mergeHalves( const T_elem *lhs, 
+                           const T_elem *rhs, 
+                           T_elem *dst, 
+                           int N )
+  {
+    int half = N >> 1;
+
+    for (int i = 0; i < half; i++) {
+      dst[2*i] = lhs[i];
+      dst[2*i+1] = rhs[i];
+    }
+  }
+
+  /**
+    Split kernel for <i>numCols</i> interleaved columns, where
+    element i of column c is src[(i * numCols) + c].  The even rows
+    of the N rows of <i>src</i> are written to <i>lhs</i> and the
+    odd rows are written to <i>rhs</i>.
+   */
+  static void splitRows( const T_elem *src, 
+                         T_elem *lhs, 
+                         T_elem *rhs, 
+                         int N,
+                         int numCols )
+  {
+    int half = N >> 1;
+
+    for (int i = 0; i < half; i++) {
+      const T_elem *even = src + (2 * i * numCols);
+      const T_elem *odd = even + numCols;
+      for (int c = 0; c < numCols; c++) {
+        lhs[(i * numCols) + c] = even[c];
+        rhs[(i * numCols) + c] = odd[c];
+      }
+    }
+  }
+
+  /**
+    Merge kernel for interleaved columns: the inverse of splitRows.
+   */
+  static void mergeRows( const T_elem *lhs, 
+                         const T_elem *rhs, 
+                         T_elem *dst, 
+                         int N,
+                         int numCols )
+  {
+    int half = N >> 1;
+
+    for (int i = 0; i < half; i++) {
+      T_elem *even = dst + (2 * i * numCols);
+      T_elem *odd = even + numCols;
+      for (int c = 0; c < numCols; c++) {
+        even[c] = lhs[(i * numCols) + c];
+        odd[c] = rhs[(i * numCols) + c];
       }
-      start = start - 1;
-      end = end + 1;
     }
   }
 
@@ -254,6 +381,20 @@ protected:
    */
   virtual void updateRev( T& vec, int N, transDirection direction ) {}
 
+
+  /**
+    The lifting steps of a forward transform step (the steps that
+    follow the split step).  A subclass that adds steps to the
+    forward transform step (e.g., normalization) should override
+    this function, so that the steps are applied by both
+    forwardStep and forwardStepFrom.
+   */
+  virtual void forwardLift( T& vec, const int n )
+  {
+    predict( vec, n, forward );
+    update( vec, n, forward );
+  } // forwardLift
+
 public:
 
   /**
@@ -262,10 +403,24 @@ public:
   virtual void forwardStep( T& vec, const int n )
   {
     split( vec, n );
-    predict( vec, n, forward );
-    update( vec, n, forward );
+    forwardLift( vec, n );
   } // forwardStep
 
+  /**
+    One step in the forward wavelet transform, calculated out of
+    place.  The N elements of <i>src</i> are not modified.  The
+    result is written to <i>vec</i>, where the low pass result is in
+    the lower half and the high pass result is in the upper half.
+
+    The split step copies the data from <i>src</i> into <i>vec</i>,
+    so no separate copy of the data is needed.
+   */
+  virtual void forwardStepFrom( const T_elem *src, T& vec, const int n )
+  {
+    splitCopy( src, vec, n );
+    forwardLift( vec, n );
+  } // forwardStepFrom
+
   /**
     Reverse forward transform step.  The result of the high
     pass filter is stored in the lower half of the array
@@ -280,6 +435,20 @@ public:
     assert(false);
   }
 
+  /**
+    Out of place version of the reverse forward transform step.
+    The default copies <i>src</i> into <i>vec</i> and calculates
+    forwardStepRev.  Subclasses that support frequency analysis
+    can override this function and avoid the copy.
+   */
+  virtual void forwardStepRevFrom( const T_elem *src, T& vec, const int n )
+  {
+    for (int i = 0; i < n; i++) {
+      vec[i] = src[i];
+    }
+    forwardStepRev( vec, n );
+  } // forwardStepRevFrom
+
   /**
     Simple wavelet Lifting Scheme forward transform
 
@@ -327,6 +496,160 @@ public:
   }
 
 
+  /**
+    One forward transform step calculated on raw arrays.  This is
+    used by the wavelet packet transform, where the data for the low
+    pass and high pass children are in separate arrays.
+
+    The N elements of <i>src</i> are read and the N/2 low pass
+    (scaling function) results are written to <i>lhs</i> and the N/2
+    high pass (wavelet function) results are written to <i>rhs</i>.
+    Since the kernels index raw arrays, rather than an object
+    with a [] operator, the compiler can vectorize the loops.
+
+    A subclass that supplies raw array kernels overrides this
+    function and returns true.  The default returns false, in which
+    case the caller should use forwardStepFrom with a container
+    object (e.g., packcontainer) instead.
+   */
+  virtual bool forwardSpan( const T_elem *src, 
+                            T_elem *lhs, 
+                            T_elem *rhs, 
+                            const int n )
+  {
+    return false;
+  } // forwardSpan
+
+  /**
+    Raw array version of the reverse forward transform step
+    (forwardStepRev), where the high pass result is written to
+    <i>lhs</i> and the low pass result is written to <i>rhs</i>.
+    The default returns false.
+   */
+  virtual bool forwardSpanRev( const T_elem *src, 
+                               T_elem *lhs, 
+                               T_elem *rhs, 
+                               const int n )
+  {
+    return false;
+  } // forwardSpanRev
+
+  /**
+    One inverse transform step calculated on raw arrays.  The
+    low pass data is in <i>lhs</i> and the high pass data is in
+    <i>rhs</i>.  The N element result is written to <i>dst</i>.
+    The <i>lhs</i> and <i>rhs</i> arrays are used as scratch
+    space and their contents are destroyed.  The default returns
+    false, in which case the caller should use inverseStep with
+    a container object.
+   */
+  virtual bool inverseSpan( T_elem *lhs, 
+                            T_elem *rhs, 
+                            T_elem *dst, 
+                            const int n )
+  {
+    return false;
+  } // inverseSpan
+
+  /**
+    One forward transform step calculated on <i>numCols</i> columns
+    at once.  The columns are interleaved: element i of column c is
+    vec[(i * numCols) + c], so each iteration of a kernel loop steps
+    all of the columns and the boundary elements of the columns are
+    calculated together, outside of the loop.  The first <i>n</i>
+    rows of <i>vec</i> are split into <i>tmp</i>, which must hold
+    n * numCols elements, and the result is written back to
+    <i>vec</i>, with the low pass rows in the lower half and the
+    high pass rows in the upper half.
+
+    A subclass that supplies column kernels overrides this function
+    and returns true.  The default returns false and does not change
+    <i>vec</i>, in which case the caller should transform the
+    columns one at a time.
+   */
+  virtual bool forwardSpanCols( T_elem *vec, 
+                                T_elem *tmp, 
+                                const int n, 
+                                const int numCols )
+  {
+    return false;
+  } // forwardSpanCols
+
+  /**
+    One inverse transform step on <i>numCols</i> interleaved columns
+    (see forwardSpanCols).  The default returns false.
+   */
+  virtual bool inverseSpanCols( T_elem *vec, 
+                                T_elem *tmp, 
+                                const int n, 
+                                const int numCols )
+  {
+    return false;
+  } // inverseSpanCols
+
+  /**
+    Ordered forward transform of <i>numCols</i> interleaved columns
+    of N elements (see forwardSpanCols).  The result of each column
+    is the same as the result of forwardTrans on the column.
+    Returns false, without changing <i>vec</i>, if the subclass does
+    not supply column kernels.
+   */
+  bool forwardTransCols( T_elem *vec, 
+                         T_elem *tmp, 
+                         const int N, 
+                         const int numCols )
+  {
+    bool ok = true;
+    for (int n = N; ok && n > 1; n = n >> 1) {
+      ok = forwardSpanCols( vec, tmp, n, numCols );
+    }
+    return ok;
+  } // forwardTransCols
+
+  /**
+    Inverse of forwardTransCols.  Returns false, without changing
+    <i>vec</i>, if the subclass does not supply column kernels.
+   */
+  bool inverseTransCols( T_elem *vec, 
+                         T_elem *tmp, 
+                         const int N, 
+                         const int numCols )
+  {
+    bool ok = true;
+    for (int n = 2; ok && n <= N; n = n << 1) {
+      ok = inverseSpanCols( vec, tmp, n, numCols );
+    }
+    return ok;
+  } // inverseTransCols
+
+  /**
+    Return true if the raw array kernels treat the data as periodic,
+    so the first elements of the inverseSpan result are calculated
+    from the last elements of <i>lhs</i> and <i>rhs</i> (the
+    Daubechies D4 wavelet).  The other wavelets handle the ends of
+    the data with special case predictions and return false.  The
+    ranged inverse transform (rangeinv) uses this to decide how a
+    window of coefficients is gathered.
+   */
+  virtual bool spanPeriodic() const
+  {
+    return false;
+  } // spanPeriodic
+
+  /**
+    The gain of the low pass (scaling function) result of one
+    forward step: the low pass values of a level are the local
+    averages of the data multiplied by this value.  It is one for
+    the wavelets that calculate averages (haar_classic, line and
+    the integer wavelets) and sqrt(2) for the normalized wavelets
+    (haar and Daubechies D4).
+   */
+  virtual double lowPassGain() const
+  {
+    return 1.0;
+  } // lowPassGain
+
+
   /**
     Default two step Lifting Scheme inverse wavelet transform
 
@@ -345,6 +668,40 @@ public:
   } // inverseTrans
 
 
+  /**
+    Partial inverse of an ordered wavelet transform, which stops
+    <i>levels</i> steps before the end.
+
+    The coefficients are ordered from low to high frequency, so the
+    first N/2<sup>levels</sup> elements of the forwardTrans result
+    are a complete ordered transform of the low pass result at that
+    level.  The inverse transform of this prefix is calculated in
+    place and the result, a version of the data at 1/2<sup>levels</sup>
+    of the resolution, is divided by the low pass gain (see
+    lowPassGain), so it is on the same scale as the data.  Each
+    element is then the (smoothed) average of 2<sup>levels</sup>
+    data elements.  The coefficients after the prefix are not read,
+    so a reader that only needs the coarse version of the data does
+    not need them.
+
+    When <i>levels</i> is zero the result is the same as inverseTrans.
+   */
+  void inverseTransCoarse( T& vec, const int N, const int levels )
+  {
+    const int n = N >> levels;
+
+    inverseTrans( vec, n );
+
+    const double gain = lowPassGain();
+    if (gain != 1.0 && levels > 0) {
+      const double scale = 1.0 / pow( gain, (double)levels );
+      for (int i = 0; i < n; i++) {
+        vec[i] = (T_elem)(vec[i] * scale);
+      }
+    }
+  } // inverseTransCoarse
+
+
 }; // liftbase
 
 #endif
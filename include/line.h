@@ -3,6 +3,8 @@
 #ifndef _LINE_H_
 #define _LINE_H_
 
+#include <string.h>
+
 #include "liftbase.h"
 
 
@@ -47,11 +49,15 @@
      iank@bearcave.com
 </pre>
 
+  The template is instantiated with an array type (or an object
+  that acts like an array) and the type of the data elements, which
+  defaults to double.
+
   \author Ian Kaplan
 
  */
-template <class T>
-class line : public liftbase<T, double> {
+template <class T, class T_elem = double>
+class line : public liftbase<T, T_elem> {
 
 private:
 
@@ -122,9 +128,9 @@ private:
      </pre>
 
     */
-   double new_y( double y1, double y2)
+   T_elem new_y( T_elem y1, T_elem y2)
    {
-     double y = 2 * y2 - y1;
+     T_elem y = 2 * y2 - y1;
      return y;
    }
 
@@ -169,7 +175,7 @@ protected:
   void predict( T& vec, int N, transDirection direction )
   {
     int half = N >> 1;
-    double predictVal;
+    T_elem predictVal;
 
     for (int i = 0; i < half; i++) {
       int j = i + half;
@@ -181,7 +187,7 @@ protected:
       }
       else {
 	// calculate the last "odd" prediction
-	double n_plus1 = new_y( vec[i-1], vec[i] );
+	T_elem n_plus1 = new_y( vec[i-1], vec[i] );
 	predictVal = (vec[i] + n_plus1)/2;
       }
 
@@ -256,7 +262,7 @@ protected:
 
     for (int i = 0; i < half; i++) {
       int j = i + half;
-      double val;
+      T_elem val;
 
       if (i == 0) {
 	val = vec[j]/2.0;
@@ -276,6 +282,218 @@ protected:
     } // for    
   }
 
+  /**
+    Line predict step on raw arrays.  The boundary element is
+    peeled off, so the main loop has no branches.
+   */
+  static void predictSpan( const T_elem *lhs, 
+                           T_elem *rhs, 
+                           const int half, 
+                           transDirection direction )
+  {
+    T_elem predictVal;
+    int last = half - 1;
+
+    if (half == 1) {
+      predictVal = lhs[0];
+    }
+    else {
+      predictVal = (lhs[last] + (2 * lhs[last] - lhs[last-1]))/2;
+    }
+
+    if (direction == forward) {
+      for (int i = 0; i < last; i++) {
+	rhs[i] = rhs[i] - (lhs[i] + lhs[i+1])/2;
+      }
+      rhs[last] = rhs[last] - predictVal;
+    }
+    else {
+      for (int i = 0; i < last; i++) {
+	rhs[i] = rhs[i] + (lhs[i] + lhs[i+1])/2;
+      }
+      rhs[last] = rhs[last] + predictVal;
+    }
+  } // predictSpan
+
+  /**
+    Line update step on raw arrays, with the first element peeled
+    off.
+   */
+  static void updateSpan( T_elem *lhs, 
+                          const T_elem *rhs, 
+                          const int half, 
+                          transDirection direction )
+  {
+    if (direction == forward) {
+      lhs[0] = lhs[0] + rhs[0]/2.0;
+      for (int i = 1; i < half; i++) {
+	lhs[i] = lhs[i] + (rhs[i-1] + rhs[i])/4.0;
+      }
+    }
+    else {
+      lhs[0] = lhs[0] - rhs[0]/2.0;
+      for (int i = 1; i < half; i++) {
+	lhs[i] = lhs[i] - (rhs[i-1] + rhs[i])/4.0;
+      }
+    }
+  } // updateSpan
+
+  /**
+    Line predict step on interleaved columns (see
+    liftbase::forwardSpanCols).  The boundary row is peeled off, so
+    the main loop has no branches and its inner loop steps all of
+    the columns.
+   */
+  static void predictCols( const T_elem *lhs, 
+                           T_elem *rhs, 
+                           const int half, 
+                           const int numCols,
+                           transDirection direction )
+  {
+    const int last = half - 1;
+    const T_elem *lLast = lhs + (last * numCols);
+    T_elem *rLast = rhs + (last * numCols);
+
+    if (direction == forward) {
+      for (int i = 0; i < last; i++) {
+        const T_elem *l0 = lhs + (i * numCols);
+        const T_elem *l1 = l0 + numCols;
+        T_elem *r = rhs + (i * numCols);
+        for (int c = 0; c < numCols; c++) {
+          r[c] = r[c] - (l0[c] + l1[c])/2;
+        }
+      }
+      if (half == 1) {
+        for (int c = 0; c < numCols; c++) {
+          rLast[c] = rLast[c] - lLast[c];
+        }
+      }
+      else {
+        for (int c = 0; c < numCols; c++) {
+          rLast[c] = rLast[c] - (lLast[c] + (2 * lLast[c] - lLast[c-numCols]))/2;
+        }
+      }
+    }
+    else {
+      for (int i = 0; i < last; i++) {
+        const T_elem *l0 = lhs + (i * numCols);
+        const T_elem *l1 = l0 + numCols;
+        T_elem *r = rhs + (i * numCols);
+        for (int c = 0; c < numCols; c++) {
+          r[c] = r[c] + (l0[c] + l1[c])/2;
+        }
+      }
+      if (half == 1) {
+        for (int c = 0; c < numCols; c++) {
+          rLast[c] = rLast[c] + lLast[c];
+        }
+      }
+      else {
+        for (int c = 0; c < numCols; c++) {
+          rLast[c] = rLast[c] + (lLast[c] + (2 * lLast[c] - lLast[c-numCols]))/2;
+        }
+      }
+    }
+  } // predictCols
+
+  /**
+    Line update step on interleaved columns, with the first row
+    peeled off.
+   */
+  static void updateCols( T_elem *lhs, 
+                          const T_elem *rhs, 
+                          const int half, 
+                          const int numCols,
+                          transDirection direction )
+  {
+    if (direction == forward) {
+      for (int c = 0; c < numCols; c++) {
+        lhs[c] = lhs[c] + rhs[c]/2.0;
+      }
+      for (int i = 1; i < half; i++) {
+        T_elem *l = lhs + (i * numCols);
+        const T_elem *r0 = rhs + ((i-1) * numCols);
+        const T_elem *r1 = r0 + numCols;
+        for (int c = 0; c < numCols; c++) {
+          l[c] = l[c] + (r0[c] + r1[c])/4.0;
+        }
+      }
+    }
+    else {
+      for (int c = 0; c < numCols; c++) {
+        lhs[c] = lhs[c] - rhs[c]/2.0;
+      }
+      for (int i = 1; i < half; i++) {
+        T_elem *l = lhs + (i * numCols);
+        const T_elem *r0 = rhs + ((i-1) * numCols);
+        const T_elem *r1 = r0 + numCols;
+        for (int c = 0; c < numCols; c++) {
+          l[c] = l[c] - (r0[c] + r1[c])/4.0;
+        }
+      }
+    }
+  } // updateCols
+
+public:
+
+  /**
+    Forward line wavelet step on raw arrays
+   */
+  bool forwardSpan( const T_elem *src, T_elem *lhs, T_elem *rhs, const int n )
+  {
+    const int half = n >> 1;
+
+    splitHalves( src, lhs, rhs, n );
+    predictSpan( lhs, rhs, half, forward );
+    updateSpan( lhs, rhs, half, forward );
+    return true;
+  } // forwardSpan
+
+  /**
+    Inverse line wavelet step on raw arrays
+   */
+  bool inverseSpan( T_elem *lhs, T_elem *rhs, T_elem *dst, const int n )
+  {
+    const int half = n >> 1;
+
+    updateSpan( lhs, rhs, half, inverse );
+    predictSpan( lhs, rhs, half, inverse );
+    mergeHalves( lhs, rhs, dst, n );
+    return true;
+  } // inverseSpan
+
+  /**
+    Forward line wavelet step on interleaved columns
+   */
+  bool forwardSpanCols( T_elem *vec, T_elem *tmp, const int n, const int numCols )
+  {
+    const int half = n >> 1;
+    T_elem *lhs = tmp;
+    T_elem *rhs = tmp + (half * numCols);
+
+    splitRows( vec, lhs, rhs, n, numCols );
+    predictCols( lhs, rhs, half, numCols, forward );
+    updateCols( lhs, rhs, half, numCols, forward );
+    memcpy( vec, tmp, n * numCols * sizeof( T_elem ) );
+    return true;
+  } // forwardSpanCols
+
+  /**
+    Inverse line wavelet step on interleaved columns
+   */
+  bool inverseSpanCols( T_elem *vec, T_elem *tmp, const int n, const int numCols )
+  {
+    const int half = n >> 1;
+    T_elem *lhs = vec;
+    T_elem *rhs = vec + (half * numCols);
+
+    updateCols( lhs, rhs, half, numCols, inverse );
+    predictCols( lhs, rhs, half, numCols, inverse );
+    mergeRows( lhs, rhs, tmp, n, numCols );
+    memcpy( vec, tmp, n * numCols * sizeof( T_elem ) );
+    return true;
+  } // inverseSpanCols
+
 }; // line
 
 #endif
@@ -69,8 +69,9 @@ public:
 	/** pointer to the next element in the list */
         list_type *next;
         /** override the default new operator to allocate
-           list_type objects from the a memory pool */
-        void *operator new(size_t num_bytes)
+           list_type objects from the a memory pool (new returns
+           zero if the memory cannot be allocated) */
+        void *operator new(size_t num_bytes) throw()
         {
           block_pool mem_pool;
 
@@ -113,12 +114,16 @@ public:
   } // dealloc
 
 
-  /** Add an element to the list */
-  void add( T data )
+  /** Add an element to the list.  Return false if the memory
+      for the list element could not be allocated. */
+  bool add( T data )
   {
     list_type *t;
     
     t = new list_type();
+    if (t == 0) {
+      return false;
+    }
     t->data = data;
     t->next = 0;
     if (list == 0) {
@@ -128,6 +133,7 @@ public:
       t->next = list;
       list = t;
     }
+    return true;
   }  // add
 
 
@@ -0,0 +1,332 @@
+
+#ifndef _PACKBASIS_H_
+#define _PACKBASIS_H_
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "blockpool.h"
+
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  \author Ian Kaplan
+
+ */
+
+
+/**
+
+  A compact, self contained description of a wavelet packet
+  "best basis".
+
+  The packdata_list returned by the wavelet packet tree is a linked
+  list of pointers into the tree.  It can only be used while the tree
+  (and the memory pool that the tree was allocated from) exists.  The
+  packbasis object stores the same information in a single contiguous
+  block of memory:
+
+  <ol>
+  <li>
+  A header, which records the length of the original data, the number
+  of best basis nodes, the size of the shape bitmap and the size of
+  the whole block.
+  </li>
+  <li>
+  A bitmap that describes the shape of the best basis tree.  The tree
+  is traversed top down, left to right (pre-order).  A one bit
+  indicates that the node was split into a low pass and a high pass
+  child.  A zero bit indicates that the node is part of the best
+  basis.  A tree with <i>n</i> best basis nodes is described by
+  2<i>n</i>-1 bits.
+  </li>
+  <li>
+  The coefficients of the best basis nodes, stored one after the
+  other in the order in which they are found in the traversal (the
+  same order as the packdata_list).  Since the best basis nodes
+  partition the tree, there are always N coefficients.
+  </li>
+  </ol>
+
+  Since the block contains no pointers, it can be copied, cached,
+  written to a file or sent to another process with a single
+  <tt>memcpy</tt>.  The block is rebuilt from a set of bytes with
+  the <tt>packbasis( const void *, size_t )</tt> constructor.
+
+  Like the packdata_list, a packbasis object is just a package for a
+  pointer to the block, which is allocated from the memory pool.  The
+  object can be passed by value and the block is recovered when the
+  memory pool is freed.
+
+  \author Ian Kaplan
+
+ */
+template <class T>
+class packbasis {
+public:
+  /** The header at the start of the descriptor block */
+  typedef struct {
+    /** identifies the block as a packbasis descriptor */
+    size_t magic;
+    /** size of a coefficient, in bytes */
+    size_t elemSize;
+    /** length of the original data set */
+    size_t N;
+    /** number of best basis nodes */
+    size_t numNodes;
+    /** number of bits in the shape bitmap */
+    size_t numBits;
+    /** total size of the block, in bytes */
+    size_t numBytes;
+  } header;
+
+private:
+  typedef enum { basisMagic = 0x5342504b, // "KPBS"
+                 coefAlign = 8 } bogus;
+
+  /** the descriptor block (which starts with the header) */
+  header *hdr;
+
+  /** byte offset of the coefficients from the start of the block */
+  static size_t coefOffset( size_t numBits )
+  {
+    size_t offset = sizeof( header ) + ((numBits + 7) >> 3);
+    offset = ((offset + (coefAlign-1))/coefAlign) * coefAlign;
+    return offset;
+  }
+
+  /** return a pointer to the shape bitmap */
+  unsigned char *shape() const
+  {
+    return ((unsigned char *)hdr) + sizeof( header );
+  }
+
+  /**
+    Walk the shape bitmap <i>shape</i> from bit <i>bit</i> for a node
+    of length <i>n</i>, counting the best basis nodes in <i>count</i>
+    and their lengths in <i>sum</i>.  Returns false if the bitmap
+    runs past <i>numBits</i> bits or splits a node that is shorter
+    than two elements.
+   */
+  static bool walkShape( const unsigned char *shape,
+                         const size_t numBits,
+                         size_t &bit,
+                         const size_t n,
+                         size_t &count,
+                         size_t &sum )
+  {
+    if (bit >= numBits) {
+      return false;
+    }
+    const bool split = ((shape[bit >> 3] >> (bit & 0x7)) & 0x1) != 0;
+    bit++;
+    if (split) {
+      if (n < 2) {
+        return false;
+      }
+      return walkShape( shape, numBits, bit, n/2, count, sum ) &&
+             walkShape( shape, numBits, bit, n/2, count, sum );
+    }
+    count++;
+    sum = sum + n;
+    return true;
+  } // walkShape
+
+  /**
+    Return true if the shape bitmap of the header <i>h</i> (which
+    follows the header in memory) describes a best basis tree for
+    N elements: the walk uses exactly numBits bits and finds numNodes
+    best basis nodes, whose lengths add up to N.
+   */
+  static bool validShape( const header *h )
+  {
+    const unsigned char *bits = ((const unsigned char *)h) + sizeof( header );
+    size_t bit = 0;
+    size_t count = 0;
+    size_t sum = 0;
+
+    return (walkShape( bits, h->numBits, bit, h->N, count, sum ) &&
+            bit == h->numBits && count == h->numNodes && sum == h->N);
+  } // validShape
+
+public:
+  /** An empty descriptor */
+  packbasis()
+  {
+    hdr = 0;
+  }
+
+  /**
+    Allocate a descriptor block for a best basis with <i>numNodes</i>
+    nodes whose shape is described by <i>numBits</i> bits.  The
+    shape bits (and the padding that follows them) are cleared.  The
+    coefficients are filled in by the caller (see
+    packtree::getBestBasis).
+
+    \arg n The length of the original data set
+    \arg numNodes The number of best basis nodes
+    \arg numBits The number of bits in the shape bitmap
+   */
+  packbasis( const size_t n, const size_t numNodes, const size_t numBits )
+  {
+    block_pool mem_pool;
+    const size_t numBytes = coefOffset( numBits ) + (n * sizeof( T ));
+
+    hdr = (header *)mem_pool.pool_alloc( numBytes );
+    if (hdr != 0) {
+      hdr->magic = basisMagic;
+      hdr->elemSize = sizeof( T );
+      hdr->N = n;
+      hdr->numNodes = numNodes;
+      hdr->numBits = numBits;
+      hdr->numBytes = numBytes;
+      // the pool block is not cleared: clear the bitmap and the padding
+      // before the coefficients, so the block can be written as bytes
+      memset( shape(), 0, coefOffset( numBits ) - sizeof( header ) );
+    }
+  }
+
+  /**
+    Rebuild a descriptor from a block of bytes that was obtained
+    from <tt>bytes()</tt> (e.g., read from a file or received from
+    another process).  The bytes are copied into the memory pool.
+    If the bytes do not describe a valid descriptor (including a
+    shape bitmap that does not describe a tree over the N
+    coefficients) an error is printed and the descriptor will be empty (<tt>ok()</tt> returns
+    false).
+   */
+  packbasis( const void *buf, const size_t len )
+  {
+    hdr = 0;
+    const header *h = (const header *)buf;
+
+    if (buf == 0 || len < sizeof( header )) {
+      printf("packbasis: descriptor is too short\n");
+    }
+    else if (h->magic != basisMagic || h->elemSize != sizeof( T )) {
+      printf("packbasis: bad descriptor header\n");
+    }
+    else if (h->numBytes != len ||
+             h->numBits > (len - sizeof( header )) * 8 ||
+             h->N > len / sizeof( T ) ||
+             h->numBytes != coefOffset( h->numBits ) + (h->N * sizeof( T ))) {
+      printf("packbasis: descriptor size is wrong\n");
+    }
+    else if (! validShape( h )) {
+      printf("packbasis: bad descriptor shape\n");
+    }
+    else {
+      block_pool mem_pool;
+
+      hdr = (header *)mem_pool.pool_alloc( len );
+      if (hdr != 0) {
+        memcpy( hdr, buf, len );
+      }
+    }
+  }
+
+  /** return true if the descriptor contains a best basis */
+  bool ok() const { return (hdr != 0); }
+
+  /** the start of the descriptor block */
+  const void *bytes() const { return hdr; }
+
+  /** the size of the descriptor block, in bytes */
+  size_t byteSize() const { return (hdr != 0) ? hdr->numBytes : 0; }
+
+  /** length of the original data set (and the number of coefficients) */
+  size_t length() const { return (hdr != 0) ? hdr->N : 0; }
+
+  /** number of nodes in the best basis */
+  size_t numNodes() const { return (hdr != 0) ? hdr->numNodes : 0; }
+
+  /** number of bits in the shape bitmap */
+  size_t numBits() const { return (hdr != 0) ? hdr->numBits : 0; }
+
+  /** get shape bit <i>i</i>: true if the node was split */
+  bool shapeBit( const size_t i ) const
+  {
+    assert( i < hdr->numBits );
+    return ((shape()[i >> 3] >> (i & 0x7)) & 0x1) != 0;
+  }
+
+  /** set shape bit <i>i</i> (e.g., mark the node as split) */
+  void shapeBit( const size_t i, const bool split )
+  {
+    assert( i < hdr->numBits );
+    if (split) {
+      shape()[i >> 3] |= (unsigned char)(1 << (i & 0x7));
+    }
+    else {
+      shape()[i >> 3] &= (unsigned char)~(1 << (i & 0x7));
+    }
+  }
+
+  /** the best basis coefficients, in basis order */
+  T *coef() const
+  {
+    return (T *)(((char *)hdr) + coefOffset( hdr->numBits ));
+  }
+
+  /**
+    Print the best basis coefficients.  Each best basis node is
+    printed on a separate line, as in packdata_list::pr.
+   */
+  void pr() const
+  {
+    if (hdr != 0) {
+      const T *vec = coef();
+      size_t bit = 0;
+      size_t offset = 0;
+      prNode( bit, vec, offset, hdr->N );
+      printf("\n");
+    }
+  } // pr
+
+private:
+  /** recursively walk the shape bitmap, printing the basis nodes */
+  void prNode( size_t &bit, const T *vec, size_t &offset, const size_t n ) const
+  {
+    if (shapeBit( bit++ )) {
+      prNode( bit, vec, offset, n/2 );
+      prNode( bit, vec, offset, n/2 );
+    }
+    else {
+      for (size_t i = 0; i < n; i++) {
+        printf("%7.4f ", (double)vec[offset + i] );
+      }
+      printf("\n");
+      offset = offset + n;
+    }
+  } // prNode
+
+}; // packbasis
+
+#endif
@@ -48,21 +48,35 @@
   hand side half (the result of the wavelet function).  By allowing
   the two halves of the array to be referenced, copying is avoided.
 
+  The [] operators must decide which half an index refers to, so
+  every element access includes a branch.  Wavelets that provide raw
+  array kernels (see liftbase::forwardSpan and liftbase::inverseSpan)
+  are calculated directly on the lhs and rhs arrays.  For these
+  wavelets the packcontainer is only used to hold the two halves on
+  the inverse transform stack.  The [] operators remain as an adapter
+  for wavelets that do not provide raw array kernels.
+
+  The container is a template, so that it can be used with wavelet
+  packet trees for any element type (see basic_packtree_base).  The
+  <tt>packcontainer</tt> (double) and <tt>packcontainer_int</tt> (int)
+  typedefs are used by the wavelet classes.
+
  */
-class packcontainer {
+template <class T>
+class basic_packcontainer {
 private:
   /** number of elements at this packet tree level */
   size_t N;
   /** left (low pass) half of the packcontainer data */
-  double* lhs;
+  T* lhs;
   /** right (high pass) half of the packnode data */
-  double* rhs;
+  T* rhs;
 
 private:
   /** disallow the copy constructor */
-  packcontainer( const packcontainer &rhs ) {};
+  basic_packcontainer( const basic_packcontainer &rhs ) {};
   /** disallow default constructor */
-  packcontainer() {};
+  basic_packcontainer() {};
 
 public:
 
@@ -85,7 +99,7 @@ public:
     of the object passed to the constructor.
 
    */
-  packcontainer( packnode<double>* node )
+  basic_packcontainer( packnode<T>* node )
   {
     assert( node != 0 );
     N = node->length();
@@ -93,15 +107,15 @@ public:
 
     size_t half = N >> 1;
     block_pool mem_pool;
-    size_t num_bytes = half * sizeof(double);
+    size_t num_bytes = half * sizeof(T);
 
-    lhs = (double *)mem_pool.pool_alloc( num_bytes );
-    rhs = (double *)mem_pool.pool_alloc( num_bytes );
+    lhs = (T *)mem_pool.pool_alloc( num_bytes, block_pool::simd_align );
+    rhs = (T *)mem_pool.pool_alloc( num_bytes, block_pool::simd_align );
 
     for (size_t i = 0; i < N; i++) {
       (*this)[i] = (*node)[i];
     }
-  } // packcontainer
+  } // basic_packcontainer
 
 
   /** 
@@ -114,7 +128,7 @@ public:
     is calculated.
 
   */
-  packcontainer( size_t n )
+  basic_packcontainer( size_t n )
   {
     N = n;
     lhs = 0;
@@ -125,11 +139,12 @@ public:
     This is a local implementation of new.  When new
     is applied to a packcontainer object, memory will
     be allocated from a memory pool, rather than from
-    the system memory pool.
+    the system memory pool.  If the memory cannot be
+    allocated, new returns zero.
    */
 
   
-  void *operator new( size_t num_bytes )
+  void *operator new( size_t num_bytes ) throw()
   {
     block_pool mem_pool;
 
@@ -139,7 +154,7 @@ public:
   
 
   /** LHS [] operator */
-  double &operator[]( const size_t i )
+  T &operator[]( const size_t i )
   {
     assert( i < N );
     size_t half = N >> 1;
@@ -152,7 +167,7 @@ public:
   }
 
   /** RHS [] operator */
-  double operator[]( const size_t i ) const
+  T operator[]( const size_t i ) const
   {
     assert( i < N );
     size_t half = N >> 1;
@@ -165,14 +180,14 @@ public:
   }
 
   /** return the left hand size array */
-  double* lhsData() { return lhs; }
+  T* lhsData() { return lhs; }
   /** return the right hand size array */
-  double* rhsData() { return rhs; }
+  T* rhsData() { return rhs; }
 
   /** set the left hand size array */
-  void lhsData(double* l) { lhs = l; }
+  void lhsData(T* l) { lhs = l; }
   /** set the right hand size array */
-  void rhsData(double* r) { rhs = r; }
+  void rhsData(T* r) { rhs = r; }
 
   /** return the length of the data in the packet
       container.  Note that this length is 
@@ -181,6 +196,13 @@ public:
   */
   size_t length() { return N; }
 
-}; // packcontainer
+}; // basic_packcontainer
+
+
+/** the packcontainer for the double wavelet packet transform */
+typedef basic_packcontainer<double> packcontainer;
+
+/** the packcontainer for the integer wavelet packet transform */
+typedef basic_packcontainer<int> packcontainer_int;
 
 #endif
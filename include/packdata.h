@@ -95,10 +95,11 @@ public:
 
   /**
     Overload the standard <i>new</i> operator and allocate
-    memory from the memory pool.
+    memory from the memory pool.  The operator does not throw: if
+    the memory cannot be allocated, <i>new</i> returns zero.
    */
   
-  void *operator new( size_t num_bytes )
+  void *operator new( size_t num_bytes ) throw()
   {
     block_pool mem_pool;
 
@@ -111,7 +112,7 @@ public:
   void pr() const
   {
     for (int i = 0; i < N; i++) {
-      printf("%7.4f ", data[i] );
+      printf("%7.4f ", (double)data[i] );
     }
     printf("\n");
   } // pr
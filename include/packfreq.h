@@ -70,39 +70,51 @@
 
   If the vector passed to the constructor contains N double values, the
   result of the constructor will be a wavelet packet tree with
-  log<sub>2</sub>(N) levels.
+  log<sub>2</sub>(N) levels.  An optional minimum node length
+  stops the decomposition early, at nodes of that length.
+
+  The class is a template for the type of the data elements
+  (e.g., basic_packfreq<float> builds the tree in half the memory
+  of the double <tt>packfreq</tt> tree).
 
   \author Ian Kaplan
 
  */
-class packfreq : public packtree_base {
+template <class T>
+class basic_packfreq : public basic_packtree_base<T> {
 private:
   /** Level basis matrix */
-  GrowableArray<packnode<double> *> mat;
+  GrowableArray<packnode<T> *> mat;
 
-  void findLevel( packnode<double>* top, 
+  void findLevel( packnode<T>* top, 
 		  size_t cur_level, 
 		  const size_t level );
 
 protected:
   /** disallow the copy constructor */
-  packfreq( const packfreq &rhs ) {};
+  basic_packfreq( const basic_packfreq &rhs ) {};
   /** disallow the default constructor */
-  packfreq() {};
+  basic_packfreq() {};
 
 public:
-  packfreq( const double *vec, 
-            const size_t n, 
-            liftbase<packcontainer, double> *w ); 
+  basic_packfreq( const T *vec, 
+                  const size_t n, 
+                  liftbase<basic_packcontainer<T>, T> *w,
+                  packtree_base::inputKind kind = packtree_base::CopyInput,
+                  const size_t minLength = 1 ); 
 
   /** destructor does nothing */
-  ~packfreq() {}
+  ~basic_packfreq() {}
 
   void getLevel( const size_t level );
 
   void plotMat(const size_t N);
 
   void prMat();
-}; // packfreq
+}; // basic_packfreq
+
+
+/** frequency analysis wavelet packet tree for double values */
+typedef basic_packfreq<double> packfreq;
 
 #endif
@@ -56,7 +56,9 @@
   data is set by the class constructor.
 
   Once the wavelet packet tree is built a cost value is assigned to
-  each node in the tree.
+  each node in the tree.  The cost is a double for all element
+  types, so integer and floating point trees share the best basis
+  calculation.
 
  */
 template<class T>
@@ -70,7 +72,7 @@ private:
   packnode* rightChild;
 
   /** cost value for this level */
-  T costVal;
+  double costVal;
 
   /** chosen == true: node is part of the best basis of the
       wavelet transform, otherwise, false. */
@@ -126,7 +128,7 @@ public:
   void prBestBasis() const
   {
     for (int i = 0; i < N; i++) {
-      printf("%7.4f ", data[i] );
+      printf("%7.4f ", (double)data[i] );
     }
     if (chosen) {
       printf("  *");
@@ -146,9 +148,9 @@ public:
   packnode *rhsChild(void) { return rightChild; }
 
   /** set the cost value for the node */
-  void cost( T val ) { costVal = val; }
+  void cost( double val ) { costVal = val; }
   /** get the cost value for the node */
-  T cost(void) { return costVal; }
+  double cost(void) { return costVal; }
 
   /** the "chosen" flag marks a node for inclusion in
       the best basis set.
@@ -0,0 +1,217 @@
+
+#ifndef _PACKPROFILE_H_
+#define _PACKPROFILE_H_
+
+#include <stddef.h>
+#include <stdio.h>
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+
+   You may use this source code without limitation and without
+   fee as long as you include:
+
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+
+   Please send any bug fixes or suggested source changes to:
+
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+/**
+  Phase timers and counters for the wavelet packet pipeline.
+
+  When the library is compiled with PACKET_PROFILE defined, the
+  wavelet packet code records, for each phase of the calculation,
+  the elapsed (wall clock) time, the number of calls, the number of
+  nodes created or visited, the number of bytes allocated and the
+  number of coefficients touched.  The phases are
+
+  <ul>
+  <li>
+  <b>Build</b>: building the wavelet packet tree (packtree_base::buildTree).
+  The nodes are the tree nodes created, the bytes the memory allocated
+  for them and the coefficients the number of values read by the
+  forward transform steps.
+  </li>
+  <li>
+  <b>Cost</b>: calculating the cost function on the tree
+  (costbase::traverse).  The nodes and coefficients are the nodes
+  and values passed to costCalc.
+  </li>
+  <li>
+  <b>BestBasis</b>: the best basis walk of the tree (packtree::bestBasis).
+  The nodes are the nodes visited.
+  </li>
+  <li>
+  <b>Inverse</b>: the inverse wavelet packet transform (invpacktree).
+  The nodes are the containers created on the inverse transform
+  stack, the bytes the memory allocated for them and the coefficients
+  the number of values written by the inverse transform steps.
+  </li>
+  <li>
+  <b>Alloc</b>: the memory pool (block_pool::pool_alloc).  The
+  bytes are the bytes requested.
+  </li>
+  </ul>
+
+  The phases nest: the Build and Inverse time includes the Alloc time
+  for the memory that they allocate.
+
+  The counters are kept for each tree.  A packet tree (packtree_base)
+  and an invpacktree hold a stats structure, and a thread local
+  "current stats" pointer is pointed at it while the tree is built,
+  while the best basis is calculated and while the inverse transform
+  is calculated (see scope).  The cost functions do not know which
+  tree they are calculated on, so a packet tree is also made the
+  current tree of its thread when it is constructed, until it is
+  destroyed or another tree is constructed on the thread: the cost
+  calculated between the construction of a tree and the construction
+  of the next tree is added to the tree.  The counters are added to
+  the current stats (if there are any) and to a set of global
+  counters, which cover all of the trees.  The global counters (see
+  snapshot and diff) are not thread safe.
+
+  Without PACKET_PROFILE the PACKPROF macros expand to nothing, so
+  there is no cost in the wavelet packet code and the counters are
+  always zero.
+
+  All of the functions are static.  The constructor and destructor
+  are declared but not defined, as in the <tt>support</tt> class.
+ */
+class packprofile
+{
+public:
+  /** the phases of the wavelet packet calculation */
+  typedef enum { Build = 0,
+                 Cost,
+                 BestBasis,
+                 Inverse,
+                 Alloc,
+                 numPhases } phaseKind;
+
+  /** the counters for one phase */
+  typedef struct {
+    /** elapsed (wall clock) time, in seconds */
+    double seconds;
+    /** number of calls */
+    size_t calls;
+    /** nodes created or visited */
+    size_t nodes;
+    /** bytes allocated */
+    size_t bytes;
+    /** coefficients touched */
+    size_t coef;
+  } phase;
+
+  /** the counters for all of the phases */
+  typedef struct {
+    phase phases[ numPhases ];
+  } stats;
+
+  /**
+    Make <i>s</i> the current stats of the thread for the lifetime
+    of the object and then restore the previous current stats.  Use
+    the PACKPROF_SCOPE macro rather than declaring these objects
+    directly.
+   */
+  class scope {
+  private:
+    stats *prev;
+    /** disallow the copy constructor */
+    scope( const scope &rhs ) {}
+  public:
+    scope( stats *s ) { prev = packprofile::setCurrent( s ); }
+    ~scope() { packprofile::setCurrent( prev ); }
+  }; // scope
+
+private:
+  /** the global counters */
+  static stats total;
+
+public:
+  /** declare but do not define the constructor */
+  packprofile();
+  /** declare but do not define the destructor */
+  ~packprofile();
+
+  /** true if the library was compiled with PACKET_PROFILE */
+  static bool enabled()
+  {
+#if defined(PACKET_PROFILE)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  static double now();
+
+  static stats *current();
+  static stats *setCurrent( stats *s );
+  static void release( const stats *s );
+  static void time( const phaseKind kind, const double seconds );
+  static void count( const phaseKind kind,
+                     const size_t nodes,
+                     const size_t bytes,
+                     const size_t coef );
+
+  static void clear( stats &s );
+  static void add( stats &sum, const stats &s );
+  static void snapshot( stats &s );
+  static void diff( const stats &start, stats &result );
+  static void reset();
+  static const char *phaseName( const phaseKind kind );
+  static void pr( const stats &s, FILE *fp = stdout );
+}; // packprofile
+
+
+/*
+  The instrumentation macros.  PACKPROF_START declares a local
+  start time, PACKPROF_STOP adds the time since the start to a phase
+  and PACKPROF_COUNT adds to the counts of a phase.  PACKPROF_SCOPE
+  makes the stats <i>s</i> the current stats of the thread until the
+  end of the enclosing block (<i>var</i> is the name of the local
+  scope object).  PACKPROF_ACTIVATE makes <i>s</i> the current
+  stats and PACKPROF_DEACTIVATE clears the current stats if they
+  are <i>s</i>.
+ */
+#if defined(PACKET_PROFILE)
+#define PACKPROF_START(t)         const double t = packprofile::now()
+#define PACKPROF_STOP(kind, t)    packprofile::time( packprofile::kind, packprofile::now() - (t) )
+#define PACKPROF_COUNT(kind, nodes, bytes, coef) \
+                                  packprofile::count( packprofile::kind, nodes, bytes, coef )
+#define PACKPROF_SCOPE(var, s)    packprofile::scope var( s )
+#define PACKPROF_ACTIVATE(s)      packprofile::setCurrent( s )
+#define PACKPROF_DEACTIVATE(s)    packprofile::release( s )
+#else
+#define PACKPROF_START(t)
+#define PACKPROF_STOP(kind, t)
+#define PACKPROF_COUNT(kind, nodes, bytes, coef)
+#define PACKPROF_SCOPE(var, s)
+#define PACKPROF_ACTIVATE(s)
+#define PACKPROF_DEACTIVATE(s)
+#endif
+
+#endif
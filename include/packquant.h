@@ -0,0 +1,143 @@
+
+#ifndef _PACKQUANT_H_
+#define _PACKQUANT_H_
+
+#include "packbasis.h"
+#include "packcontainer.h"
+#include "liftbase.h"
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+/**
+  Error bounded lossy compression with the wavelet packet transform.
+
+  The packtree and invpacktree classes calculate an exact (to
+  floating point precision) transform.  For historical data a known
+  loss of precision is often acceptable (e.g., prices that are
+  correct to within half a cent).  The packquant constructor is
+  passed the data, a wavelet and a maximum absolute error.  It
+
+  <ol>
+  <li>
+  Builds the wavelet packet tree and calculates the best basis with
+  the costquant cost function, which is the width of the coefficients
+  after they are quantized with a step <i>q</i>.
+  </li>
+  <li>
+  Quantizes the best basis coefficients (each coefficient is replaced
+  by the nearest multiple of <i>q</i>).
+  </li>
+  <li>
+  Calculates the inverse transform of the quantized best basis with
+  invpacktree and measures the largest absolute difference from the
+  original data.
+  </li>
+  </ol>
+
+  The first step is twice the error bound, which is the largest step
+  for which the quantization error of a single value is within the
+  bound.  The inverse transform can increase the error, so if the
+  measured error is larger than the bound the step is halved and the
+  calculation is repeated.  When a step within the bound is found
+  after a step that failed, a few bisection steps between the two
+  look for a larger step.  A result is only accepted after the error
+  bound has been verified.
+
+  The quantized best basis is returned as a packbasis descriptor
+  whose coefficients are multiples of the step, so it can be passed
+  directly to invpacktree.  The whole numbers (the coefficients
+  divided by the step) are returned by getQuantized.  These, the
+  step and the best basis shape are what would be stored.
+
+  The tree, the descriptor and the inverse transform are allocated
+  from the memory pool.  Each attempt with a smaller step builds a
+  new tree, so the memory is not recovered until the pool is freed.
+
+  \author Ian Kaplan
+ */
+class packquant
+{
+private:
+  /** disallow the copy constructor */
+  packquant( const packquant &rhs ) {}
+
+  /** the quantized best basis */
+  packbasis<double> basis;
+  /** quantization step */
+  double quantStep;
+  /** largest absolute error of the reconstructed data */
+  double error;
+  /** total width, in bits, of the quantized best basis coefficients */
+  size_t width;
+  /** true if memory for a tree or a best basis could not be allocated */
+  bool allocError;
+
+  typedef enum { maxTries = 24,
+                 refineTries = 4 } bogus;
+
+  bool quantTry( const double *vec,
+                 const size_t N,
+                 liftbase<packcontainer, double> *w,
+                 const size_t minLength,
+                 const double maxErr,
+                 const double step );
+
+public:
+  packquant( const double *vec,
+             const size_t N,
+             liftbase<packcontainer, double> *w,
+             const double maxErr,
+             const size_t minLength = 1 );
+  /** The destructor does nothing */
+  ~packquant() {}
+
+  /** true if a quantized best basis within the error bound was found */
+  bool ok() const { return basis.ok(); }
+
+  /** the quantized best basis (coefficients are multiples of step()) */
+  packbasis<double> &getBasis() { return basis; }
+
+  /** the quantization step */
+  double step() const { return quantStep; }
+
+  /** the largest absolute error after the inverse transform */
+  double maxError() const { return error; }
+
+  /** the total width, in bits, of the quantized coefficients */
+  size_t numBits() const { return width; }
+
+  bool getQuantized( long long *q ) const;
+}; // packquant
+
+#endif
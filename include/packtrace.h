@@ -0,0 +1,201 @@
+
+#ifndef _PACKTRACE_H_
+#define _PACKTRACE_H_
+
+#include <stddef.h>
+#include <stdio.h>
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+
+   You may use this source code without limitation and without
+   fee as long as you include:
+
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+
+   Please send any bug fixes or suggested source changes to:
+
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+/**
+  Trace spans for the wavelet packet pipeline, exported in the Chrome
+  trace event format.
+
+  When the library is compiled with PACKET_TRACE defined, the
+  wavelet packet code records a span (a name, a start time, a
+  duration and a size) for the tree build, each breadth first level
+  of the build and the depth first sub-trees below them, the cost
+  function, the best basis and the inverse transform.  The lossless
+  codec (intcodec) records spans for encoding and decoding a block
+  and for each level of its packet transform.  Tracing is off until
+  enable is called.
+
+  Each thread writes its spans into its own buffer, so recording a
+  span does not take a lock.  A buffer is created (with malloc) the
+  first time a thread records a span after enable and is registered
+  in a global table with an atomic increment.  When a buffer is
+  full, further spans from that thread are counted as dropped.
+  Spans from more than maxThreads threads are not recorded.
+
+  write writes the spans from all of the threads as a JSON file that
+  can be loaded into a trace viewer (chrome://tracing or Perfetto).
+  Each span is a "complete" event (ph "X") with the time in
+  microseconds since enable, and each buffer is a thread.  write,
+  clear and enable should only be called when no other thread is
+  recording spans (for example, after the worker threads of a batch
+  run have finished).
+
+  Without PACKET_TRACE the PACKTRACE macros expand to nothing.
+
+  All of the functions are static.  The constructor and destructor
+  are declared but not defined, as in the <tt>support</tt> class.
+ */
+class packtrace
+{
+public:
+  /** the maximum number of threads and the default number of spans
+      in each thread's buffer */
+  typedef enum { maxThreads = 256,
+                 defaultEvents = 64 * 1024 } bogus;
+
+  /** a span recorded by a thread */
+  typedef struct {
+    /** the name of the span (a string constant) */
+    const char *name;
+    /** start time, in microseconds since enable */
+    double start;
+    /** duration in microseconds */
+    double dur;
+    /** the size of the data (for example, the number of elements) */
+    size_t n;
+  } event;
+
+  /** the spans recorded by one thread */
+  typedef struct {
+    /** thread number (the position in the table, starting at 1) */
+    size_t tid;
+    /** number of spans in the buffer */
+    size_t count;
+    /** number of spans that did not fit in the buffer */
+    size_t dropped;
+    /** the spans */
+    event *events;
+  } threadBuf;
+
+  /**
+    Record a span for the lifetime of the object: the start time is
+    taken by the constructor and the span is recorded by the
+    destructor.  Nothing is recorded if tracing is not enabled when
+    the object is constructed.  Use the PACKTRACE_SPAN macros rather
+    than declaring these objects directly.
+   */
+  class span {
+  private:
+    const char *name;
+    size_t n;
+    double start;
+    /** disallow the copy constructor */
+    span( const span &rhs ) {}
+  public:
+    span( const char *spanName, const size_t spanN )
+    {
+      name = spanName;
+      n = spanN;
+      start = packtrace::enabled() ? packtrace::now() : -1.0;
+    }
+    ~span()
+    {
+      if (start >= 0.0) {
+        packtrace::add( name, start, packtrace::now(), n );
+      }
+    }
+  }; // span
+
+private:
+  /** true when spans are being recorded */
+  static volatile bool on;
+  /** the number of spans in a buffer */
+  static size_t capacity;
+  /** the start time (seconds) set by enable */
+  static double origin;
+  /** incremented by clear, so that the threads do not use the
+      buffers that it has freed */
+  static volatile size_t generation;
+  /** the number of buffers in the table */
+  static volatile long numBufs;
+  /** the buffers (threads) */
+  static threadBuf *bufs[ maxThreads ];
+
+  static threadBuf *localBuf();
+
+public:
+  /** declare but do not define the constructor */
+  packtrace();
+  /** declare but do not define the destructor */
+  ~packtrace();
+
+  /** true if the library was compiled with PACKET_TRACE */
+  static bool compiled()
+  {
+#if defined(PACKET_TRACE)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /** true if spans are being recorded */
+  static bool enabled() { return on; }
+
+  static void enable( const size_t eventsPerThread = defaultEvents );
+  static void disable();
+  static void clear();
+
+  static double now();
+  static void add( const char *name,
+                   const double start,
+                   const double end,
+                   const size_t n );
+
+  static size_t numEvents();
+  static size_t numDropped();
+  static bool write( FILE *fp );
+  static bool write( const char *path );
+}; // packtrace
+
+
+/*
+  The tracing macros.  PACKTRACE_SPAN records a span named
+  <i>name</i>, of size <i>n</i>, from the macro to the end of the
+  enclosing block.  <i>var</i> is the name of the local span object,
+  so that more than one span can be declared in a block.
+ */
+#if defined(PACKET_TRACE)
+#define PACKTRACE_SPAN(var, name, n)   packtrace::span var( name, n )
+#else
+#define PACKTRACE_SPAN(var, name, n)
+#endif
+
+#endif
@@ -5,6 +5,7 @@
 
 #include "packtree_base.h"
 #include "packdata_list.h"
+#include "packbasis.h"
 #include "packcontainer.h"
 #include "liftbase.h"
 
@@ -52,11 +53,16 @@
   double vaues, the result of the constructor will be a wavelet packet
   tree with log<sub>2</sub>(N) levels.
 
+  The class is a template for the type of the data elements.  The
+  <tt>packtree</tt> typedef is the tree for double values and
+  <tt>packtree_int</tt> is the tree for int values (used for lossless
+  compression).  The cost values (see costbase) are always doubles.
+
  */
 
-class packtree : public packtree_base {
+template <class T>
+class basic_packtree : public basic_packtree_base<T> {
 private:
-
   /** Found original data marked as part of the best basis.
       This means that the best basis function failed (or
       that the original data is the most compact representation
@@ -67,27 +73,38 @@ private:
   
 private:
   /** disallow the copy constructor */
-  packtree( const packtree &rhs ) {};
+  basic_packtree( const basic_packtree &rhs ) {};
   /** disallow the default constructor */
-  packtree() {};
+  basic_packtree() {};
+
+  double bestBasisWalk( packnode<T> *root );
+
+  void buildBestBasisList( packnode<T> *root, 
+			   packdata_list<T> &list );
 
-  double bestBasisWalk( packnode<double> *root );
+  void countBestBasis( packnode<T> *root, 
+                       size_t &numNodes, 
+                       size_t &numBits );
 
-  void buildBestBasisList( packnode<double> *root, 
-			   packdata_list<double> &list );
+  void buildBestBasis( packnode<T> *root, 
+                       packbasis<T> &basis,
+                       size_t &bit,
+                       size_t &offset );
 
-  void checkBestBasis( packnode<double> *root );
+  void checkBestBasis( packnode<T> *root );
 
-  void cleanTree(packnode<double> *root, bool removeMark );
+  void cleanTree(packnode<T> *root, bool removeMark );
 
 public:
 
-  packtree( const double *vec, 
-            const size_t n, 
-            liftbase<packcontainer, double> *w );
+  basic_packtree( const T *vec, 
+                  const size_t n, 
+                  liftbase<basic_packcontainer<T>, T> *w,
+                  packtree_base::inputKind kind = packtree_base::CopyInput,
+                  const size_t minLength = 1 );
 
   /** destructor does nothing */
-  ~packtree() {}
+  ~basic_packtree() {}
 
   void prCost();
   void prBestBasis();
@@ -96,8 +113,17 @@ public:
 
   bool bestBasisOK();
 
-  packdata_list<double> getBestBasisList();
+  packdata_list<T> getBestBasisList();
+
+  packbasis<T> getBestBasis();
+
+}; // basic_packtree
+
+
+/** wavelet packet tree for double values */
+typedef basic_packtree<double> packtree;
 
-}; // packtree
+/** wavelet packet tree for int values */
+typedef basic_packtree<int> packtree_int;
 
 #endif
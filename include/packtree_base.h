@@ -37,7 +37,10 @@
  */
 
 #include "packnode.h"
+#include "packcontainer.h"
 #include "liftbase.h"
+#include "packprofile.h"
+#include "packtrace.h"
 
 
 /**
@@ -46,30 +49,156 @@
   best basis calculation and wavelet packet trees for
   frequency analysis.
 
+  This class holds the parts of the wavelet packet tree that do not
+  depend on the type of the data elements: the input and print
+  options, the minimum node length and the cache size that is used to
+  schedule the construction of the tree.  The tree itself is built by
+  the basic_packtree_base template.
+
   \author Ian Kaplan
 
  */
 class packtree_base {
+public:
+  /** 
+    How the data passed to a wavelet packet tree constructor
+    is used: CopyInput copies the data into the memory pool,
+    BorrowInput uses the caller's buffer as the data for the
+    root of the tree.
+   */
+  typedef enum { BadInputKind,
+                 CopyInput,
+                 BorrowInput } inputKind;
+
 protected:
-  /** root of the wavelet packet tree */
-  packnode<double> *root;
+  /** nodes are not split into children shorter than minLen */
+  size_t minLen;
 
-  /** wavelet packet transform object */
-  liftbase<packcontainer, double> *waveObj;
+  /** set the minimum node length (lengths less than one are treated as one) */
+  void minLength( const size_t len ) { minLen = (len > 1) ? len : 1; }
 
   typedef enum { BadPrintKind, 
                  printData, 
                  printCost, 
                  printBestBasis } printKind;
 
+  bool subtreeFits( const size_t len, const size_t elemSize );
+
+private:
+  /** cache size used when no size has been set */
+  typedef enum { defaultCacheBytes = 256 * 1024 } bogus;
+
+  /** cache size used to schedule the tree construction */
+  static size_t cacheBytes;
+
+protected:
+  /** the phase timers and counters of the tree (see packprofile) */
+  packprofile::stats profStats;
+
+public:
+  /**
+    Clear the profile counters and make them the current stats of
+    the thread, so the work done on the tree (including the cost
+    function, see packprofile) is added to them.
+   */
+  packtree_base()
+  {
+    packprofile::clear( profStats );
+    PACKPROF_ACTIVATE( &profStats );
+  }
+
+  /** the tree is no longer the current tree of the thread */
+  ~packtree_base() { PACKPROF_DEACTIVATE( &profStats ); }
+
+  /**
+    Get the phase timers and counters for the work done on this
+    tree: building it, the cost function and the best basis (see
+    packprofile).  The counters are only updated when the library
+    is compiled with PACKET_PROFILE.
+   */
+  void getStats( packprofile::stats &s ) const { s = profStats; }
+
+  static void cacheSize( const size_t bytes );
+  static size_t cacheSize();
+
+  /** get the length of the shortest nodes in the tree */
+  size_t minLength() const { return minLen; }
+}; // packtree_base
+
+
+
+/**
+  A wavelet packet tree for data elements of type <i>T</i>.
+
+  The same tree construction, best basis and inverse transform code
+  is used for all element types.  The library is built with versions
+  of the wavelet packet classes for int16_t, int32_t (int), int64_t,
+  float and double elements (see the end of packtree_base.cpp).  For
+  example, int16_t trees can be used for small integer values, like
+  tick deltas (twice as many values fit in a vector register as with
+  int), int64_t trees for values, like trading volume, that overflow
+  an int and float trees for frequency analysis in half the memory
+  of a double tree.
+
+  The wavelet transform step is calculated by a liftbase object whose
+  element type is <i>T</i> (e.g., line<packcontainer> for double,
+  line_int<packcontainer_int> for int or 
+  line_int<basic_packcontainer<int16_t>, int16_t> for int16_t).  The
+  raw array kernels (forwardSpan) of these classes are compiled for the
+  element type, so each type gets its own vectorized loops.
+
+  \author Ian Kaplan
+
+ */
+template <class T>
+class basic_packtree_base : public packtree_base {
+protected:
+  /** root of the wavelet packet tree */
+  packnode<T> *root;
+
+  /** wavelet packet transform object */
+  liftbase<basic_packcontainer<T>, T> *waveObj;
+
+  /** true if memory for the tree could not be allocated */
+  bool allocError;
+
   void breadthFirstPrint(printKind kind);
 
-  void newLevel( packnode<double>* top, bool freqCalc, bool reverse );
+  bool splitNode( packnode<T>* top, bool reverse );
+
+  void newLevel( packnode<T>* top, bool freqCalc, bool reverse );
+
+  void buildTree( packnode<T>* top, bool freqCalc );
+
+  T *rootData( const T *vec, const size_t N, inputKind kind );
+
+private:
+  void levelWalk( packnode<T>* top, 
+                  size_t depth,
+                  bool freqCalc, 
+                  bool reverse,
+                  bool descend );
 
 public:
+  /** an empty tree (the subclass constructors build the tree) */
+  basic_packtree_base()
+  {
+    root = 0;
+    waveObj = 0;
+    allocError = false;
+  }
+
+  /**
+    Return true if the tree was built.  If the memory for the root
+    or for any node of the tree could not be allocated (the tree
+    would be shallower than requested and give a different best
+    basis) or for the best basis list, false is returned.
+   */
+  bool ok() const { return (root != 0 && !allocError); }
+
   void pr(); 
   /** get the root of the wavelet packet tree */
-  packnode<double> *getRoot() { return root; }
-}; // packtree_base
+  packnode<T> *getRoot() { return root; }
+}; // basic_packtree_base
 
 #endif
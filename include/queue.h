@@ -70,8 +70,9 @@ public:
     indent = i;
   }
 
-  /** allocate queueElem objects from a memory pool */
-  void *operator new(size_t num_bytes)
+  /** allocate queueElem objects from a memory pool (new returns
+      zero if the memory cannot be allocated) */
+  void *operator new(size_t num_bytes) throw()
   {
     block_pool mem_pool;
 
@@ -118,11 +119,12 @@ public:
     }
   } // deleteStart
 
-  /** Add an element to the queue */
-  void addQueue(packnode<T> *node, size_t indent )
+  /** Add an element to the queue.  Return false if the memory for
+      the element could not be allocated. */
+  bool addQueue(packnode<T> *node, size_t indent )
   {
     queueElem<T> *elem = new queueElem<T>(node, indent);
-    add( elem );
+    return (elem != 0 && add( elem ));
   } // addQueue
 
   /** return true if the queue is empty */
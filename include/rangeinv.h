@@ -0,0 +1,346 @@
+
+#ifndef _RANGEINV_H_
+#define _RANGEINV_H_
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "liftbase.h"
+#include "packbasis.h"
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+/**
+  Reconstruct a range of samples [a, b) from wavelet coefficients,
+  without calculating the whole inverse transform.
+
+  Each step of the lifting scheme inverse transform calculates the
+  elements 2i and 2i+1 of a level from a few low pass (<i>lhs</i>)
+  and high pass (<i>rhs</i>) elements near position i of the level
+  below.  So the samples [a, b) of a level of size n only depend on
+  a window of about (b-a)/2 low pass and high pass elements at the
+  level of size n/2.  The low pass window is itself a range of the
+  level below, and so on down to the average.  This class walks
+  down the levels calculating these windows and then calculates the
+  inverse steps on the windows only, on the way back up, using the
+  raw array kernels of the wavelet (liftbase::inverseSpan).
+
+  Each window is widened by <tt>margin</tt> elements on each side.
+  The kernels treat the ends of the window as the ends of the data,
+  so the elements next to the ends of a window are wrong unless the
+  window ends at the end of the level.  None of the wavelets read
+  more than one neighbor on each side, so the wrong elements are
+  always in the margin and are thrown away.  For the Daubechies D4
+  wavelet, which wraps around the end of the data (see
+  liftbase::spanPeriodic), the window is gathered modulo the length
+  of the level.
+
+  <ul>
+  <li>
+  <b>Ordered coefficients</b> (the result of forwardTrans): the
+  windows at each level have (b-a)/2<sup>j</sup> + 2 margin + 1
+  elements, so O((b-a) + margin log N) coefficients are read.
+  </li>
+  <li>
+  <b>Wavelet packet best basis</b> (a packbasis descriptor): both
+  children of a split node are windowed with the same window, so
+  every best basis node is read.  A node at depth j contributes
+  about (b-a)/2<sup>j</sup> + 2 margin + 1 coefficients.  Deep
+  nodes are narrow frequency bands that cover the whole data set
+  in time, so no range inverse can avoid them.
+  </li>
+  </ul>
+
+  The number of coefficients read by the last call is returned by
+  coefTouched.  The result is the same as the full inverse
+  transform (inverseTrans or invpacktree), up to floating point
+  rounding.  For the integer wavelets (line_int) the result is
+  exact.
+
+  The wavelet must provide raw array kernels (inverseSpan); the
+  wavelets in this library do.  Errors (a bad range, an N that is
+  not a power of two, a wavelet without inverseSpan) are reported
+  with printf and a false return value.  The temporary windows are
+  allocated with new, not from the memory pool, so separate
+  rangeinv objects can be used in several threads at once.
+
+  The template arguments are the same as those of the wavelet
+  object: for example, <tt>rangeinv&lt;double *&gt;</tt> for a
+  <tt>line&lt;double *&gt;</tt> wavelet and
+  <tt>rangeinv&lt;packcontainer&gt;</tt> for the wavelet passed to
+  packtree.
+
+  \author Ian Kaplan
+ */
+template <class T, class T_elem = double>
+class rangeinv
+{
+private:
+  /** extra elements on each side of a window */
+  typedef enum { margin = 2 } bogus;
+
+  /** disallow the copy constructor */
+  rangeinv( const rangeinv &rhs ) {}
+
+  /** the wavelet used to calculate the inverse steps */
+  liftbase<T, T_elem> *waveObj;
+  /** true if the wavelet kernels wrap around */
+  bool periodic;
+  /** number of coefficients read by the last call */
+  size_t touched;
+
+  /** k modulo n, for a k that may be negative */
+  static int wrap( const int k, const int n )
+  {
+    const int r = k % n;
+    return (r < 0) ? r + n : r;
+  }
+
+  /** floor( k/2 ), for a k that may be negative */
+  static int floorHalf( const int k )
+  {
+    return (k >= 0) ? (k >> 1) : -((1 - k) >> 1);
+  }
+
+  /**
+    Calculate the window [lo, hi) of the level of size n/2 that
+    is needed to calculate the elements [a, b) of the level of size
+    n.  If the window would cover the whole level it is [0, n/2).
+   */
+  void window( const int a, const int b, const int n, int &lo, int &hi ) const
+  {
+    const int half = n >> 1;
+
+    lo = floorHalf( a ) - margin;
+    hi = floorHalf( b - 1 ) + 1 + margin;
+    if (periodic) {
+      if (hi - lo >= half) {
+        lo = 0;
+        hi = half;
+      }
+    }
+    else {
+      if (lo < 0) {
+        lo = 0;
+      }
+      if (hi > half) {
+        hi = half;
+      }
+    }
+  } // window
+
+  /**
+    Calculate an inverse step on the windows [lo, hi) in <i>lhs</i>
+    and <i>rhs</i> and copy the elements [a, b) of the result (a
+    level of size n) into <i>dst</i>.  The <i>lhs</i> and
+    <i>rhs</i> windows are destroyed.
+   */
+  bool step( T_elem *lhs, 
+             T_elem *rhs, 
+             const int lo, 
+             const int hi, 
+             const int n, 
+             const int a, 
+             const int b, 
+             T_elem *dst )
+  {
+    const int w = hi - lo;
+    const bool whole = (w == (n >> 1));
+    T_elem *tmp = new T_elem[ 2 * w ];
+
+    const bool ok = waveObj->inverseSpan( lhs, rhs, tmp, 2 * w );
+    if (ok) {
+      for (int k = a; k < b; k++) {
+        dst[k - a] = tmp[ whole ? wrap( k, n ) : k - (2 * lo) ];
+      }
+    }
+    else {
+      printf("rangeinv: the wavelet does not have a raw array inverse step\n");
+    }
+    delete [] tmp;
+    return ok;
+  } // step
+
+  /**
+    Calculate the elements [a, b) of the level of size n of an
+    ordered inverse transform.  The high pass coefficients of the
+    level are coef[n/2 .. n) and coef[0] is the average.
+   */
+  bool ordered( const T_elem *coef, 
+                const int n, 
+                const int a, 
+                const int b, 
+                T_elem *dst )
+  {
+    if (n == 1) {
+      for (int k = a; k < b; k++) {
+        dst[k - a] = coef[0];
+      }
+      touched++;
+      return true;
+    }
+
+    const int half = n >> 1;
+    int lo, hi;
+    window( a, b, n, lo, hi );
+    const int w = hi - lo;
+    T_elem *lhs = new T_elem[ 2 * w ];
+    T_elem *rhs = lhs + w;
+
+    bool ok = ordered( coef, half, lo, hi, lhs );
+    if (ok) {
+      for (int j = lo; j < hi; j++) {
+        rhs[j - lo] = coef[ half + wrap( j, half ) ];
+      }
+      touched = touched + w;
+      ok = step( lhs, rhs, lo, hi, n, a, b, dst );
+    }
+    delete [] lhs;
+    return ok;
+  } // ordered
+
+  /**
+    Calculate the elements [a, b) of the packet tree node of size n
+    described by shape bit <i>bit</i>, whose best basis coefficients
+    start at <i>offset</i>.  The shape bitmap is walked in the same
+    order as it is written (pre-order), so <i>bit</i> and
+    <i>offset</i> are advanced past the node's subtree.
+   */
+  bool packet( packbasis<T_elem> &basis, 
+               size_t &bit, 
+               size_t &offset, 
+               const int n, 
+               const int a, 
+               const int b, 
+               T_elem *dst )
+  {
+    if (! basis.shapeBit( bit++ )) {
+      const T_elem *vec = basis.coef() + offset;
+      for (int k = a; k < b; k++) {
+        dst[k - a] = vec[ wrap( k, n ) ];
+      }
+      touched = touched + (b - a);
+      offset = offset + n;
+      return true;
+    }
+
+    int lo, hi;
+    window( a, b, n, lo, hi );
+    const int w = hi - lo;
+    T_elem *lhs = new T_elem[ 2 * w ];
+    T_elem *rhs = lhs + w;
+
+    bool ok = packet( basis, bit, offset, n >> 1, lo, hi, lhs ) &&
+              packet( basis, bit, offset, n >> 1, lo, hi, rhs ) &&
+              step( lhs, rhs, lo, hi, n, a, b, dst );
+    delete [] lhs;
+    return ok;
+  } // packet
+
+  /** check the arguments of a ranged inverse */
+  static bool badRange( const size_t N, const size_t a, const size_t b )
+  {
+    if (N == 0 || (N & (N - 1)) != 0) {
+      printf("rangeinv: N = %u is not a power of two\n", (unsigned)N );
+      return true;
+    }
+    if (a >= b || b > N) {
+      printf("rangeinv: bad range [%u, %u)\n", (unsigned)a, (unsigned)b );
+      return true;
+    }
+    return false;
+  } // badRange
+
+public:
+  /**
+    <i>w</i> is the wavelet that calculated the forward transform.
+   */
+  rangeinv( liftbase<T, T_elem> *w )
+  {
+    waveObj = w;
+    periodic = w->spanPeriodic();
+    touched = 0;
+  }
+
+  /** The destructor does nothing */
+  ~rangeinv() {}
+
+  /**
+    Calculate the samples [a, b) of the inverse of an ordered
+    wavelet transform.  <i>coef</i> holds the N coefficients
+    calculated by forwardTrans and is not changed.  The b-a samples
+    are written to <i>out</i>.
+   */
+  bool inverse( const T_elem *coef, 
+                const size_t N, 
+                const size_t a, 
+                const size_t b, 
+                T_elem *out )
+  {
+    touched = 0;
+    if (badRange( N, a, b )) {
+      return false;
+    }
+    return ordered( coef, (int)N, (int)a, (int)b, out );
+  } // inverse
+
+  /**
+    Calculate the samples [a, b) of the inverse wavelet packet
+    transform of a best basis (see packtree::getBestBasis).  The
+    descriptor is not changed.  The b-a samples are written to
+    <i>out</i>.
+   */
+  bool inverse( packbasis<T_elem> &basis, 
+                const size_t a, 
+                const size_t b, 
+                T_elem *out )
+  {
+    touched = 0;
+    if (! basis.ok()) {
+      printf("rangeinv: the best basis descriptor is empty\n");
+      return false;
+    }
+    if (badRange( basis.length(), a, b )) {
+      return false;
+    }
+    size_t bit = 0;
+    size_t offset = 0;
+    return packet( basis, bit, offset, (int)basis.length(), (int)a, (int)b, out );
+  } // inverse
+
+  /** number of coefficients read by the last call to inverse */
+  size_t coefTouched() const { return touched; }
+}; // rangeinv
+
+#endif
@@ -46,13 +46,26 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
 
 #include "blockpool.h"
+#include "packprofile.h"
 
 
 size_t block_pool::alloc_gran = (size_t)block_pool::page_size;
 block_pool::block_chain *block_pool::current_block = 0;
 block_pool::block_chain *block_pool::block_list_start = 0;
+block_pool::pool_stats block_pool::stats;
+size_t block_pool::map_threshold = (size_t)block_pool::max_block_multiple * block_pool::page_size;
+block_pool::large_page_kind block_pool::large_pages = block_pool::no_large_pages;
+bool block_pool::zero_fill = false;
 
 
 
@@ -60,7 +73,8 @@ block_pool::block_chain *block_pool::block_list_start = 0;
    block_pool::init_pool
   
    This function is automatically called to initialize the block_pool
-   object when the "current_block" pointer is null.
+   object when the "current_block" pointer is null.  If the first
+   block cannot be allocated the pool remains empty.
 
 */  
 void block_pool::init_pool( void )
@@ -75,6 +89,89 @@ void block_pool::init_pool( void )
 
 
 
+/**
+   set_map_threshold
+
+   Set the size, in bytes, above which blocks are mapped directly
+   from the operating system (mmap or VirtualAlloc) instead of being
+   allocated with MemAlloc.  The default is page_size *
+   max_block_multiple (1 Mb).  A mapped block holds a single
+   allocation and its pages are only touched when they are written,
+   so very large arrays (for example, the root of a packet tree for
+   a multi-million element series) do not have to be copied or
+   cleared by the system allocator.
+
+*/
+void block_pool::set_map_threshold( size_t n_bytes )
+{
+  map_threshold = n_bytes;
+} // set_map_threshold
+
+
+
+/**
+   MapAlloc
+
+   Map <i>n_bytes</i> of memory from the operating system.  On Linux
+   the block is backed by huge pages if large pages have been
+   requested (see set_large_pages).  The memory is set to zero by
+   the operating system.  Zero is returned if the memory cannot be
+   mapped.
+
+*/
+void *block_pool::MapAlloc( size_t n_bytes )
+{
+  void *addr = 0;
+
+#if defined(_WIN32)
+  addr = VirtualAlloc( 0, n_bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE );
+#else
+#if defined(MAP_HUGETLB)
+  if (large_pages == explicit_large_pages) {
+    addr = mmap( 0, n_bytes, PROT_READ | PROT_WRITE, 
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+    if (addr == MAP_FAILED) {
+      // there are no reserved huge pages, so use transparent huge pages
+      addr = 0;
+    }
+  }
+#endif
+  if (addr == 0) {
+    addr = mmap( 0, n_bytes, PROT_READ | PROT_WRITE, 
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if (addr == MAP_FAILED) {
+      addr = 0;
+    }
+#if defined(MADV_HUGEPAGE)
+    else if (large_pages != no_large_pages) {
+      madvise( addr, n_bytes, MADV_HUGEPAGE );
+    }
+#endif
+  }
+#endif
+
+  return addr;
+} // MapAlloc
+
+
+
+/**
+   MapFree
+
+   Unmap a block that was allocated by MapAlloc.
+
+*/
+void block_pool::MapFree( void *addr, size_t n_bytes )
+{
+#if defined(_WIN32)
+  VirtualFree( addr, 0, MEM_RELEASE );
+#else
+  munmap( addr, n_bytes );
+#endif
+} // MapFree
+
+
+
 
 /**
    new_block
@@ -90,15 +187,28 @@ void block_pool::init_pool( void )
    of the code does not actually check the system page size, but assumes
    a 4Kb page.
 
+   Blocks larger than the map threshold (see set_map_threshold) are
+   mapped from the operating system (see MapAlloc).  When large
+   pages are used, a mapped block is rounded up to a multiple of the
+   large page size.
+
+   If the memory cannot be allocated an error is printed and zero
+   is returned.
+
 */  
 block_pool::block_chain *block_pool::new_block( size_t block_size )
 {
-  const size_t max_block_size = max_block_multiple * page_size;
   block_chain *new_link = 0;
   size_t alloc_amt, total_alloc;
+  bool mapped = false;
 
   // add in the memory needed for the block_chain structure
   total_alloc = block_size + sizeof(block_chain);
+  if (total_alloc < block_size || total_alloc > ((size_t)-1) - ((size_t)page_size-1)) {
+    // the size (or the size rounded up to a page) does not fit in a size_t
+    printf("block_pool::new_block: allocation request too large\n");
+    return 0;
+  }
   if (total_alloc < alloc_gran)
       alloc_amt = alloc_gran;
   else { 
@@ -107,12 +217,25 @@ block_pool::block_chain *block_pool::new_block( size_t block_size )
       alloc_amt = ((total_alloc + (page_size-1))/page_size) * page_size;
   }
 
-  if (alloc_amt <= max_block_size) {
-
+  if (alloc_amt > map_threshold) {
+    if (large_pages != no_large_pages) {
+      const size_t large = large_page_size;
+      if (alloc_amt > ((size_t)-1) - (large-1)) {
+        printf("block_pool::new_block: allocation request too large\n");
+        return 0;
+      }
+      alloc_amt = ((alloc_amt + (large-1))/large) * large;
+    }
+    mapped = true;
+    new_link = (block_chain *)MapAlloc( alloc_amt );
+  }
+  else {
     /* Allocate memory for both the block_chain structure and the memory 
        block */
     new_link = (block_chain *)MemAlloc( alloc_amt );
+  }
 
+  if (new_link != 0) {
     // The new memory block starts after the block_chain structure
     Chain_block(new_link) = (void *)(((size_t)new_link) + sizeof(block_chain));
 
@@ -121,9 +244,20 @@ block_pool::block_chain *block_pool::new_block( size_t block_size )
     Chain_bytes_used(new_link) = 0;
     Chain_block_size(new_link) = alloc_amt - sizeof(block_chain);
     Chain_next(new_link) = 0;
+    Chain_mapped(new_link) = mapped;
+
+    stats.reserved += alloc_amt;
+    stats.blocks++;
+    if (mapped) {
+      stats.mapped_blocks++;
+    }
+    if (stats.reserved > stats.high_water) {
+      stats.high_water = stats.reserved;
+    }
   }
   else {
-    printf("block_pool::new_block: allocation request too large\n");
+    printf("block_pool::new_block: could not allocate %lu bytes\n",
+           (unsigned long)alloc_amt );
   }
 
   return new_link;
@@ -135,20 +269,31 @@ block_pool::block_chain *block_pool::new_block( size_t block_size )
 
   block_pool::add_block Add a new memory block to the memory pool.
   This function is called when the amount of memory requested by
-  pool_alloc will not fit in the current block.
+  pool_alloc will not fit in the current block.  The new block is
+  returned (zero if it could not be allocated).
+
+  A new block normally becomes the current block.  A mapped block
+  only holds the allocation it was created for, so it is added to
+  the start of the block chain and the current block is still used
+  for the smaller allocations that follow.
 
 */
-void *block_pool::add_block( size_t block_size )
+block_pool::block_chain *block_pool::add_block( size_t block_size )
 {
-  block_chain *block = 0;
-  block_chain *last_block;
+  block_chain *block = new_block( block_size );
 
-  last_block = current_block;
-  block = new_block( block_size );
-  Chain_next(current_block) = block;
-  current_block = block;
+  if (block != 0) {
+    if (Chain_mapped(block)) {
+      Chain_next(block) = block_list_start;
+      block_list_start = block;
+    }
+    else {
+      Chain_next(current_block) = block;
+      current_block = block;
+    }
+  }
 
-  return (void *)block;
+  return block;
 } // block_chain::add_block
 
 
@@ -167,37 +312,74 @@ void *block_pool::add_block( size_t block_size )
    have enough memory, add_block is called to allocate a new memory
    block which will be large enough.
 
+   The memory is aligned to <i>align</i> bytes, which must be a
+   power of two (the default is sizeof(size_t)).  Coefficient arrays
+   that are processed by vector kernels are allocated with
+   simd_align.  Allocations smaller than the alignment are aligned to
+   their size, rounded up to a power of two.  The bytes skipped to
+   align an allocation are counted as waste in the pool statistics.
+
+   If the memory cannot be allocated an error is printed, the failure
+   is counted in the pool statistics and zero is returned.
+
 */
-void *block_pool::pool_alloc( size_t num_bytes )
+void *block_pool::pool_alloc( size_t num_bytes, size_t align /*= sizeof( size_t ) */ )
 {
-  const size_t align = sizeof( size_t );
+  const size_t min_align = sizeof( size_t );
+  const size_t requested = num_bytes;
   void *addr = 0;
-  size_t amt_free;
+  block_chain *block;
+  size_t pad = 0;
+  PACKPROF_START( start );
 
-  /* the number of bytes allocated must be a multiple of the align
-     size */
-  num_bytes = ((num_bytes + (align-1))/align) * align;
+  assert( (align & (align-1)) == 0 );
+  if (align < min_align) {
+    align = min_align;
+  }
+
+  /* the number of bytes allocated must be a multiple of the minimum
+     align size */
+  num_bytes = ((num_bytes + (min_align-1))/min_align) * min_align;
+
+  // An allocation is not aligned to more than its size (rounded up
+  // to a power of two), so the small arrays at the bottom of a
+  // wavelet packet tree are not padded out to a full cache line.
+  while (align > min_align && (align >> 1) >= num_bytes) {
+    align = align >> 1;
+  }
 
   if (current_block == 0) {
     init_pool();
   }
+  block = current_block;
 
-  amt_free = Chain_block_size(current_block) - Chain_bytes_used(current_block);
-  
-  if (num_bytes > amt_free) {
-    if (add_block( num_bytes ) != 0) {
-      amt_free = Chain_block_size(current_block);
+  if (num_bytes < requested || num_bytes > ((size_t)-1) - align) {
+    // the request is so large that rounding it up overflowed
+    block = 0;
+  }
+  else if (block != 0) {
+    pad = align_pad( block, align );
+    if (pad + num_bytes > Chain_block_size(block) - Chain_bytes_used(block)) {
+      // a new block is large enough for the allocation at any alignment
+      block = add_block( num_bytes + (align - min_align) );
+      pad = (block != 0) ? align_pad( block, align ) : 0;
     }
   }
 
-  if (amt_free >= num_bytes) {
-    addr = (void *)((size_t)Chain_block(current_block) + Chain_bytes_used(current_block));
-    Chain_bytes_used(current_block) += num_bytes;
+  if (block != 0) {
+    Chain_bytes_used(block) += pad;
+    addr = (void *)((size_t)Chain_block(block) + Chain_bytes_used(block));
+    Chain_bytes_used(block) += num_bytes;
+    stats.requested += requested;
+    stats.alloc_calls++;
   }
   else {
-    printf("block_pool::block_alloc: allocation error\n");
-    exit(1);
+    printf("block_pool::pool_alloc: could not allocate %lu bytes\n",
+           (unsigned long)requested );
+    stats.alloc_failures++;
   }
+  PACKPROF_COUNT( Alloc, 0, num_bytes, 0 );
+  PACKPROF_STOP( Alloc, start );
   return addr;
 } // block_pool::pool_alloc
 
@@ -223,8 +405,21 @@ void block_pool::free_pool(void)
   while (block_list_start != 0) {
     tmp = block_list_start;
     block_list_start = Chain_next(block_list_start);
-    MemFree( (void *)tmp );
+    if (Chain_mapped(tmp)) {
+      MapFree( (void *)tmp, Chain_block_size(tmp) + sizeof(block_chain) );
+    }
+    else {
+      MemFree( (void *)tmp );
+    }
   }
+  // the next pool_alloc starts a new pool
+  current_block = 0;
+
+  stats.requested = 0;
+  stats.reserved = 0;
+  stats.blocks = 0;
+  stats.mapped_blocks = 0;
+  stats.free_calls++;
 } // free_pool
 
 
@@ -232,22 +427,23 @@ void block_pool::free_pool(void)
 /**
    print_block_pool_info
   
-   Print information about the block pool
+   Print information about the block pool: the size of each block
+   and the number of bytes used in it, followed by the pool
+   statistics (see get_pool_stats).
 
 */
 void block_pool::print_block_pool_info( FILE *fp /*= stdout */)
 {
-  size_t total_allocated = 0;
-  size_t total_unused = 0;
+  pool_stats s;
   block_chain *ptr = block_list_start;
 
-  fprintf(fp, "Minimum memory allocation size: %d\n", alloc_gran );
-  fprintf(fp, "Page size: %d\n", (size_t)page_size );
+  fprintf(fp, "Minimum memory allocation size: %lu\n", (unsigned long)alloc_gran );
+  fprintf(fp, "Page size: %lu\n", (unsigned long)page_size );
   fprintf(fp, "[block size, bytes_used]\n");
   while (ptr != 0) {
-    fprintf(fp, "[%4d, %4d]", Chain_block_size(ptr), Chain_bytes_used(ptr));
-    total_allocated += Chain_bytes_used(ptr);
-    total_unused += (Chain_block_size(ptr) - Chain_bytes_used(ptr));
+    fprintf(fp, "[%4lu, %4lu]", 
+            (unsigned long)Chain_block_size(ptr), 
+            (unsigned long)Chain_bytes_used(ptr));
     if (Chain_next(ptr) != 0) {
       fprintf(fp, ", ");
     }
@@ -256,7 +452,119 @@ void block_pool::print_block_pool_info( FILE *fp /*= stdout */)
     }
     ptr = Chain_next(ptr);
   } // while
-  fprintf(fp, "Total allocated = %5d, total unused = %3d\n", total_allocated,
-	 total_unused );
-}
 
+  get_pool_stats( s );
+  fprintf(fp, "Blocks = %lu (%lu mapped), bytes reserved = %lu, requested = %lu, waste = %lu\n",
+          (unsigned long)s.blocks, (unsigned long)s.mapped_blocks,
+          (unsigned long)s.reserved, 
+          (unsigned long)s.requested, (unsigned long)s.waste );
+  fprintf(fp, "High water = %lu, pool_alloc calls = %lu, free_pool calls = %lu\n",
+          (unsigned long)s.high_water, (unsigned long)s.alloc_calls, 
+          (unsigned long)s.free_calls );
+  fprintf(fp, "Failed allocations = %lu\n", (unsigned long)s.alloc_failures );
+  fprintf(fp, "Global heap allocations = %lu (%lu bytes)\n",
+          (unsigned long)s.heap_fallbacks, (unsigned long)s.heap_bytes );
+} // print_block_pool_info
+
+
+
+/**
+   Add <i>n</i> to the counter <i>count</i> with an atomic add, so
+   that the counter can be updated by more than one thread.
+ */
+static void atomic_add( size_t *count, size_t n )
+{
+#if defined(_WIN64)
+  InterlockedExchangeAdd64( (volatile LONG64 *)count, (LONG64)n );
+#elif defined(_WIN32)
+  InterlockedExchangeAdd( (volatile LONG *)count, (LONG)n );
+#else
+  __sync_fetch_and_add( count, n );
+#endif
+} // atomic_add
+
+
+
+/**
+   note_heap_alloc
+
+   Record an allocation of <i>num_bytes</i> from the global heap.
+   This is called by the global new operators in local_new.cpp, so
+   allocations that do not use the pool can be counted.  The global
+   new operators are called from any thread (for example, the
+   taskpool workers that load equity files), so the heap counts are
+   updated with atomic adds.
+
+*/
+void block_pool::note_heap_alloc( size_t num_bytes )
+{
+  atomic_add( &stats.heap_fallbacks, 1 );
+  atomic_add( &stats.heap_bytes, num_bytes );
+} // note_heap_alloc
+
+
+
+/**
+   get_pool_stats
+
+   Copy the memory pool statistics into <i>s</i>.  The statistics
+   are kept as the pool is used, so this function can be called at
+   any time (for example, by a monitoring thread).  The heap counts
+   are updated atomically.  The other values are only updated by the
+   thread that uses the pool, and are not updated atomically.
+
+*/
+void block_pool::get_pool_stats( pool_stats &s )
+{
+  s = stats;
+  s.waste = stats.reserved - stats.requested;
+} // get_pool_stats
+
+
+
+/**
+   reset_pool_stats
+
+   Set the accumulated statistics (the high water mark and the call
+   and heap counts) to zero.  The high water mark is set to the
+   current size of the pool.
+
+*/
+void block_pool::reset_pool_stats(void)
+{
+  stats.high_water = stats.reserved;
+  stats.alloc_calls = 0;
+  stats.free_calls = 0;
+  stats.alloc_failures = 0;
+  stats.heap_fallbacks = 0;
+  stats.heap_bytes = 0;
+} // reset_pool_stats
+
+
+
+/**
+   write_pool_stats
+
+   Write the memory pool statistics as a JSON object (on one line,
+   without a trailing newline), so they can be exported by a
+   program or embedded in a larger JSON document.
+
+*/
+void block_pool::write_pool_stats( FILE *fp )
+{
+  pool_stats s;
+
+  get_pool_stats( s );
+  fprintf(fp, "{ \"requested\": %lu, \"reserved\": %lu, \"blocks\": %lu, "
+          "\"mapped_blocks\": %lu, "
+          "\"waste\": %lu, \"high_water\": %lu, \"alloc_calls\": %lu, "
+          "\"free_calls\": %lu, \"alloc_failures\": %lu, "
+          "\"heap_fallbacks\": %lu, \"heap_bytes\": %lu }",
+          (unsigned long)s.requested, (unsigned long)s.reserved,
+          (unsigned long)s.blocks, (unsigned long)s.mapped_blocks,
+          (unsigned long)s.waste,
+          (unsigned long)s.high_water, (unsigned long)s.alloc_calls,
+          (unsigned long)s.free_calls, (unsigned long)s.alloc_failures,
+          (unsigned long)s.heap_fallbacks,
+          (unsigned long)s.heap_bytes );
+} // write_pool_stats
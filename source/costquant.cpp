@@ -0,0 +1,85 @@
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+#include <assert.h>
+#include <math.h>
+
+#include "costquant.h"
+
+
+/**
+  Quantize <i>v</i>: return the nearest whole multiple of
+  <i>step</i>, divided by <i>step</i>.
+ */
+double costquant::quantize( const double v, const double step )
+{
+  return floor( (v / step) + 0.5 );
+} // quantize
+
+
+/**
+  The number of bits needed to represent the whole number
+  <i>q</i>: a sign bit plus the number of bits in the magnitude.
+ */
+size_t costquant::quantWidth( const double q )
+{
+  size_t width = 1;
+  const double mag = (q < 0) ? -q : q;
+  if (mag >= 1.0) {
+    int exp;
+    frexp( mag, &exp );
+    width = width + exp;
+  }
+  return width;
+} // quantWidth
+
+
+/**
+  The cost of a node is the sum of the widths of its quantized
+  values.
+ */
+double costquant::costCalc( packnode<double> *node )
+{
+  assert( node != 0 );
+
+  const size_t len = node->length();
+  const double *a = node->getData();
+
+  size_t width = 0;
+  for (size_t i = 0; i < len; i++) {
+    width = width + quantWidth( quantize( a[i], step ) );
+  }
+
+  return (double)width;
+} // costCalc
@@ -1,10 +1,15 @@
 
 
 #include <assert.h>
+#include <math.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "blockpool.h"
 #include "invpacktree.h"
+#include "packprofile.h"
+#include "packtrace.h"
 
 /** \file
 
@@ -52,14 +57,18 @@
   half).
   
  */
-void invpacktree::new_level( packdata<double> *elem )
+template <class T>
+void basic_invpacktree<T>::new_level( packdata<T> *elem )
 {
   size_t half = elem->length();
   size_t n = half * 2;
 
-  packcontainer *container = new packcontainer( n );
-  container->lhsData( (double *)elem->getData() );
-  stack.add( container );
+  basic_packcontainer<T> *container = new basic_packcontainer<T>( n );
+  if (container == 0 || !stack.add( container )) {
+    allocError = true;
+    return;
+  }
+  container->lhsData( (T *)elem->getData() );
 } // new_level
 
 
@@ -81,11 +90,12 @@ void invpacktree::new_level( packdata<double> *elem )
   The left hand size will be the transform result.
 
  */
-void invpacktree::reduce()
+template <class T>
+void basic_invpacktree<T>::reduce()
 {
-  LIST<packcontainer *>::handle h;
+  typename LIST<basic_packcontainer<T> *>::handle h;
   h = stack.first();
-  packcontainer *tos = stack.get_item( h );
+  basic_packcontainer<T> *tos = stack.get_item( h );
 
   assert( tos->lhsData() != 0 && tos->rhsData() != 0 );
 
@@ -96,22 +106,33 @@ void invpacktree::reduce()
   */
   stack.remove();
 
-  int n = tos->length();
-  // calculate the inverse wavelet transform step
-  waveObj->inverseStep( (*tos), n );
-
-  // copy the result of the inverse wavelet transform
-  // into a new data array.
+  size_t n = tos->length();
   block_pool mem_pool;
 
-  double *vec = (double *)mem_pool.pool_alloc( n * sizeof( double ) );
-  for (int i = 0; i < n; i++) {
-    vec[i] = (*tos)[i];
+  T *vec = (T *)mem_pool.pool_alloc( n * sizeof( T ), block_pool::simd_align );
+  if (vec == 0) {
+    allocError = true;
+    return;
+  }
+
+  // calculate the inverse wavelet transform step.  If the
+  // wavelet provides raw array kernels the result is written
+  // directly into the new data array.
+  if (! waveObj->inverseSpan( tos->lhsData(), tos->rhsData(), vec, n )) {
+    waveObj->inverseStep( (*tos), n );
+
+    // copy the result of the inverse wavelet transform
+    // into the new data array.
+    for (size_t i = 0; i < n; i++) {
+      vec[i] = (*tos)[i];
+    }
   }
 
+  PACKPROF_COUNT( Inverse, 1, n * sizeof( T ), n );
+
   if (stack.first() != 0) {
     h = stack.first();
-    packcontainer *tos = stack.get_item( h );
+    basic_packcontainer<T> *tos = stack.get_item( h );
 
     if (tos->length() == n*2) {
       tos->rhsData( vec );
@@ -119,16 +140,22 @@ void invpacktree::reduce()
     }
     else {
       assert( tos->length() > n*2 );
-      packcontainer *container = new packcontainer( n*2 );
+      basic_packcontainer<T> *container = new basic_packcontainer<T>( n*2 );
+      if (container == 0 || !stack.add( container )) {
+        allocError = true;
+        return;
+      }
       container->lhsData( vec );
-      stack.add( container );
     }  // else
   }
   else {
     // the stack is empty
-    packcontainer *container = new packcontainer( n*2 );
+    basic_packcontainer<T> *container = new basic_packcontainer<T>( n*2 );
+    if (container == 0 || !stack.add( container )) {
+      allocError = true;
+      return;
+    }
     container->lhsData( vec );
-    stack.add( container );  
   }
 } // reduce
 
@@ -162,23 +189,28 @@ void invpacktree::reduce()
   then a new level is added.
 
  */
-void invpacktree::add_elem( packdata<double> *elem )
+template <class T>
+void basic_invpacktree<T>::add_elem( packdata<T> *elem )
 {
   assert( elem != 0 );
 
+  if (allocError) {
+    return;
+  }
+
   if (stack.first() == 0) {
     new_level( elem );
   }
   else {
     size_t half = elem->length();
     size_t n = half * 2;
-    LIST<packcontainer *>::handle h;
+    typename LIST<basic_packcontainer<T> *>::handle h;
     h = stack.first();
-    packcontainer *tos = stack.get_item( h );
+    basic_packcontainer<T> *tos = stack.get_item( h );
 
     if (tos->length() == n) {
       assert( tos->rhsData() == 0);
-      tos->rhsData( (double *)elem->getData() );
+      tos->rhsData( (T *)elem->getData() );
       reduce();
     }
     else if (tos->length() > n) {
@@ -200,44 +232,294 @@ void invpacktree::add_elem( packdata<double> *elem )
   was used to calculate the packet transform.
 
  */
-invpacktree::invpacktree( packdata_list<double> &list, 
-			  liftbase<packcontainer, double> *w )
+template <class T>
+basic_invpacktree<T>::basic_invpacktree( packdata_list<T> &list, 
+					liftbase<basic_packcontainer<T>, T> *w )
 {
   data = 0;
   N = 0;
+  allocError = false;
   waveObj = w;
+  packprofile::clear( profStats );
+  PACKPROF_SCOPE( profScope, &profStats );
 
   // Traverse the "best basis" list and calculate the inverse
   // wavelet packet transform.
-  packdata_list<double>::handle h;
+  typename packdata_list<T>::handle h;
+  PACKPROF_START( start );
+  PACKTRACE_SPAN( inverseSpan, "inverse", 0 );
   for (h = list.first(); h != 0; h = list.next( h )) {
-    packdata<double> *elem = list.get_item( h );
+    packdata<T> *elem = list.get_item( h );
     add_elem( elem );
   } // for
 
-  LIST<packcontainer *>::handle tosHandle;
+  finish();
+  PACKPROF_STOP( Inverse, start );
+} // basic_invpacktree
+
+
+
+/**
+  Walk the shape bitmap of a packbasis descriptor (top down, left to
+  right) and add each best basis node to the inverse wavelet packet
+  transform calculation.  The best basis nodes are wrapped in
+  packdata objects that reference the coefficient array <i>vec</i>.
+ */
+template <class T>
+void basic_invpacktree<T>::add_basis( packbasis<T> &basis,
+                             T *vec,
+                             size_t &bit,
+                             size_t &offset,
+                             const size_t n,
+                             const typename packdata<T>::transformKind kind )
+{
+  if (allocError) {
+    return;
+  }
+  if (basis.shapeBit( bit++ )) {
+    add_basis( basis, vec, bit, offset, n/2, packdata<T>::LowPass );
+    add_basis( basis, vec, bit, offset, n/2, packdata<T>::HighPass );
+  }
+  else {
+    packdata<T> *elem = new packdata<T>( vec + offset, n, kind );
+    if (elem == 0) {
+      allocError = true;
+      return;
+    }
+    add_elem( elem );
+    offset = offset + n;
+  }
+} // add_basis
+
+
+
+/**
+  Calculate the inverse wavelet packet transform from a packbasis
+  descriptor (see packtree::getBestBasis).  Unlike the packdata_list
+  version, the best basis data is not destroyed: the coefficients
+  are copied out of the descriptor before the inverse transform
+  is calculated, so the descriptor can be cached and reused.
+
+ */
+template <class T>
+basic_invpacktree<T>::basic_invpacktree( packbasis<T> &basis, 
+					liftbase<basic_packcontainer<T>, T> *w )
+{
+  data = 0;
+  N = 0;
+  allocError = false;
+  waveObj = w;
+  packprofile::clear( profStats );
+  PACKPROF_SCOPE( profScope, &profStats );
+
+  if (basis.ok()) {
+    PACKPROF_START( start );
+    const size_t len = basis.length();
+    PACKTRACE_SPAN( inverseSpan, "inverse", len );
+    block_pool mem_pool;
+
+    T *vec = (T *)mem_pool.pool_alloc( len * sizeof( T ), block_pool::simd_align );
+    if (vec != 0) {
+      memcpy( vec, basis.coef(), len * sizeof( T ) );
+
+      size_t bit = 0;
+      size_t offset = 0;
+      add_basis( basis, vec, bit, offset, len, packdata<T>::OriginalData );
+
+      finish();
+    }
+    PACKPROF_STOP( Inverse, start );
+  }
+} // basic_invpacktree
+
+
+
+/**
+  Skip the subtree of the best basis that starts at shape bit
+  <i>bit</i>.  The bit and coefficient offsets are advanced past
+  the subtree.
+ */
+template <class T>
+void basic_invpacktree<T>::skip_basis( packbasis<T> &basis,
+                                       size_t &bit,
+                                       size_t &offset,
+                                       const size_t n )
+{
+  if (basis.shapeBit( bit++ )) {
+    skip_basis( basis, bit, offset, n/2 );
+    skip_basis( basis, bit, offset, n/2 );
+  }
+  else {
+    offset = offset + n;
+  }
+} // skip_basis
+
+
+/**
+  Walk down the low pass side of the best basis tree, <i>levels</i>
+  steps from the node of length <i>n</i>.  The subtree at the end
+  of the walk is added to the inverse transform calculation, so the
+  result is the low pass data at that level.  The high pass
+  subtrees along the way are skipped.
+
+  If the walk reaches a best basis node before it has gone down
+  <i>levels</i> steps, the low pass data is calculated from the
+  node with forward transform steps.
+ */
+template <class T>
+void basic_invpacktree<T>::add_coarse( packbasis<T> &basis,
+                                       T *vec,
+                                       size_t &bit,
+                                       size_t &offset,
+                                       const size_t n,
+                                       const size_t levels )
+{
+  if (levels == 0) {
+    add_basis( basis, vec, bit, offset, n, packdata<T>::LowPass );
+  }
+  else if (basis.shapeBit( bit )) {
+    bit++;
+    add_coarse( basis, vec, bit, offset, n/2, levels - 1 );
+    skip_basis( basis, bit, offset, n/2 );
+  }
+  else {
+    block_pool mem_pool;
+    T *src = vec + offset;
+    size_t len = n;
+    for (size_t l = 0; l < levels && len > 1; l++) {
+      T *lhsVec = (T *)mem_pool.pool_alloc( (len/2) * sizeof( T ), block_pool::simd_align );
+      T *rhsVec = (T *)mem_pool.pool_alloc( (len/2) * sizeof( T ), block_pool::simd_align );
+      if (lhsVec == 0 || rhsVec == 0) {
+        allocError = true;
+        return;
+      }
+      if (! waveObj->forwardSpan( src, lhsVec, rhsVec, (int)len )) {
+        basic_packcontainer<T> container( len );
+        container.lhsData( lhsVec );
+        container.rhsData( rhsVec );
+        waveObj->forwardStepFrom( src, container, (int)len );
+      }
+      src = lhsVec;
+      len = len/2;
+    }
+    packdata<T> *elem = new packdata<T>( src, len, packdata<T>::LowPass );
+    if (elem == 0) {
+      allocError = true;
+      return;
+    }
+    add_elem( elem );
+    bit++;
+    offset = offset + n;
+  }
+} // add_coarse
+
+
+/**
+  Calculate a coarse version of the data from a packbasis descriptor:
+  the inverse wavelet packet transform stops <i>levels</i> steps
+  before the end.  The result has N/2<sup>levels</sup> elements,
+  each the (smoothed) average of 2<sup>levels</sup> data elements.
+  The low pass data is divided by the gain of the wavelet's low pass
+  filter (see liftbase::lowPassGain), so it is on the same scale as
+  the data.
+
+  Only the best basis nodes under the low pass node at the coarse
+  level are used.  Since the shape bitmap is stored in pre-order,
+  these are the first coefficients of the descriptor.  As with the
+  other packbasis constructor the descriptor is not changed.
+ */
+template <class T>
+basic_invpacktree<T>::basic_invpacktree( packbasis<T> &basis, 
+					liftbase<basic_packcontainer<T>, T> *w,
+					const size_t levels )
+{
+  data = 0;
+  N = 0;
+  allocError = false;
+  waveObj = w;
+  packprofile::clear( profStats );
+  PACKPROF_SCOPE( profScope, &profStats );
+
+  if (basis.ok()) {
+    const size_t len = basis.length();
+    if ((len >> levels) == 0) {
+      printf("invpacktree: %u levels is too many for %u elements\n",
+             (unsigned)levels, (unsigned)len );
+      return;
+    }
+    PACKPROF_START( start );
+    PACKTRACE_SPAN( inverseSpan, "inverse", len );
+    block_pool mem_pool;
+    T *vec = (T *)mem_pool.pool_alloc( len * sizeof( T ), block_pool::simd_align );
+    if (vec == 0) {
+      return;
+    }
+    memcpy( vec, basis.coef(), len * sizeof( T ) );
+
+    size_t bit = 0;
+    size_t offset = 0;
+    add_coarse( basis, vec, bit, offset, len, levels );
+    finish();
+
+    const double gain = w->lowPassGain();
+    if (data != 0 && gain != 1.0 && levels > 0) {
+      const double scale = 1.0 / pow( gain, (double)levels );
+      T *rslt = (T *)data;
+      for (size_t i = 0; i < N; i++) {
+        rslt[i] = (T)(rslt[i] * scale);
+      }
+    }
+    PACKPROF_STOP( Inverse, start );
+  }
+} // basic_invpacktree
+
+
+/**
+  All of the best basis elements have been added.  The result of
+  the inverse transform is the left hand side of the container
+  on the top of the stack.  If memory could not be allocated,
+  there is no result.
+ */
+template <class T>
+void basic_invpacktree<T>::finish()
+{
+  typename LIST<basic_packcontainer<T> *>::handle tosHandle;
   tosHandle = stack.first();
-  packcontainer *tos = stack.get_item( tosHandle );
 
-  if (tos != 0) {
+  // the stack may be empty if an allocation failed in reduce
+  if (tosHandle != 0 && !allocError) {
+    basic_packcontainer<T> *tos = stack.get_item( tosHandle );
     size_t len = tos->length();
     N = len/2;
 
     data = tos->lhsData();
     stack.remove();
   }
-} // invpacktree
+} // finish
 
 
 /**
   print the result of the inverse wavelet packet transform
  */
-void invpacktree::pr()
+template <class T>
+void basic_invpacktree<T>::pr()
 {
   if (data != 0) {
-    for (int i = 0; i < N; i++) {
-      printf("%7.4f ", data[i] );
+    for (size_t i = 0; i < N; i++) {
+      printf("%7.4f ", (double)data[i] );
     }
     printf("\n");
   }
 } // pr
+
+
+
+/*
+  Explicit instantiation of the inverse packet transform for the
+  element types of the packet tree (see packtree_base.cpp)
+ */
+template class basic_invpacktree<int16_t>;
+template class basic_invpacktree<int32_t>;
+template class basic_invpacktree<int64_t>;
+template class basic_invpacktree<float>;
+template class basic_invpacktree<double>;
@@ -2,13 +2,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "blockpool.h"
+
 /** \file
 
   This file contains overrides for the global new and delete
   operators.  These exist to assure that only the pool allocation
-  functions are called.  If you see a message from one of these
-  functions then something other than pool allocation is taking
-  place.
+  functions are called.  Each call to one of the new operators is
+  counted in the memory pool statistics (the heap_fallbacks and
+  heap_bytes values returned by block_pool::get_pool_stats), so a
+  program can check that something other than pool allocation is
+  taking place without printing a message for each allocation.
 
   This file is only used for testing.  If you don't want to do this
   check you can remove this file from the software build.
@@ -17,7 +21,7 @@
 
 void *operator new( size_t num_bytes )
 {
-  printf("global operator new\n");
+  block_pool::note_heap_alloc( num_bytes );
   void *rtn = malloc( num_bytes );
   return rtn;
 } // new
@@ -25,7 +29,7 @@ void *operator new( size_t num_bytes )
 
 void *operator new[]( size_t num_bytes )
 {
-  printf("global operator new []\n");
+  block_pool::note_heap_alloc( num_bytes );
   void *rtn = malloc( num_bytes );
   return rtn;
 }
@@ -33,13 +37,11 @@ void *operator new[]( size_t num_bytes )
 
 void operator delete( void *addr )
 {
-  printf("global operator delete\n");
   free( addr );
 }
 
 
 void operator delete[](void *addr )
 {
-  printf("global operator delete []\n");
   free( addr );
 }
@@ -31,6 +31,7 @@
 
  */
 #include <assert.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <math.h>
 
@@ -75,34 +76,50 @@
   is calculated and whether the location of the filter results
   is inverted.
 
-  \arg vec An array of double values on which the wavelet packet
+  \arg vec An array of <i>T</i> values on which the wavelet packet
            transform is calculated.
   \arg N The number of elements in the input array
   \arg w A pointer to the the wavelet transform object to use 
          in calculating the wavelet packet transform.
+  \arg kind CopyInput (the default) copies <i>vec</i> into the
+         memory pool.  BorrowInput uses <i>vec</i> as the root
+         of the tree without copying it.
+  \arg minLength The length of the shortest nodes in the tree.
+         The default (one) builds all log<sub>2</sub>(N) levels.
+         Since getLevel is usually only called for a level in the
+         middle of the tree (e.g., 32 nodes of 32 elements for N =
+         1024), setting minLength to the node length of that level
+         avoids calculating the levels below it.
 
  */
-packfreq::packfreq( const double *vec, 
-		    const size_t N, 
-		    liftbase<packcontainer, double> *w )
+template <class T>
+basic_packfreq<T>::basic_packfreq( const T *vec, 
+				  const size_t N, 
+				  liftbase<basic_packcontainer<T>, T> *w,
+				  packtree_base::inputKind kind /*= CopyInput */,
+				  const size_t minLength /*= 1 */ )
 {
-  waveObj = w;
+  this->waveObj = w;
+  packtree_base::minLength( minLength );
 
-  block_pool mem_pool;
-  double *vecCopy = (double *)mem_pool.pool_alloc( N * sizeof( double ) );
+  T *vecData = this->rootData( vec, N, kind );
 
-  for (int i = 0; i < N; i++) {
-    vecCopy[i] = vec[i];
+  if (vecData != 0) {
+    this->root = new packnode<T>( vecData, N, packnode<T>::OriginalData );
   }
-
-  root = new packnode<double>( vecCopy, N, packnode<double>::OriginalData );
-  root->mark( true );
-  //
-  // The first level uses the standard wavelet calculation, so
-  // reverse = false
-  //              freqCalc, reverse
-  newLevel( root, true,     false );
-} // packfreq
+  if (this->root != 0) {
+    this->root->mark( true );
+    //
+    // The first level uses the standard wavelet calculation
+    // (reverse = false, see buildTree)
+    //               freqCalc
+    this->buildTree( this->root, true );
+  }
+  else if (kind != packtree_base::BorrowInput || vec != 0) {
+    // the memory for the root could not be allocated
+    this->allocError = true;
+  }
+} // basic_packfreq
 
 
 
@@ -112,8 +129,9 @@ packfreq::packfreq( const double *vec,
   
   Levels are numbered from 0 at the root.
  */
-void packfreq::findLevel( packnode<double>* top, 
-			  size_t cur_level,
+template <class T>
+void basic_packfreq<T>::findLevel( packnode<T>* top, 
+				  size_t cur_level,
 			  const size_t level )
 {
   if (top != 0) {
@@ -155,9 +173,10 @@ void packfreq::findLevel( packnode<double>* top,
   band.
 
  */
-void packfreq::getLevel( const size_t level )
+template <class T>
+void basic_packfreq<T>::getLevel( const size_t level )
 {
-  findLevel( root, 0, level );
+  findLevel( this->root, 0, level );
 } // getLevel
 
 
@@ -225,7 +244,8 @@ void packfreq::getLevel( const size_t level )
   are commented out, making it a bit of a hack.
 
  */
-void packfreq::plotMat(const size_t N)
+template <class T>
+void basic_packfreq<T>::plotMat(const size_t N)
 {
   size_t num_y = mat.length();
   const double incr = (double)N / (double)num_y;
@@ -261,14 +281,15 @@ void packfreq::plotMat(const size_t N)
 /**
   Print the contents of the level basis matrix
  */
-void packfreq::prMat()
+template <class T>
+void basic_packfreq<T>::prMat()
 {
   size_t num_y = mat.length();
   if (num_y > 0) {
     size_t num_x = mat[0]->length();
     for (size_t y = num_y-1; y >= 0; y--) {
       for (size_t x = 0; x < num_x; x++) {
-	printf(" %7.4f ", (*mat[y])[ x ] );
+	printf(" %7.4f ", (double)(*mat[y])[ x ] );
       }
       printf("\n");
       fflush(stdout);
@@ -277,3 +298,13 @@ void packfreq::prMat()
 } // prMat
 
 
+
+/*
+  Explicit instantiation of the frequency analysis tree for the
+  element types listed in packtree_base.cpp
+ */
+template class basic_packfreq<int16_t>;
+template class basic_packfreq<int32_t>;
+template class basic_packfreq<int64_t>;
+template class basic_packfreq<float>;
+template class basic_packfreq<double>;
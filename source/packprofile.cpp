@@ -0,0 +1,267 @@
+
+/** \file
+
+  The phase timers and counters for the wavelet packet pipeline
+  (see packprofile.h).
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxyeng.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+#include <stdio.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#include <sys/time.h>
+#endif
+
+#include "packprofile.h"
+
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+
+packprofile::stats packprofile::total;
+
+/** the stats of the tree the current thread is working on (or 0) */
+static THREAD_LOCAL packprofile::stats *threadStats = 0;
+
+
+/**
+  Return a wall clock time, in seconds.  Only the difference between
+  two times is meaningful.
+ */
+double packprofile::now()
+{
+#if defined(_WIN32)
+  LARGE_INTEGER count, freq;
+  QueryPerformanceCounter( &count );
+  QueryPerformanceFrequency( &freq );
+  return (double)count.QuadPart / (double)freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+#else
+  struct timeval tv;
+  gettimeofday( &tv, 0 );
+  return (double)tv.tv_sec + ((double)tv.tv_usec * 1e-6);
+#endif
+} // now
+
+
+/**
+  Return the current stats of the calling thread, or 0 if the thread
+  is not working on a tree.
+ */
+packprofile::stats *packprofile::current()
+{
+  return threadStats;
+} // current
+
+
+/**
+  Make <i>s</i> (which may be 0) the current stats of the calling
+  thread.  The previous current stats are returned.
+ */
+packprofile::stats *packprofile::setCurrent( stats *s )
+{
+  stats *prev = threadStats;
+  threadStats = s;
+  return prev;
+} // setCurrent
+
+
+/**
+  If <i>s</i> is the current stats of the calling thread, clear the
+  current stats.  This is called when the object that holds the
+  stats is destroyed.
+ */
+void packprofile::release( const stats *s )
+{
+  if (threadStats == s) {
+    threadStats = 0;
+  }
+} // release
+
+
+/**
+  Add a timed call of <i>seconds</i> to phase <i>kind</i> of the
+  global counters and of the current stats.
+ */
+void packprofile::time( const phaseKind kind, const double seconds )
+{
+  total.phases[kind].seconds += seconds;
+  total.phases[kind].calls++;
+
+  stats *s = threadStats;
+  if (s != 0) {
+    s->phases[kind].seconds += seconds;
+    s->phases[kind].calls++;
+  }
+} // time
+
+
+/**
+  Add to the node, byte and coefficient counts of phase <i>kind</i>
+  of the global counters and of the current stats.
+ */
+void packprofile::count( const phaseKind kind,
+                         const size_t nodes,
+                         const size_t bytes,
+                         const size_t coef )
+{
+  total.phases[kind].nodes += nodes;
+  total.phases[kind].bytes += bytes;
+  total.phases[kind].coef += coef;
+
+  stats *s = threadStats;
+  if (s != 0) {
+    s->phases[kind].nodes += nodes;
+    s->phases[kind].bytes += bytes;
+    s->phases[kind].coef += coef;
+  }
+} // count
+
+
+/**
+  Set the counters in <i>s</i> to zero.
+ */
+void packprofile::clear( stats &s )
+{
+  memset( &s, 0, sizeof( s ) );
+} // clear
+
+
+/**
+  Add the counters in <i>s</i> to <i>sum</i>.
+ */
+void packprofile::add( stats &sum, const stats &s )
+{
+  for (size_t i = 0; i < numPhases; i++) {
+    const phase &a = s.phases[i];
+    phase &r = sum.phases[i];
+
+    r.seconds += a.seconds;
+    r.calls += a.calls;
+    r.nodes += a.nodes;
+    r.bytes += a.bytes;
+    r.coef += a.coef;
+  }
+} // add
+
+
+/**
+  Copy the current value of the global counters into <i>s</i>.
+ */
+void packprofile::snapshot( stats &s )
+{
+  s = total;
+} // snapshot
+
+
+/**
+  Set <i>result</i> to the change in the global counters since the
+  snapshot <i>start</i> was taken.
+ */
+void packprofile::diff( const stats &start, stats &result )
+{
+  for (size_t i = 0; i < numPhases; i++) {
+    const phase &a = start.phases[i];
+    const phase &b = total.phases[i];
+    phase &r = result.phases[i];
+
+    r.seconds = b.seconds - a.seconds;
+    r.calls = b.calls - a.calls;
+    r.nodes = b.nodes - a.nodes;
+    r.bytes = b.bytes - a.bytes;
+    r.coef = b.coef - a.coef;
+  }
+} // diff
+
+
+/**
+  Set the global counters to zero.  Snapshots taken before the
+  reset should not be passed to diff after it.
+ */
+void packprofile::reset()
+{
+  memset( &total, 0, sizeof( total ) );
+} // reset
+
+
+/**
+  Return the name of a phase.
+ */
+const char *packprofile::phaseName( const phaseKind kind )
+{
+  const char *name = "unknown";
+
+  switch (kind) {
+  case Build: name = "build";
+    break;
+  case Cost: name = "cost";
+    break;
+  case BestBasis: name = "best basis";
+    break;
+  case Inverse: name = "inverse";
+    break;
+  case Alloc: name = "alloc";
+    break;
+  default:
+    break;
+  } // switch
+  return name;
+} // phaseName
+
+
+/**
+  Print a table of the counters in <i>s</i>, one line for each phase.
+ */
+void packprofile::pr( const stats &s, FILE *fp /*= stdout */ )
+{
+  fprintf(fp, "%-12s %12s %10s %10s %12s %12s\n",
+          "phase", "msec", "calls", "nodes", "bytes", "coef" );
+  for (size_t i = 0; i < numPhases; i++) {
+    const phase &p = s.phases[i];
+    fprintf(fp, "%-12s %12.3f %10lu %10lu %12lu %12lu\n",
+            phaseName( (phaseKind)i ),
+            p.seconds * 1000.0,
+            (unsigned long)p.calls,
+            (unsigned long)p.nodes,
+            (unsigned long)p.bytes,
+            (unsigned long)p.coef );
+  }
+} // pr
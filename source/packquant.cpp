@@ -0,0 +1,178 @@
+
+/** \file
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxygen.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+
+#include <math.h>
+#include <stdio.h>
+
+#include "packquant.h"
+#include "packtree.h"
+#include "invpacktree.h"
+#include "costquant.h"
+
+
+/**
+  Build the wavelet packet tree, choose the best basis for the
+  quantization step <i>step</i>, quantize the best basis and check
+  the error of the inverse transform.  If the error is within the
+  bound <i>maxErr</i> the result is saved and the function returns
+  true.  If the memory for the tree, the best basis or the inverse
+  transform cannot be allocated, allocError is set and false is
+  returned.
+ */
+bool packquant::quantTry( const double *vec,
+                          const size_t N,
+                          liftbase<packcontainer, double> *w,
+                          const size_t minLength,
+                          const double maxErr,
+                          const double step )
+{
+  packtree tree( vec, N, w, packtree_base::CopyInput, minLength );
+  if (! tree.ok()) {
+    allocError = true;
+    return false;
+  }
+  costquant cost( tree.getRoot(), step );
+  tree.bestBasis();
+
+  packbasis<double> quant = tree.getBestBasis();
+  if (! quant.ok()) {
+    allocError = true;
+    return false;
+  }
+  double *coef = quant.coef();
+  size_t quantWidth = 0;
+  for (size_t i = 0; i < N; i++) {
+    const double q = costquant::quantize( coef[i], step );
+    quantWidth = quantWidth + costquant::quantWidth( q );
+    coef[i] = q * step;
+  }
+
+  invpacktree inv( quant, w );
+  const double *rslt = inv.getData();
+  if (rslt == 0) {
+    allocError = true;
+    return false;
+  }
+  double maxDiff = 0.0;
+  for (size_t i = 0; i < N; i++) {
+    const double diff = fabs( rslt[i] - vec[i] );
+    if (diff > maxDiff) {
+      maxDiff = diff;
+    }
+  }
+
+  const bool inBound = (maxDiff <= maxErr);
+  if (inBound) {
+    basis = quant;
+    quantStep = step;
+    error = maxDiff;
+    width = quantWidth;
+  }
+  return inBound;
+} // quantTry
+
+
+/**
+  Calculate a quantized wavelet packet best basis for the <i>N</i>
+  values in <i>vec</i> (N must be a power of two) with the wavelet
+  <i>w</i>.  The inverse transform of the result is within
+  <i>maxErr</i> of the original data.  If no step is found within
+  the error bound (e.g., the bound is zero) an error is printed and
+  ok() returns false.
+ */
+packquant::packquant( const double *vec,
+                      const size_t N,
+                      liftbase<packcontainer, double> *w,
+                      const double maxErr,
+                      const size_t minLength /*= 1 */ )
+{
+  quantStep = 0.0;
+  error = 0.0;
+  width = 0;
+  allocError = false;
+
+  if (vec == 0 || N == 0 || w == 0 || ! (maxErr > 0.0)) {
+    printf("packquant: bad arguments\n");
+    return;
+  }
+
+  double step = 2.0 * maxErr;
+  for (size_t i = 0; i < maxTries && ! basis.ok() && ! allocError; i++) {
+    if (! quantTry( vec, N, w, minLength, maxErr, step )) {
+      step = step / 2.0;
+    }
+  }
+
+  if (! basis.ok() && allocError) {
+    printf("packquant: memory could not be allocated\n" );
+  }
+  else if (! basis.ok()) {
+    printf("packquant: the error bound %g could not be met\n", maxErr );
+  }
+  else if (quantStep < 2.0 * maxErr) {
+    // the step in (quantStep, 2 * quantStep) may still be within the bound
+    double lo = quantStep;
+    double hi = 2.0 * quantStep;
+    for (size_t i = 0; i < refineTries && ! allocError; i++) {
+      const double mid = (lo + hi) / 2.0;
+      if (quantTry( vec, N, w, minLength, maxErr, mid )) {
+        lo = mid;
+      }
+      else {
+        hi = mid;
+      }
+    }
+  }
+} // packquant
+
+
+/**
+  Write the quantized best basis coefficients, as whole numbers (the
+  coefficient divided by the step), to <i>q</i>, which must have
+  room for getBasis().length() values.  Returns false if there is no
+  quantized best basis.
+ */
+bool packquant::getQuantized( long long *q ) const
+{
+  bool rslt = false;
+  if (basis.ok()) {
+    const double *coef = basis.coef();
+    const size_t N = basis.length();
+    for (size_t i = 0; i < N; i++) {
+      q[i] = (long long)costquant::quantize( coef[i], quantStep );
+    }
+    rslt = true;
+  }
+  return rslt;
+} // getQuantized
@@ -0,0 +1,283 @@
+
+/** \file
+
+  Trace spans for the wavelet packet pipeline (see packtrace.h).
+
+  The documentation in this file is formatted for doxygen
+  (see www.doxyeng.org).
+
+<h4>
+   Copyright and Use
+</h4>
+
+<p>
+   You may use this source code without limitation and without
+   fee as long as you include:
+</p>
+<blockquote>
+     This software was written and is copyrighted by Ian Kaplan, Bear
+     Products International, www.bearcave.com, 2002.
+</blockquote>
+<p>
+   This software is provided "as is", without any warranty or
+   claim as to its usefulness.  Anyone who uses this source code
+   uses it at their own risk.  Nor is any support provided by
+   Ian Kaplan and Bear Products International.
+<p>
+   Please send any bug fixes or suggested source changes to:
+<pre>
+     iank@bearcave.com
+</pre>
+
+  @author Ian Kaplan
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+#include "packprofile.h"
+#include "packtrace.h"
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+
+volatile bool packtrace::on = false;
+size_t packtrace::capacity = packtrace::defaultEvents;
+double packtrace::origin = 0.0;
+volatile size_t packtrace::generation = 1;
+volatile long packtrace::numBufs = 0;
+packtrace::threadBuf *packtrace::bufs[ packtrace::maxThreads ];
+
+/** the buffer of the current thread */
+static THREAD_LOCAL packtrace::threadBuf *threadLocalBuf = 0;
+/** the generation of the current thread's buffer (zero if none) */
+static THREAD_LOCAL size_t threadLocalGen = 0;
+
+
+/**
+  Return the number of buffers in the table for a buffer count of
+  <i>count</i>.  numBufs counts every thread that has asked for a
+  slot, so it can be larger than the table.
+ */
+static long tableSize( const long count )
+{
+  return (count < (long)packtrace::maxThreads) ? count : (long)packtrace::maxThreads;
+} // tableSize
+
+
+/**
+  Return the buffer of the calling thread.  The first call from a
+  thread (after enable or clear) allocates the buffer and adds it to
+  the table.  Zero is returned if the table is full or the memory
+  cannot be allocated.
+ */
+packtrace::threadBuf *packtrace::localBuf()
+{
+  if (threadLocalGen != generation) {
+    threadLocalBuf = 0;
+    threadLocalGen = generation;
+
+#if defined(_WIN32)
+    const long slot = InterlockedIncrement( &numBufs ) - 1;
+#else
+    const long slot = __sync_fetch_and_add( &numBufs, 1 );
+#endif
+    if (slot < maxThreads) {
+      threadBuf *buf = (threadBuf *)malloc( sizeof( threadBuf ) );
+      event *events = (event *)malloc( capacity * sizeof( event ) );
+      if (buf != 0 && events != 0) {
+        buf->tid = (size_t)slot + 1;
+        buf->count = 0;
+        buf->dropped = 0;
+        buf->events = events;
+        threadLocalBuf = buf;
+      }
+      else {
+        free( events );
+        free( buf );
+      }
+      // a slot without a buffer is left empty (see write)
+      bufs[ slot ] = threadLocalBuf;
+    }
+  }
+  return threadLocalBuf;
+} // localBuf
+
+
+/**
+  Discard the recorded spans and start recording.  Each thread can
+  record up to <i>eventsPerThread</i> spans.  The times of the spans
+  are measured from this call.
+ */
+void packtrace::enable( const size_t eventsPerThread /*= defaultEvents */ )
+{
+  clear();
+  capacity = (eventsPerThread > 0) ? eventsPerThread : 1;
+  origin = packprofile::now();
+  on = true;
+} // enable
+
+
+/**
+  Stop recording spans.  The spans that have been recorded are kept
+  until they are cleared.
+ */
+void packtrace::disable()
+{
+  on = false;
+} // disable
+
+
+/**
+  Free the thread buffers and the spans in them.
+ */
+void packtrace::clear()
+{
+  const long n = tableSize( numBufs );
+
+  for (long i = 0; i < n; i++) {
+    if (bufs[i] != 0) {
+      free( bufs[i]->events );
+      free( bufs[i] );
+      bufs[i] = 0;
+    }
+  }
+  numBufs = 0;
+  generation++;
+} // clear
+
+
+/**
+  Return the time, in microseconds, since enable was called.
+ */
+double packtrace::now()
+{
+  return (packprofile::now() - origin) * 1e6;
+} // now
+
+
+/**
+  Add a span to the buffer of the calling thread.  The start and end
+  times are in microseconds (see now).
+ */
+void packtrace::add( const char *name,
+                     const double start,
+                     const double end,
+                     const size_t n )
+{
+  threadBuf *buf = localBuf();
+
+  if (buf != 0) {
+    if (buf->count < capacity) {
+      event *e = &buf->events[ buf->count ];
+      e->name = name;
+      e->start = start;
+      e->dur = end - start;
+      e->n = n;
+      buf->count++;
+    }
+    else {
+      buf->dropped++;
+    }
+  }
+} // add
+
+
+/**
+  Return the number of spans that have been recorded, in all of the
+  threads.
+ */
+size_t packtrace::numEvents()
+{
+  const long n = tableSize( numBufs );
+  size_t count = 0;
+
+  for (long i = 0; i < n; i++) {
+    if (bufs[i] != 0) {
+      count += bufs[i]->count;
+    }
+  }
+  return count;
+} // numEvents
+
+
+/**
+  Return the number of spans that did not fit in the thread buffers.
+ */
+size_t packtrace::numDropped()
+{
+  const long n = tableSize( numBufs );
+  size_t count = 0;
+
+  for (long i = 0; i < n; i++) {
+    if (bufs[i] != 0) {
+      count += bufs[i]->dropped;
+    }
+  }
+  return count;
+} // numDropped
+
+
+/**
+  Write the recorded spans to <i>fp</i> in the Chrome trace event
+  (JSON) format.  Each thread is named "thread <i>n</i>" and
+  each span has its size as the argument "n".
+ */
+bool packtrace::write( FILE *fp )
+{
+  const long numThreads = tableSize( numBufs );
+  const char *sep = "";
+
+  fprintf(fp, "{\n");
+  fprintf(fp, "  \"displayTimeUnit\": \"ns\",\n");
+  fprintf(fp, "  \"traceEvents\": [");
+  for (long i = 0; i < numThreads; i++) {
+    const threadBuf *buf = bufs[i];
+    if (buf != 0) {
+      fprintf(fp, "%s\n    { \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+              "\"tid\": %lu, \"args\": { \"name\": \"thread %lu\" } }",
+              sep, (unsigned long)buf->tid, (unsigned long)buf->tid );
+      sep = ",";
+      for (size_t j = 0; j < buf->count; j++) {
+        const event *e = &buf->events[j];
+        fprintf(fp, ",\n    { \"name\": \"%s\", \"cat\": \"packet\", \"ph\": \"X\", "
+                "\"pid\": 1, \"tid\": %lu, \"ts\": %.3f, \"dur\": %.3f, "
+                "\"args\": { \"n\": %lu } }",
+                e->name, (unsigned long)buf->tid, e->start, e->dur,
+                (unsigned long)e->n );
+      }
+    }
+  }
+  fprintf(fp, "\n  ]\n");
+  fprintf(fp, "}\n");
+  return (ferror( fp ) == 0);
+} // write
+
+
+/**
+  Write the recorded spans to the file <i>path</i> (see write).
+ */
+bool packtrace::write( const char *path )
+{
+  bool rslt = false;
+  FILE *fp = fopen( path, "w" );
+
+  if (fp != 0) {
+    rslt = write( fp );
+    if (fclose( fp ) != 0) {
+      rslt = false;
+    }
+  }
+  if (! rslt) {
+    printf("packtrace::write: could not write %s\n", path );
+  }
+  return rslt;
+} // write
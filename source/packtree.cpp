@@ -32,14 +32,17 @@
  */
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdio.h>
 
 #include "packcontainer.h"
 #include "packtree.h"
+#include "packprofile.h"
+#include "packtrace.h"
 
 
 /**
-  Construct a wavelet packet tree from a vector of double
+  Construct a wavelet packet tree from a vector of type <i>T</i>
   values.  The size of the vector, which must be a power
   of two, is passed in N.  A wavelet Lifting Scheme object
   is passed in <i>w</i>.  This object is used to calculate
@@ -49,30 +52,49 @@
   The first level (level 0) of the wavelet packet tree contains
   the original data set.
 
-  \arg vec An array of double values on which the wavelet packet
+  \arg vec An array of <i>T</i> values on which the wavelet packet
            transform is calculated.
   \arg N The number of elements in the input array
   \arg w A pointer to the the wavelet transform object to use 
          in calculating the wavelet packet transform.
+  \arg kind CopyInput (the default) copies <i>vec</i> into the
+         memory pool.  BorrowInput uses <i>vec</i> as the root
+         of the tree without copying it.  In this case the caller
+         must keep <i>vec</i> valid while the tree is used.
+  \arg minLength The length of the shortest nodes in the tree.
+         The default (one) builds all log<sub>2</sub>(N) levels.
+         For example, a minLength of 16 stops the decomposition
+         at nodes of 16 elements, which leaves out the four lowest
+         levels of the tree (and most of its nodes).  This is the
+         same as limiting the tree to log<sub>2</sub>(N/16) levels.
+         The cost functions and the best basis calculation work on
+         the tree that was built.
 
  */
-packtree::packtree( const double *vec, 
-                    const size_t N, 
-                    liftbase<packcontainer, double> *w )
+template <class T>
+basic_packtree<T>::basic_packtree( const T *vec, 
+                                  const size_t N, 
+                                  liftbase<basic_packcontainer<T>, T> *w,
+                                  packtree_base::inputKind kind /*= CopyInput */,
+                                  const size_t minLength /*= 1 */ )
 {
-  waveObj = w;
+  this->waveObj = w;
+  packtree_base::minLength( minLength );
 
-  block_pool mem_pool;
-  double *vecCopy = (double *)mem_pool.pool_alloc( N * sizeof( double ) );
+  T *vecData = this->rootData( vec, N, kind );
 
-  for (int i = 0; i < N; i++) {
-    vecCopy[i] = vec[i];
+  if (vecData != 0) {
+    this->root = new packnode<T>( vecData, N, packnode<T>::OriginalData );
   }
-
-  root = new packnode<double>( vecCopy, N, packnode<double>::OriginalData );
-  root->mark( true );
-  newLevel( root, false, false ); 
-} // packtree
+  if (this->root != 0) {
+    this->root->mark( true );
+    this->buildTree( this->root, false );
+  }
+  else if (kind != packtree_base::BorrowInput || vec != 0) {
+    // the memory for the root could not be allocated
+    this->allocError = true;
+  }
+} // basic_packtree
 
 
 
@@ -95,7 +117,8 @@ packtree::packtree( const double *vec,
   "marks" on these child nodes to false.
 
  */
-void packtree::cleanTree(packnode<double> *top, bool removeMark )
+template <class T>
+void basic_packtree<T>::cleanTree(packnode<T> *top, bool removeMark )
 {
   if (top != 0) {
     if (removeMark) {
@@ -121,10 +144,11 @@ void packtree::cleanTree(packnode<double> *top, bool removeMark )
   Print the wavelet packet tree cost values in breadth first
   order.
  */
-void packtree::prCost()
+template <class T>
+void basic_packtree<T>::prCost()
 {
-  if (root != 0) {
-    breadthFirstPrint(printCost);
+  if (this->root != 0) {
+    this->breadthFirstPrint(packtree_base::printCost);
   }
 }
 
@@ -133,11 +157,12 @@ void packtree::prCost()
   Print the wavelet packet tree, showing the nodes
   that have been selected by the "best basis" algorithm.
  */
-void packtree::prBestBasis()
+template <class T>
+void basic_packtree<T>::prBestBasis()
 {
-  if (root != 0) {
-    cleanTree( root, false );
-    breadthFirstPrint(printBestBasis);
+  if (this->root != 0) {
+    cleanTree( this->root, false );
+    this->breadthFirstPrint(packtree_base::printBestBasis);
   }
 } // prBestBasis
 
@@ -149,14 +174,21 @@ void packtree::prBestBasis()
   are "marked" become part of the best basis, which is a minimal
   representation of the data in terms of the cost function.
 
+  The leaves of the tree are the nodes of minimum length (see the
+  minLength constructor argument), so the best basis is chosen from
+  the levels that were built.
+
  */
-double packtree::bestBasisWalk( packnode<double> *top )
+template <class T>
+double basic_packtree<T>::bestBasisWalk( packnode<T> *top )
 {
   double cost = 0.0;
 
   if (top != 0) {
-    packnode<double> *lhs = top->lhsChild();
-    packnode<double> *rhs = top->rhsChild();
+    packnode<T> *lhs = top->lhsChild();
+    packnode<T> *rhs = top->rhsChild();
+
+    PACKPROF_COUNT( BestBasis, 1, 0, 0 );
 
     if (lhs == 0 && rhs == 0) { // we've reached a leaf
       cost = top->cost();
@@ -194,9 +226,14 @@ double packtree::bestBasisWalk( packnode<double> *top )
   Calculate the wavelet packet "best basis"
 
  */
-void packtree::bestBasis()
+template <class T>
+void basic_packtree<T>::bestBasis()
 {
-  bestBasisWalk( root );
+  PACKPROF_SCOPE( profScope, &this->profStats );
+  PACKPROF_START( start );
+  PACKTRACE_SPAN( bestSpan, "best basis", (this->root != 0) ? this->root->length() : 0 );
+  bestBasisWalk( this->root );
+  PACKPROF_STOP( BestBasis, start );
 } // bestBasis
 
 
@@ -215,12 +252,13 @@ void packtree::bestBasis()
   bestBasisOK().
 
  */
-void packtree::checkBestBasis( packnode<double> *top )
+template <class T>
+void basic_packtree<T>::checkBestBasis( packnode<T> *top )
 {
   if (top != 0) {
     if (top->mark()) {
       foundBestBasisVal = true;
-      if (top->getKind() == packdata<double>::OriginalData) {
+      if (top->getKind() == packdata<T>::OriginalData) {
         foundOriginalData = true;
       }
     }
@@ -247,11 +285,12 @@ void packtree::checkBestBasis( packnode<double> *top )
   include the original data.
 
  */
-bool packtree::bestBasisOK()
+template <class T>
+bool basic_packtree<T>::bestBasisOK()
 {
   foundOriginalData = false;
   foundBestBasisVal = false;
-  checkBestBasis( root );
+  checkBestBasis( this->root );
 
   bool rslt = (foundBestBasisVal && (!foundOriginalData));
 
@@ -268,12 +307,15 @@ bool packtree::bestBasisOK()
   passed by value without incurring a cost greater than 
   passing a pointer (e.g., pass by reference).
  */
-void packtree::buildBestBasisList( packnode<double> *top, 
-				   packdata_list<double> &list )
+template <class T>
+void basic_packtree<T>::buildBestBasisList( packnode<T> *top, 
+					    packdata_list<T> &list )
 {
   if (top != 0) {
     if (top->mark()) {
-      list.add( top );
+      if (! list.add( top )) {
+        this->allocError = true;
+      }
     }
     else {
       buildBestBasisList( top->lhsChild(), list );
@@ -286,12 +328,117 @@ void packtree::buildBestBasisList( packnode<double> *top,
 
 /** 
   Return a list consisting of the best basis packdata values.
+  If the memory for the list cannot be allocated the list is
+  incomplete and allocError is set (see ok).
 
  */
-packdata_list<double> packtree::getBestBasisList()
+template <class T>
+packdata_list<T> basic_packtree<T>::getBestBasisList()
 {
-  packdata_list<double> list;
+  packdata_list<T> list;
 
-  buildBestBasisList( root, list );
+  buildBestBasisList( this->root, list );
   return list;
 } // getBestBasisList
+
+
+
+/**
+  Count the number of best basis nodes and the number of bits
+  needed to describe the shape of the best basis tree.  The
+  traversal is the same as the traversal in buildBestBasisList.
+ */
+template <class T>
+void basic_packtree<T>::countBestBasis( packnode<T> *top, 
+                                        size_t &numNodes, 
+                                        size_t &numBits )
+{
+  if (top != 0) {
+    numBits++;
+    if (top->mark() || top->lhsChild() == 0) {
+      numNodes++;
+    }
+    else {
+      countBestBasis( top->lhsChild(), numNodes, numBits );
+      countBestBasis( top->rhsChild(), numNodes, numBits );
+    }
+  }
+} // countBestBasis
+
+
+
+/**
+  Traverse the tree from the top down, setting a shape bit for
+  each node that is split and copying the data for each best
+  basis node into the descriptor coefficient array.
+ */
+template <class T>
+void basic_packtree<T>::buildBestBasis( packnode<T> *top, 
+                                        packbasis<T> &basis,
+                                        size_t &bit,
+                                        size_t &offset )
+{
+  if (top != 0) {
+    if (top->mark() || top->lhsChild() == 0) {
+      basis.shapeBit( bit++, false );
+
+      const size_t len = top->length();
+      const T *vec = top->getData();
+      T *coef = basis.coef() + offset;
+      for (size_t i = 0; i < len; i++) {
+        coef[i] = vec[i];
+      }
+      offset = offset + len;
+    }
+    else {
+      basis.shapeBit( bit++, true );
+      buildBestBasis( top->lhsChild(), basis, bit, offset );
+      buildBestBasis( top->rhsChild(), basis, bit, offset );
+    }
+  }
+} // buildBestBasis
+
+
+
+/**
+  Return the best basis as a packbasis descriptor.  The descriptor
+  contains the shape of the best basis tree and a copy of the best
+  basis coefficients in a single contiguous block, so it remains
+  valid after the tree is no longer used and it can be copied with
+  a single memcpy.
+
+  The descriptor is consumed by the invpacktree constructor
+  that takes a packbasis argument.
+ */
+template <class T>
+packbasis<T> basic_packtree<T>::getBestBasis()
+{
+  size_t numNodes = 0;
+  size_t numBits = 0;
+
+  countBestBasis( this->root, numNodes, numBits );
+
+  packbasis<T> basis;
+  if (this->root != 0) {
+    basis = packbasis<T>( this->root->length(), numNodes, numBits );
+
+    if (basis.ok()) {
+      size_t bit = 0;
+      size_t offset = 0;
+      buildBestBasis( this->root, basis, bit, offset );
+    }
+  }
+  return basis;
+} // getBestBasis
+
+
+
+/*
+  Explicit instantiation of the wavelet packet tree for the
+  element types listed in packtree_base.cpp
+ */
+template class basic_packtree<int16_t>;
+template class basic_packtree<int32_t>;
+template class basic_packtree<int64_t>;
+template class basic_packtree<float>;
+template class basic_packtree<double>;
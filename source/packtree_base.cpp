@@ -1,18 +1,23 @@
 
 
+#include <stdint.h>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
 #include "queue.h"
 #include "packnode.h"
 #include "packcontainer.h"
 #include "packtree_base.h"
+#include "packprofile.h"
+#include "packtrace.h"
 
 
 /**
 
-  Add a new level to the wavelet packet tree.  Wavelet packet trees
-  are data structures that support a variety of applications.  
-
-  If the reverse argument is true, the locations of the high pass and
-  low pass filter results in the wavelet calculation will be
+  Split a wavelet packet tree node into a low pass and a high pass
+  child.  If the reverse argument is true, the locations of the high
+  pass and low pass filter results in the wavelet calculation will be
   reversed.  This is used in building a wavelet packet tree for
   frequency analysis.
 
@@ -20,63 +25,93 @@
   level.  If this is the first level in the tree, <i>top</i> will
   contain the input data set.
 
-  A packcontainer object is created with the <i>top</i> data.  The
-  packcontainer constructor will allocate new storage and copy the
-  data into this storage.  If the packcontainer object consists of N
-  elements, then there will be N/2 elements on the left and N/2 or the
-  right.  The object allows the lhs and rhs data to be accessed as one
-  array.
+  New storage is allocated for the N/2 elements on the left and the
+  N/2 elements on the right.
 
   A wavelet transform step is calculated on the N element data set.
+  The step is calculated out of place: the <i>top</i> data is read
+  and the result is written directly into the storage for the two
+  children, so the <i>top</i> data is not copied or modified.  If the
+  wavelet provides raw array kernels (forwardSpan), the step is
+  calculated on the arrays without any per-element index checks.
+  Otherwise a packcontainer object, which allows the lhs and rhs data
+  to be accessed as one array, is used as an adapter.
   This results in N/2 values from the wavelet scaling function (low
   pass function) and N/2 values from the wavelet function (high pass
   function).  These values are used to create two new packnode objects
-  which become children of <i>top</i>.  Sub-trees for the new packnode
-  objects are recursively calculated.
+  which become children of <i>top</i>.  The children are marked
+  (see newLevel) and the function returns true.
 
-  As the tree is constructed, the leaves of the tree are marked with a
-  boolean flag in preparation for calculating the "best basis"
-  representation for the data.  See the algorithm outlined in section
-  8.2.2 of "Ripples in Mathematics" by Jensen and la Cour-Harbo
-
-  The wavelet packet tree form that is used for wavelet packet
-  frequency analysis is described in section 9.3 (figure 9.14)
-  ofg "Ripples in Mathematics".  
+  A node is not split if its children would be shorter than the
+  minimum node length (see minLength) or if the memory for the
+  children cannot be allocated.  In this case the function returns
+  false and the node remains a leaf of the tree.  If the memory
+  cannot be allocated allocError is also set (see ok).
 
  */
-void packtree_base::newLevel( packnode<double>* top, 
-			      bool freqCalc, 
-			      bool reverse )
+template <class T>
+bool basic_packtree_base<T>::splitNode( packnode<T>* top, bool reverse )
 {
+  bool split = false;
+
   if (top != 0) {
     const size_t len = top->length();
-    if (len > 1) {
-      // Create a new wavelet packet container for use in
-      // calculating the wavelet transform.  Note that the
-      // container is only used locally.
-      packcontainer container( top );
+    if (len > 1 && (len >> 1) >= minLen) {
+      // Allocate the storage for the two children.  The
+      // wavelet transform step reads the parent's data and
+      // writes the results directly into the children.
+      block_pool mem_pool;
+      const size_t num_bytes = (len/2) * sizeof( T );
+      const T *src = top->getData();
+      T *lhsVec = (T *)mem_pool.pool_alloc( num_bytes, block_pool::simd_align );
+      T *rhsVec = (T *)mem_pool.pool_alloc( num_bytes, block_pool::simd_align );
+      bool done;
+
+      if (lhsVec == 0 || rhsVec == 0) {
+        // out of memory: the node remains a leaf
+        allocError = true;
+        return false;
+      }
 
       if (reverse) {
 	// Calculate the reverse foward wavelet transform step, 
-	// where the high pass result is stored in the upper half
-	// of the container and the low pass result is stored
-	// in the lower half of the container.
-	waveObj->forwardStepRev( container, len );
+	// where the high pass result is stored in the lhs
+	// and the low pass result is stored in the rhs.
+	done = waveObj->forwardSpanRev( src, lhsVec, rhsVec, len );
       }
       else {
 	// Calculate the foward wavelet transform step, where
-	// the high pass result is stored in the upper half
-	// of the container and the low pass result is stored
-	// in the lower half of the container.
-	waveObj->forwardStep( container, len );
+	// the low pass result is stored in the lhs and the high
+	// pass result is stored in the rhs.
+	done = waveObj->forwardSpan( src, lhsVec, rhsVec, len );
       }
 
-      packnode<double> *lhs = new packnode<double>(container.lhsData(), 
+      if (! done) {
+	// The wavelet does not provide raw array kernels, so
+	// a packcontainer is used as an adapter that makes the
+	// two arrays look like one contiguous array.
+	basic_packcontainer<T> container( len );
+	container.lhsData( lhsVec );
+	container.rhsData( rhsVec );
+
+	if (reverse) {
+	  waveObj->forwardStepRevFrom( src, container, len );
+	}
+	else {
+	  waveObj->forwardStepFrom( src, container, len );
+	}
+      }
+
+      packnode<T> *lhs = new packnode<T>(lhsVec, 
 						   len/2,
-						   packnode<double>::LowPass );
-      packnode<double> *rhs = new packnode<double>(container.rhsData(), 
+						   packnode<T>::LowPass );
+      packnode<T> *rhs = new packnode<T>(rhsVec, 
 						   len/2,
-						   packnode<double>::HighPass );
+						   packnode<T>::HighPass );
+      if (lhs == 0 || rhs == 0) {
+        allocError = true;
+        return false;
+      }
 
       // set the "mark" in the top node to false and
       // mark the two children to true.
@@ -87,25 +122,235 @@ void packtree_base::newLevel( packnode<double>* top,
       top->lhsChild( lhs );
       top->rhsChild( rhs );
 
-      // The transform on the left hand side always uses
-      // the standard order (e.g., low pass filter result
-      // goes in the lower half, high pass goes in the
-      // upper half of the container).
-      newLevel( lhs, freqCalc, false );
-
-      if (freqCalc) {
-	// wavelet packet frequency analysis reverses the
-	// storage locations for the filter results in the
-	// right hand child
-	newLevel( rhs, freqCalc, true );
+      PACKPROF_COUNT( Build, 2, 2 * num_bytes, len );
+
+      split = true;
+    }
+  }
+  return split;
+} // splitNode
+
+
+
+/**
+
+  Add a new level to the wavelet packet tree.  Wavelet packet trees
+  are data structures that support a variety of applications.  
+
+  The <i>top</i> node is split into two children (see splitNode)
+  and sub-trees for the new packnode objects are recursively
+  calculated (depth first).
+
+  As the tree is constructed, the leaves of the tree are marked with a
+  boolean flag in preparation for calculating the "best basis"
+  representation for the data.  See the algorithm outlined in section
+  8.2.2 of "Ripples in Mathematics" by Jensen and la Cour-Harbo
+
+  The wavelet packet tree form that is used for wavelet packet
+  frequency analysis is described in section 9.3 (figure 9.14)
+  ofg "Ripples in Mathematics".  
+
+ */
+template <class T>
+void basic_packtree_base<T>::newLevel( packnode<T>* top, 
+				      bool freqCalc, 
+				      bool reverse )
+{
+  if (splitNode( top, reverse )) {
+    // The transform on the left hand side always uses
+    // the standard order (e.g., low pass filter result
+    // goes in the lower half, high pass goes in the
+    // upper half of the container).
+    newLevel( top->lhsChild(), freqCalc, false );
+
+    if (freqCalc) {
+      // wavelet packet frequency analysis reverses the
+      // storage locations for the filter results in the
+      // right hand child
+      newLevel( top->rhsChild(), freqCalc, true );
+    }
+    else { // freq == false
+      // use standard filter location
+      newLevel( top->rhsChild(), freqCalc, false );
+    }
+  }
+} // newLevel
+
+
+
+/**
+  Cache size, in bytes, used to schedule the construction of the
+  wavelet packet tree.  Zero selects the size of the level 2 cache.
+ */
+size_t packtree_base::cacheBytes = 0;
+
+
+/**
+  Set the cache size, in bytes, that is used to schedule the
+  construction of the wavelet packet tree (see buildTree).  A value of
+  zero (the default) uses the size of the processor's level 2 cache.
+  A value of (size_t)-1 builds the whole tree depth first.
+ */
+void packtree_base::cacheSize( const size_t bytes )
+{
+  cacheBytes = bytes;
+} // cacheSize
+
+
+/**
+  Return the cache size, in bytes, used by buildTree.  If no size has
+  been set, the size of the level 2 cache is returned (if it can be
+  found out from the operating system).
+ */
+size_t packtree_base::cacheSize()
+{
+  if (cacheBytes == 0) {
+    long l2Bytes = 0;
+
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+    l2Bytes = sysconf( _SC_LEVEL2_CACHE_SIZE );
+#endif
+    if (l2Bytes > 0) {
+      cacheBytes = (size_t)l2Bytes;
+    }
+    else {
+      cacheBytes = defaultCacheBytes;
+    }
+  }
+  return cacheBytes;
+} // cacheSize
+
+
+/**
+  Return true if the sub-tree below a node of length <i>len</i> fits
+  in the cache.  Each level of the sub-tree holds len elements, plus
+  the len elements of the node itself.  The number of levels is
+  limited by the minimum node length.
+ */
+bool packtree_base::subtreeFits( const size_t len, const size_t elemSize )
+{
+  size_t levels = 1;
+  for (size_t n = len; n > 1 && (n >> 1) >= minLen; n >>= 1) {
+    levels++;
+  }
+  const size_t bytes = cacheSize();
+  return (len <= bytes / (levels * elemSize));
+} // subtreeFits
+
+
+/**
+  Walk down <i>depth</i> levels of the tree and either split the
+  nodes found at that level (<i>descend</i> is false) or build
+  their sub-trees depth first (<i>descend</i> is true).  The
+  reverse flag is passed down the tree in the same way as it is
+  in newLevel.
+ */
+template <class T>
+void basic_packtree_base<T>::levelWalk( packnode<T>* top, 
+                                       size_t depth,
+                                       bool freqCalc, 
+                                       bool reverse,
+                                       bool descend )
+{
+  if (top != 0) {
+    if (depth == 0) {
+      if (descend) {
+	newLevel( top, freqCalc, reverse );
       }
-      else { // freq == false
-	// use standard filter location
-	newLevel( rhs, freqCalc, false );
+      else {
+	splitNode( top, reverse );
       }
     }
+    else {
+      levelWalk( top->lhsChild(), depth-1, freqCalc, false, descend );
+      levelWalk( top->rhsChild(), depth-1, freqCalc, freqCalc, descend );
+    }
   }
-} // newLevel
+} // levelWalk
+
+
+/**
+
+  Build the wavelet packet tree below <i>top</i>.
+
+  The tree is built with a cache aware schedule.  When the sub-tree
+  below a node is too large to fit in the cache (see cacheSize),
+  calculating it depth first would stream the large upper levels
+  through memory several times.  Instead the upper levels of the tree
+  are calculated breadth first, one level at a time, so that each of
+  these levels is read once and written once.  When the nodes are
+  small enough that their sub-trees fit in the cache, each sub-tree is
+  calculated depth first (newLevel), so all of its levels are
+  calculated while its data is still in the cache.  The memory for
+  each of these sub-trees is allocated contiguously from the memory
+  pool.
+
+  The schedule only changes the order in which the nodes are
+  calculated, not the resulting tree.
+
+ */
+template <class T>
+void basic_packtree_base<T>::buildTree( packnode<T>* top, bool freqCalc )
+{
+  if (top != 0) {
+    PACKPROF_SCOPE( profScope, &this->profStats );
+    PACKPROF_START( start );
+    PACKTRACE_SPAN( buildSpan, "build", top->length() );
+    size_t depth = 0;
+    size_t len = top->length();
+
+    while (len > 1 && (len >> 1) >= minLen && !subtreeFits( len, sizeof( T ) )) {
+      PACKTRACE_SPAN( levelSpan, "level", len );
+      levelWalk( top, depth, freqCalc, false, false );
+      depth++;
+      len >>= 1;
+    }
+    {
+      PACKTRACE_SPAN( subtreeSpan, "subtrees", len );
+      levelWalk( top, depth, freqCalc, false, true );
+    }
+    PACKPROF_STOP( Build, start );
+  }
+} // buildTree
+
+
+
+/**
+  Return the data for the root of the wavelet packet tree.
+
+  If <i>kind</i> is CopyInput the N elements of <i>vec</i> are copied
+  into memory allocated from the memory pool.  If <i>kind</i> is
+  BorrowInput, the caller's buffer is used directly and it must remain
+  valid for as long as the tree is used.  Since each level of the
+  tree is calculated out of place (see newLevel), the tree does not
+  modify the root data.  Zero is returned if the memory for the copy
+  cannot be allocated.
+
+ */
+template <class T>
+T *basic_packtree_base<T>::rootData( const T *vec, 
+                                     const size_t N, 
+                                     inputKind kind )
+{
+  T *data;
+
+  if (kind == BorrowInput) {
+    data = (T *)vec;
+  }
+  else {
+    block_pool mem_pool;
+    data = (T *)mem_pool.pool_alloc( N * sizeof( T ), block_pool::simd_align );
+
+    if (data != 0) {
+      for (size_t i = 0; i < N; i++) {
+        data[i] = vec[i];
+      }
+      PACKPROF_COUNT( Build, 0, N * sizeof( T ), N );
+    }
+  }
+
+  return data;
+} // rootData
 
 
 
@@ -126,13 +371,14 @@ void packtree_base::newLevel( packnode<double>* top,
   and Anderson-Freed, 1993.
 
  */
-void packtree_base::breadthFirstPrint(const printKind kind)
+template <class T>
+void basic_packtree_base<T>::breadthFirstPrint(const printKind kind)
 {
-  queue<double> Q;
+  queue<T> Q;
 
   Q.addQueue( root, 0 );
   while (! Q.queueEmpty() ) {
-    packnode<double> *node = Q.queueStart()->node;
+    packnode<T> *node = Q.queueStart()->node;
     size_t indent = Q.queueStart()->indent;
     Q.deleteStart();
     
@@ -153,8 +399,8 @@ void packtree_base::breadthFirstPrint(const printKind kind)
       break;
     } // switch
     
-    packnode<double> *lhs = node->lhsChild();
-    packnode<double> *rhs = node->rhsChild();
+    packnode<T> *lhs = node->lhsChild();
+    packnode<T> *rhs = node->rhsChild();
 
     if (lhs != 0) {
       Q.addQueue( lhs, indent + 2 );
@@ -163,7 +409,7 @@ void packtree_base::breadthFirstPrint(const printKind kind)
       Q.addQueue( rhs, indent + 2 );
     }
   }
-} // packtree_base::breadthFirstPrint
+} // basic_packtree_base::breadthFirstPrint
 
 
 
@@ -172,9 +418,23 @@ void packtree_base::breadthFirstPrint(const printKind kind)
   Print the wavelet packet tree data and wavelet transform
   result to standard out.
  */
-void packtree_base::pr()
+template <class T>
+void basic_packtree_base<T>::pr()
 {
   if (root != 0) {
     breadthFirstPrint(printData);
   }
 } // pr
+
+
+
+/*
+  The wavelet packet tree is built for the following element types.
+  The template member functions are defined in this file, so the
+  classes are explicitly instantiated here.
+ */
+template class basic_packtree_base<int16_t>;
+template class basic_packtree_base<int32_t>;
+template class basic_packtree_base<int64_t>;
+template class basic_packtree_base<float>;
+template class basic_packtree_base<double>;